@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <stdexcept>
@@ -13,6 +14,8 @@
 #include "utils/graphs/Graph3DIn.hpp"
 #include "utils/Types.hpp"
 #include "utils/Config.hpp"
+#include "utils/Contraction.hpp"
+#include "utils/Reordering.hpp"
 #include "solvers/SolverBIGram.hpp"
 #include "solvers/SolverBITopo.hpp"
 #include "solvers/SolverBWGram.hpp"
@@ -25,6 +28,14 @@
 #include "solvers/SolverBWTopoParallel.hpp"
 #include "solvers/SolverBIGramParallel.hpp"
 #include "solvers/SolverBITopoParallel.hpp"
+#include "solvers/SolverBIGramDistributed.hpp"
+#include "solvers/SolverDyck.hpp"
+#include "solvers/SolverSpGEMM.hpp"
+#include "solvers/SolverBitMatrix.hpp"
+#include "solvers/SolverStream.hpp"
+#include "solvers/SolverBdd.hpp"
+#include "solvers/SolverFWHybrid.hpp"
+#include "solvers/SolverSelector.hpp"
 #include "solvers/SolverBase.hpp"
 
 
@@ -35,16 +46,56 @@ namespace gracfl
      * @brief Main driver class that encapsulates configuration, grammar, and execution of CFL-reachability analysis.
      * 
      * Based on the configuration provided, this class loads the grammar, initializes the appropriate solver
-     * (e.g., FW, BW, BI with gram/topo driven strategy, in serial or parallel mode), and executes the CFL-reachability algorithm.
+     * (e.g., FW, BW, BI with gram/topo driven strategy, in serial, parallel or distributed mode), and executes the CFL-reachability algorithm.
      */
     class Solver 
     {
         /// Solver configuration parameters
         Config& config_;
-        /// Pointer to loaded grammar
-        Grammar* grammar_;
-        /// Pointer to the solver based on the config
-        SolverBase* solver_;
+        /// Loaded grammar
+        std::unique_ptr<Grammar> grammar_;
+        /// Contraction of the input graph, nullptr if the solver runs on the input as is
+        std::unique_ptr<VertexContraction> contraction_;
+        /// Renumbering of the (contracted) input, nullptr if the input ids are kept
+        std::unique_ptr<VertexReordering> reordering_;
+        /// Solver based on the config, released before the inputs it was built from
+        std::unique_ptr<SolverBase> solver_;
+        /// Edge sample of a calibration probe, nullptr outside of probes
+        std::vector<Edge>* probeEdges_ = nullptr;
+
+        /**
+         * @brief Constructs a solver on the probe sample, the reordered or the contracted edges if there are any,
+         *        else on the graph file.
+         * @param args Constructor arguments after the grammar.
+         */
+        template<typename SolverType, typename... Args>
+        SolverBase* makeSolver(Args... args)
+        {
+            if (probeEdges_ != nullptr)
+            {
+                return new SolverType(*probeEdges_, *grammar_, args...);
+            }
+            if (reordering_ != nullptr)
+            {
+                return new SolverType(reordering_->getEdges(), *grammar_, args...);
+            }
+            if (contraction_ != nullptr)
+            {
+                return new SolverType(contraction_->getEdges(), *grammar_, args...);
+            }
+            return new SolverType(config_.graphFilepath, *grammar_, args...);
+        }
+
+        /**
+         * @brief Result of the solver mapped back to the input ids, but not expanded by the contraction.
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> getSolverGraph();
+
+        /**
+         * @brief IDs of the labels listed in outputLabels.
+         * @throws std::runtime_error for a label that is not part of the grammar.
+         */
+        std::vector<uint> outputLabelIds() const;
     public:
         /**
          * @brief Constructs a new Solver with specified configuration.
@@ -60,6 +111,13 @@ namespace gracfl
 
         SolverBase* selectSolver();
 
+        /**
+         * @brief Replaces the "auto" settings of the configuration by the choice of SolverSelector.
+         *
+         * With calibration, the best-ranked candidates are timed on an edge sample and the fastest wins.
+         */
+        void resolveAutoSettings();
+
         /**
          * @brief Executes the CFL-reachability algorithm on the processed graph.
          *
@@ -21,20 +21,32 @@ namespace gracfl
     {
         Grammar& grammar_; ///< Reference to the grammar rules used for CFL parsing.
         Graph3DBi* graph_; ///< Pointer to the bidirectional graph structure.
+        bool asynchronous_; ///< Whether derived edges are joined within the same sweep.
+        bool stratified_; ///< Whether the grammar's strata are solved one after the other.
+        std::vector<uint> outputLabels_; ///< Labels kept for getGraph() when stratified, all if empty.
+        ull derivations_ = 0; ///< Candidate edges checked against the hashset over the whole run.
     public:
         /**
          * @brief Constructor for SolverBIGram.
          * @param graphfilepath Path to the input graph file.
          * @param grammar Reference to the Grammar object.
+         * @param asynchronous Join derived edges within the same sweep (Gauss-Seidel) instead of the next iteration.
+         * @param stratified Solve the strata of the grammar one after the other, see runCFLStratified().
+         * @param outputLabels Labels to keep when stratified, all if empty.
          */
-        SolverBIGram(std::string graphfilepath, Grammar& grammar);
+        SolverBIGram(std::string graphfilepath, Grammar& grammar, bool asynchronous = false,
+                     bool stratified = false, std::vector<uint> outputLabels = {});
 
         /**
          * @brief Constructor for SolverBIGram.
          * @param edges Vector of edges to initialize the graph.
          * @param grammar Reference to the Grammar object.
+         * @param asynchronous Join derived edges within the same sweep (Gauss-Seidel) instead of the next iteration.
+         * @param stratified Solve the strata of the grammar one after the other, see runCFLStratified().
+         * @param outputLabels Labels to keep when stratified, all if empty.
          */
-        SolverBIGram(std::vector<Edge>& edges, Grammar& grammar);
+        SolverBIGram(std::vector<Edge>& edges, Grammar& grammar, bool asynchronous = false,
+                     bool stratified = false, std::vector<uint> outputLabels = {});
 
         /**
          * @brief Destructor.
@@ -46,18 +58,40 @@ namespace gracfl
          */
         void runCFL() override;
 
+        /**
+         * @brief Asynchronous variant of runCFL().
+         *
+         * OLD_END marks the processed prefix of every edge list. A sweep processes each list from
+         * OLD_END to its current end, so edges appended behind the sweep position are handled in the
+         * same sweep. An edge is joined only with the processed prefix of the partner list, hence
+         * every pair of edges is joined exactly once, by whichever of the two is processed last.
+         * The run ends at quiescence, a sweep that finds no unprocessed edge.
+         */
+        void runCFLAsync();
+
+        /**
+         * @brief Stratified variant of runCFL().
+         *
+         * The strata of Grammar::computeStrata() are solved in order, each to its own fixpoint with
+         * only the rules of its nonterminals; at the start of a stratum all edges count as new.
+         * Labels no output label depends on are dropped before solving and their strata skipped.
+         * A label that is not an output label is released once the last stratum reading it is done,
+         * so its memory is reused by later strata. Iterations, derivations, time, released labels,
+         * arena size and peak resident memory are printed per stratum.
+         */
+        void runCFLStratified();
+
         /**
          * @brief Runs a single iteration of the CFL solving process.
          *
          * Applies production rules using both incoming and outgoing edges to perform updates
-         * to the graph via hashsets.
+         * to the graph via hashsets. Every binary rule A = BC is joined once per vertex, see joinAtVertex().
          *
          * @param outEdges Outgoing edge lists.
          * @param inEdges Incoming edge lists.
          * @param hashset Edge presence tracker (label × node → set of neighbors).
          * @param grammar2index Unary production rules.
          * @param grammar3indexLeft Binary productions (left-side association).
-         * @param grammar3indexRight Binary productions (right-side association).
          * @param labelSize Number of total symbols.
          * @param nodeSize Total number of nodes/vertex in the graph.
          * @param terminate Flag indicating whether convergence has been reached.
@@ -65,14 +99,28 @@ namespace gracfl
         void runSingleIteration(
             std::vector<std::vector<TemporalVector>>& outEdges,
             std::vector<std::vector<TemporalVector>>& inEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
-            std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
             uint labelSize,
             uint nodeSize,
             bool& terminate);
 
+        /**
+         * @brief Derives the new A-edges through one vertex for a binary rule A = BC.
+         *
+         * The new pairs are NEW_in × ALL_out ∪ OLD_in × NEW_out. Both products are walked per
+         * in-neighbor, so each probes one source's dedup set with a contiguous slice of the
+         * out-list (a batch). Driving them from the out-side instead would enumerate the same
+         * pairs but scatter the probes over the sets of all in-neighbors.
+         *
+         * @param in In-edges of the vertex labeled B.
+         * @param out Out-edges of the vertex labeled C.
+         * @param A Label of the derived edges.
+         * @param terminate Flag indicating whether convergence has been reached.
+         */
+        void joinAtVertex(TemporalVector& in, TemporalVector& out, uint A, bool& terminate);
+
         /**
          * @brief Adds self-loop epsilon edges to support epsilon productions.
          */
@@ -82,7 +130,7 @@ namespace gracfl
          * @brief Returns the graph's final CFL-reachable edges.
          * @return Graph hashset (node × label → reachable destination node set).
          */
-        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->getHashset(); }
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return toStdHashset(graph_->getHashset()); }
 
         /**
          * @brief Retrieves the total number of CFL-reachable edges in the graph.
@@ -0,0 +1,142 @@
+#pragma once
+
+#ifdef GRACFL_USE_MPI
+
+#include "utils/graphs/Graph.hpp"
+#include "utils/graphs/Graph3DPartition.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Config.hpp"
+#include "utils/Grammar.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverBIGramDistributed
+     * @brief Multi-process grammar-driven solver over vertex partitions (MPI).
+     *
+     * Every rank owns a contiguous vertex range (Graph3DPartition) and evaluates, owner-computes
+     * style, all joins whose middle vertex it owns. A derived edge (u, w, A) is stored by the owner
+     * of u (out-lists) and by the owner of w (in-lists); edges for other ranks are buffered during
+     * the iteration and exchanged at its end in one batched, delta/varint-compressed message per
+     * rank pair, split into rounds that keep every MPI count within an int. Termination is a global
+     * reduction over the per-rank "new edge" flags.
+     *
+     * Run the program under mpirun; MPI is initialized on first use if the caller did not do it.
+     */
+    class SolverBIGramDistributed : public SolverBase
+    {
+        Grammar& grammar_;          ///< Reference to the grammar rules used for CFL parsing.
+        Graph3DPartition* graph_;   ///< Partition of the graph owned by this rank.
+        uint rank_;                 ///< Rank of this process.
+        uint numRanks_;             ///< Number of processes.
+        std::vector<std::vector<Edge>> outBuffers_; ///< Derived edges for remote sources, per destination rank
+        std::vector<std::vector<Edge>> inBuffers_;  ///< Derived edges for remote destinations, per destination rank
+        ull sentEdges_ = 0;         ///< Derived edges shipped to other ranks
+        ull sentBytes_ = 0;         ///< Bytes shipped to other ranks after compression
+        size_t roundBytes_ = size_t(1) << 30; ///< Most bytes a rank sends per collective round (MPI-3 counts are int)
+    public:
+        /**
+         * @brief Constructor for SolverBIGramDistributed.
+         * @param graphfilepath Path to the input graph file (read by every rank).
+         * @param grammar Reference to the Grammar object.
+         */
+        SolverBIGramDistributed(std::string graphfilepath, Grammar& grammar);
+
+        /**
+         * @brief Constructor for SolverBIGramDistributed.
+         * @param edges Vector of edges to initialize the graph (the full edge list on every rank).
+         * @param grammar Reference to the Grammar object.
+         */
+        SolverBIGramDistributed(std::vector<Edge>& edges, Grammar& grammar);
+
+        /**
+         * @brief Destructor.
+         */
+        ~SolverBIGramDistributed();
+
+        /**
+         * @brief Sets the most bytes a rank sends in one round of an exchange or in one message of
+         *        getGraph() (default 1 GiB). Larger transfers are split.
+         * @param roundBytes At least 12 bytes per rank, at most INT_MAX.
+         */
+        void setRoundBytes(size_t roundBytes);
+
+        /**
+         * @brief Executes the distributed CFL solving loop until global convergence.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Runs one local iteration over the owned vertices.
+         *
+         * New in-edges are joined with all out-edges of the owned middle vertex and new out-edges
+         * with the old in-edges. Derived edges are applied locally or buffered for their owners.
+         *
+         * @param outEdges Outgoing edge lists of the owned vertices.
+         * @param inEdges Incoming edge lists of the owned vertices.
+         * @param grammar2index Unary production rules.
+         * @param grammar3indexLeft Binary productions (left-side association).
+         * @param grammar3indexRight Binary productions (right-side association).
+         * @param labelSize Number of total symbols.
+         * @param localNodeSize Number of vertices owned by this rank.
+         * @param terminate Flag indicating whether this rank derived nothing new.
+         */
+        void runSingleIteration(
+            std::vector<std::vector<TemporalVector>>& outEdges,
+            std::vector<std::vector<TemporalVector>>& inEdges,
+            std::vector<std::vector<uint>>& grammar2index,
+            std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
+            std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
+            uint labelSize,
+            uint localNodeSize,
+            bool& terminate);
+
+        /**
+         * @brief Ships the buffered edges to their owners and applies the received ones.
+         * @param terminate Cleared if a received edge was new.
+         */
+        void exchangeEdges(bool& terminate);
+
+        /**
+         * @brief Adds self-loop epsilon edges for the owned vertices.
+         */
+        void addSelfEdges();
+
+        /**
+         * @brief Gathers the CFL-reachable edges of all ranks on rank 0, in messages of bounded size.
+         *
+         * Collective: every rank must call it. Only rank 0 holds the whole closure; use
+         * getLocalGraph() to keep the results split over the ranks.
+         *
+         * @return Graph hashset (node × label → reachable destination node set) on rank 0, empty on the other ranks.
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override;
+
+        /**
+         * @brief Retrieves the CFL-reachable edges whose source this rank owns.
+         * @return Graph hashset (owned node - getBegin() × label → reachable destination node set).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> getLocalGraph();
+
+        /**
+         * @brief Retrieves the global number of CFL-reachable edges.
+         * @return Number of reachable edges summed over all ranks.
+         */
+        ull getEdgeCount() override;
+
+        /// Rank of this process.
+        inline uint getRank() const { return rank_; }
+        /// Number of processes.
+        inline uint getNumRanks() const { return numRanks_; }
+        /// First vertex owned by this rank.
+        inline uint getBegin() const { return graph_->getBegin(); }
+
+    private:
+        /// Routes a derived edge to the owners of its source and destination.
+        void emitEdge(Edge& edge, bool& terminate);
+    };
+}
+
+#endif // GRACFL_USE_MPI
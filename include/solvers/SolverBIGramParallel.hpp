@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <vector>
 #include "utils/graphs/Graph.hpp"
 #include "utils/graphs/Graph3DBiConcurrent.hpp"
 #include "utils/Edges.hpp"
@@ -22,14 +24,20 @@ namespace gracfl
         Grammar& grammar_; ///< Reference to the grammar rules used for CFL parsing.
         Graph3DBiConcurrent* graph_; ///< Pointer to the bidirectional graph structure.
         uint numOfThreads_;
+        bool asynchronous_; ///< Whether derived edges are processed from per-thread work queues.
+        ull derivations_ = 0; ///< Candidate edges checked against the hashset over the whole run.
+        std::vector<std::atomic<bool>> listLocks_; ///< Striped locks serializing appends to an edge list (asynchronous mode)
     public:
         /**
          * @brief Constructor for SolverBIGramParallel.
          * @param graphfilepath Path to the input graph file.
          * @param grammar Reference to the Grammar object.
+         * @param numOfThreads Number of OpenMP threads to use during parallel execution.
+         * @param numaAware Place the graph containers on the NUMA nodes of the threads owning them.
+         * @param asynchronous Process derived edges right away from per-thread work queues instead of in the next iteration.
          */
-        SolverBIGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads);
-        SolverBIGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads);
+        SolverBIGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware = false, bool asynchronous = false);
+        SolverBIGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware = false, bool asynchronous = false);
 
         /**
          * @brief Destructor.
@@ -41,6 +49,35 @@ namespace gracfl
          */
         void runCFL() override;
 
+        /**
+         * @brief Asynchronous variant of runCFL().
+         *
+         * Every edge is processed once from a work queue: it is joined with whatever the partner
+         * lists hold at that moment and each edge it derives is queued on the local queue of the
+         * thread. A thread whose queue runs dry steals half of another thread's queue. Since an edge
+         * is published in its lists before it is queued, of two joinable edges the one processed last
+         * always sees the other. The run ends when no edge is queued or being processed.
+         */
+        void runCFLAsync();
+
+        /**
+         * @brief Processes one edge of the asynchronous mode.
+         * @param edge Edge to join with the current partner lists.
+         * @param derived Receives the edges that were new.
+         * @param derivations Accumulates the candidate edges checked.
+         */
+        void processEdgeAsync(const Edge& edge, std::vector<Edge>& derived, ull& derivations);
+
+        /**
+         * @brief Adds an edge in asynchronous mode and publishes it in both edge lists.
+         *
+         * NEW_END of a list is the number of entries that are fully written and safe to read while
+         * other threads append; it is only advanced under the list's lock.
+         *
+         * @return Whether the edge was new.
+         */
+        bool addEdgeAsync(const Edge& edge);
+
         /**
          * @brief Runs a single iteration of the CFL solving process.
          *
@@ -52,7 +89,6 @@ namespace gracfl
          * @param hashset Edge presence tracker (label × node → set of neighbors).
          * @param grammar2index Unary production rules.
          * @param grammar3indexLeft Binary productions (left-side association).
-         * @param grammar3indexRight Binary productions (right-side association).
          * @param labelSize Number of total symbols.
          * @param nodeSize Total number of nodes/vertex in the graph.
          * @param terminate Flag indicating whether convergence has been reached.
@@ -64,11 +100,28 @@ namespace gracfl
             std::vector<std::vector<tbb::concurrent_unordered_set<ull>>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
-            std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
             uint labelSize,
             uint nodeSize,
             bool& terminate);
 
+        /**
+         * @brief Derives the new A-edges through one vertex for a binary rule A = BC.
+         *
+         * Same pairs as SolverBIGram::joinAtVertex(), each checked with its own edge insertion.
+         *
+         * @param in In-edges of the vertex labeled B.
+         * @param out Out-edges of the vertex labeled C.
+         * @param A Label of the derived edges.
+         * @param terminate Flag indicating whether convergence has been reached.
+         * @param derivations Accumulates the candidate edges checked.
+         */
+        void joinAtVertex(
+            TemporalVectorConcurrent& in,
+            TemporalVectorConcurrent& out,
+            uint A,
+            bool& terminate,
+            ull& derivations);
+
         /**
          * @brief Adds self-loop epsilon edges to support epsilon productions.
          */
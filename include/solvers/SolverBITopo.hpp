@@ -65,7 +65,7 @@ namespace gracfl
         void runSingleIteration(
             std::vector<TemporalVectorWithLbldVtx>& outEdges,
             std::vector<TemporalVectorWithLbldVtx>& inEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<uint>>& grammar3index,
             uint labelSize,
@@ -78,7 +78,7 @@ namespace gracfl
         void addSelfEdges();
 
         
-        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->getHashset(); }
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return toStdHashset(graph_->getHashset()); }
 
         /**
          * @brief Retrieves the total number of CFL-reachable edges in the graph.
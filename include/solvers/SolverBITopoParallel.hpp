@@ -27,9 +27,11 @@ namespace gracfl
          * @brief Constructor for SolverBITopoParallel.
          * @param graphfilepath Path to the input graph file.
          * @param grammar Reference to the Grammar object used for CFL derivations.
+         * @param numOfThreads Number of OpenMP threads to use during parallel execution.
+         * @param numaAware Place the graph containers on the NUMA nodes of the threads owning them.
          */
-        SolverBITopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads);
-        SolverBITopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads);
+        SolverBITopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware = false);
+        SolverBITopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware = false);
 
         /**
          * @brief Destructor.
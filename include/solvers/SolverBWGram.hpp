@@ -6,6 +6,7 @@
 #include "utils/Types.hpp"
 #include "utils/Config.hpp"
 #include "utils/Grammar.hpp"
+#include "utils/Prefetch.hpp"
 #include "solvers/SolverBase.hpp"
 
 namespace gracfl 
@@ -23,10 +24,14 @@ namespace gracfl
     protected:
         Grammar& grammar_;
         Graph3DIn* graph_;
+        uint prefetchDistance_; ///< Neighbors the join loops prefetch ahead, 0 disables.
+        bool labelMajor_;       ///< Sweep one label at a time across all vertices instead of vertex by vertex.
     public:
        
-        SolverBWGram(std::string graphfilepath, Grammar& grammar);
-        SolverBWGram(std::vector<Edge>& edges, Grammar& grammar);
+        SolverBWGram(std::string graphfilepath, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE,
+                     bool labelMajor = false, uint numOfThreads = 1);
+        SolverBWGram(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE,
+                     bool labelMajor = false, uint numOfThreads = 1);
         ~SolverBWGram();
 
         void runCFL() override;
@@ -47,7 +52,7 @@ namespace gracfl
          */
         void runSingleIteration(
             std::vector<std::vector<TemporalVector>>& inEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
             uint labelSize,
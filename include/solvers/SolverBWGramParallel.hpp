@@ -27,9 +27,14 @@ namespace gracfl
          * @param graphfilepath Path to the input graph file.
          * @param grammar Reference to the Grammar object.
          * @param numOfThreads Number of threads to use in parallel execution.
+         * @param numaAware Place the graph containers on the NUMA nodes of the threads owning them.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         * @param labelMajor Sweep one label at a time across all vertices instead of vertex by vertex.
          */
-        SolverBWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads);
-        SolverBWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads);
+        SolverBWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE, bool labelMajor = false);
+        SolverBWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE, bool labelMajor = false);
 
         /**
          * @brief Executes the CFL solver until convergence is achieved.
@@ -52,7 +57,7 @@ namespace gracfl
          */
         void runSingleIterationParallel(
             std::vector<std::vector<TemporalVector>>& inEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+            std::vector<std::vector<FlatHashset>>& inHashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
             uint labelSize,
@@ -6,6 +6,7 @@
 #include "utils/Types.hpp"
 #include "utils/Config.hpp"
 #include "utils/Grammar.hpp"
+#include "utils/Prefetch.hpp"
 #include "solvers/SolverBase.hpp"
 
 namespace gracfl 
@@ -22,14 +23,17 @@ namespace gracfl
     protected:
         Grammar& grammar_;  ///< Reference to the grammar containing CFL production rules.
         Graph2DIn* graph_;  ///< Pointer to the 2D incoming edge graph representation.
+        uint prefetchDistance_; ///< Neighbors the join loops prefetch ahead, 0 disables.
     public:
         /**
          * @brief Constructor for SolverBWTopo.
          * @param graphfilepath Path to the input graph file.
          * @param grammar Reference to the Grammar object for rule processing.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         * @param numOfThreads Threads that build the graph, those of a parallel subclass.
          */
-        SolverBWTopo(std::string graphfilepath, Grammar& grammar);
-        SolverBWTopo(std::vector<Edge>& edges, Grammar& grammar);
+        SolverBWTopo(std::string graphfilepath, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE, uint numOfThreads = 1);
+        SolverBWTopo(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE, uint numOfThreads = 1);
 
         /**
          * @brief Destructor.
@@ -54,7 +58,7 @@ namespace gracfl
          */
         void runSingleIteration(
             std::vector<TemporalVectorWithLbldVtx>& inEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+            std::vector<std::vector<FlatHashset>>& inHashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<uint>>& grammar3index,
             uint labelSize,
@@ -30,9 +30,13 @@ namespace gracfl
          * @param graphfilepath Path to the graph file to be loaded.
          * @param grammar Reference to the Grammar object used in the analysis.
          * @param numOfThreads Number of OpenMP threads to use during parallel execution.
+         * @param numaAware Place the graph containers on the NUMA nodes of the threads owning them.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
          */
-        SolverBWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads);
-        SolverBWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads);
+        SolverBWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE);
+        SolverBWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE);
 
         /**
          * @brief Executes the full CFL reachability algorithm in parallel.
@@ -56,7 +60,7 @@ namespace gracfl
          */
         void runSingleIterationParallel(
             std::vector<TemporalVectorWithLbldVtx>& inEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+            std::vector<std::vector<FlatHashset>>& inHashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<uint>>& grammar3index,
             uint labelSize,
@@ -63,7 +63,7 @@ namespace gracfl
          * @return A 2D vector representing outgoing edges: node × label → {destination nodes}.
          */
         std::vector<std::vector<std::unordered_set<ull>>> convertInHashsetToOutHashset(
-            std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+            std::vector<std::vector<FlatHashset>>& inHashset,
             uint nodeSize
         )
         {
@@ -89,5 +89,29 @@ namespace gracfl
 
             return outHashset;
         }
+
+        /**
+         * @brief Copies an arena-backed hashset into plain unordered_sets.
+         *
+         * The result stays valid after the solver (and with it the graph's arenas) is destroyed.
+         *
+         * @param hashset A 2D vector of arena-backed sets: node × label → {nodes}.
+         * @return The same sets allocated from the global heap.
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> toStdHashset(
+            std::vector<std::vector<FlatHashset>>& hashset
+        )
+        {
+            std::vector<std::vector<std::unordered_set<ull>>> result(hashset.size());
+            for (uint i = 0; i < hashset.size(); i++)
+            {
+                result[i].reserve(hashset[i].size());
+                for (uint j = 0; j < hashset[i].size(); j++)
+                {
+                    result[i].emplace_back(hashset[i][j].begin(), hashset[i][j].end());
+                }
+            }
+            return result;
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "utils/graphs/Graph.hpp"
+#include "utils/graphs/GraphBdd.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Config.hpp"
+#include "utils/Grammar.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverBdd
+     * @brief Symbolic CFL reachability solver that derives whole relations as binary decision diagrams.
+     *
+     * Every label is one BDD over the bits of the source and target vertices (see GraphBdd), so an
+     * iteration never touches single edges: A ::= B is a union of relations and A ::= B C a
+     * relational product that conjoins B(x, z) with C(z, y) and quantifies the middle vertex z in
+     * the same pass. Like the SpGEMM solver it is semi-naive, ΔA = (ΔB ∪ ΔB·C ∪ B_old·ΔC) \ A.
+     *
+     * The cost follows the size of the diagrams rather than the number of edges, which pays off
+     * on closures with much regularity, such as points-to relations where many vertices share
+     * targets. Diagram operations are sequential, so the solver runs on one thread.
+     */
+    class SolverBdd : public SolverBase
+    {
+    public:
+        /**
+         * @brief Constructs a SolverBdd instance from a graph file.
+         *
+         * @param graphfilepath Path to the graph file.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param order Variable order of the vertex bits: "interleaved" or "sequential".
+         */
+        SolverBdd(std::string graphfilepath, Grammar& grammar, std::string order = "interleaved");
+
+        /**
+         * @brief Constructs a SolverBdd instance from edges.
+         *
+         * @param edges Vector of edges to initialize the graph.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param order Variable order of the vertex bits: "interleaved" or "sequential".
+         */
+        SolverBdd(std::vector<Edge>& edges, Grammar& grammar, std::string order = "interleaved");
+
+        /**
+         * @brief Destructor for SolverBdd.
+         */
+        ~SolverBdd();
+
+        /**
+         * @brief Executes the main CFL solving loop until convergence is reached.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Derives the relations of one iteration and makes them the new deltas.
+         * @return Number of edges derived.
+         */
+        ull runSingleIteration();
+
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->toHashset(); }
+
+        /**
+         * @brief Retrieves the total number of CFL-reachable edges in the graph.
+         * @return Number of reachable edges.
+         */
+        ull getEdgeCount() override;
+
+    private:
+        Grammar& grammar_;
+        GraphBdd* graph_;
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "utils/graphs/Graph.hpp"
+#include "utils/graphs/GraphBitMatrix.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Config.hpp"
+#include "utils/Grammar.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverBitMatrix
+     * @brief CFL reachability solver over dense bit matrices, with a Four-Russians product kernel.
+     *
+     * Every label is an n × n bit matrix (see GraphBitMatrix). An iteration computes, for each
+     * production, ΔA = (ΔB ∪ ΔB·C ∪ B·ΔC) \ A over the matrices of the previous iteration.
+     *
+     * The default kernel is the Method of Four Russians: the inner dimension is cut into blocks
+     * of 8, and for each block the ORs of all subsets of the 8 right-hand rows are tabulated, so a
+     * left-hand row adds its whole byte of the block with one row OR. Tiles of TILE_ROWS rows by
+     * TILE_WORDS words keep a table (256 × TILE_WORDS words) in L2 and are spread over the
+     * threads. Only blocks with a bit in some left-hand row of the tile and a non-empty
+     * right-hand row are tabulated. A table saves row ORs only where a row has several bits in
+     * a block, so products whose left-hand rows are sparser than MIN_BITS_PER_BLOCK (typically
+     * those with a small delta) fall back to the naive kernel, which ORs one right-hand row per
+     * set bit. Products whose right-hand rows are mostly zero words (B·ΔC with a small delta)
+     * gain nothing from wide table rows either; they OR only the non-zero words of each selected
+     * row. The naive kernel can also be selected for all products, as a baseline.
+     */
+    class SolverBitMatrix : public SolverBase
+    {
+    public:
+        static constexpr uint BLOCK_BITS = 8;      ///< Inner-dimension bits per lookup table
+        static constexpr uint TILE_ROWS = 2048;    ///< Rows of a tile
+        static constexpr uint TILE_WORDS = 64;     ///< Words (64 columns each) of a tile
+        /// Bits of the left-hand rows per non-empty block below which a product uses the naive kernel.
+        static constexpr uint MIN_BITS_PER_BLOCK = 2;
+        /// Right-hand rows with fewer than 1 / SPARSE_ROW_FRACTION of their words non-zero are ORed word-sparse.
+        static constexpr uint SPARSE_ROW_FRACTION = 8;
+
+        /**
+         * @brief Constructs a SolverBitMatrix instance from a graph file.
+         *
+         * @param graphfilepath Path to the graph file.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads computing tiles, 1 for serial mode.
+         * @param fourRussians Use the Four-Russians kernel, else the naive row-OR kernel.
+         */
+        SolverBitMatrix(std::string graphfilepath, Grammar& grammar, uint numOfThreads = 1, bool fourRussians = true);
+
+        /**
+         * @brief Constructs a SolverBitMatrix instance from edges.
+         *
+         * @param edges Vector of edges to initialize the graph.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads computing tiles, 1 for serial mode.
+         * @param fourRussians Use the Four-Russians kernel, else the naive row-OR kernel.
+         */
+        SolverBitMatrix(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads = 1, bool fourRussians = true);
+
+        /**
+         * @brief Destructor for SolverBitMatrix.
+         */
+        ~SolverBitMatrix();
+
+        /**
+         * @brief Executes the main CFL solving loop until convergence is reached.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Derives the edges of one iteration and makes them the new deltas.
+         * @return Number of edges derived.
+         */
+        ull runSingleIteration();
+
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->toHashset(); }
+
+        /**
+         * @brief Retrieves the total number of CFL-reachable edges in the graph.
+         * @return Number of reachable edges.
+         */
+        ull getEdgeCount() override;
+
+    private:
+        Grammar& grammar_;
+        GraphBitMatrix* graph_;
+        uint numOfThreads_;
+        bool fourRussians_;
+        std::vector<uint> derived_;                                ///< Labels with productions
+        std::vector<std::vector<uint>> unary_;                     ///< B of A ::= B, per A
+        std::vector<std::vector<std::pair<uint, uint>>> binary_;   ///< (B, C) of A ::= B C, per A
+        std::vector<BitMatrix> next_;                              ///< Edges derived in this iteration, per label
+        std::vector<std::vector<uint64_t>> tables_;                ///< Four-Russians table per thread
+
+        void indexRules();
+
+        /**
+         * @brief ORs the product X·Y into P.
+         */
+        void multiply(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P);
+        void multiplyFourRussians(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P);
+        void multiplyNaive(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P);
+        void multiplySparseRows(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P);
+    };
+}
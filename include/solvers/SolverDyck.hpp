@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "utils/graphs/Graph.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Grammar.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverDyck
+     * @brief Dedicated solver for Dyck-shaped grammars (see Grammar::detectDyck()).
+     *
+     * Instead of joining edge lists rule by rule, the solver derives the relation of the start
+     * symbol S over classes of vertices kept in a union-find.
+     * - Bidirected graphs (every o-edge u->v comes with the c-edge v->u of the same kind and vice
+     *   versa): S is an equivalence up to reflexivity. Two o-predecessors of the same class are
+     *   S-related, so the classes are found by merging the o-predecessors of every class per kind,
+     *   smaller lists into larger ones, in near-linear time.
+     * - Other graphs: a worklist over S facts applies S ::= o S c and S ::= S S. Vertices that become
+     *   mutually S-reachable are collapsed into one class on the fly (SCC contraction), so the facts
+     *   of a cycle are derived once per class instead of once per vertex.
+     *
+     * getGraph() expands the classes back into the per-label closure of the generic solvers.
+     *
+     * Every kind of an indexed family (see Grammar) is split into one instance per index that occurs
+     * on an edge. The adjacency stores the instance next to each edge, so the solver's memory grows
+     * with the edges and not with the number of indices.
+     */
+    class SolverDyck : public SolverBase
+    {
+        Grammar& grammar_; ///< Reference to the (Dyck-shaped) grammar.
+        Graph* graph_; ///< Input edges, the solver keeps its own adjacency.
+        uint nodeSize_; ///< Number of vertices.
+        std::vector<int> openKind_; ///< Kind of every opening label, -1 for other labels.
+        std::vector<int> closeKind_; ///< Kind of every closing label, -1 for other labels.
+        std::vector<uint> kindOf_; ///< Kind of every instance, instance k < number of kinds is kind k.
+        std::vector<uint> indexOf_; ///< Index of every instance, 0 for kinds that are not indexed.
+        std::unordered_map<ull, uint> instances_; ///< (kind, index) -> instance, for indexed kinds.
+        std::vector<std::vector<std::pair<uint, uint>>> openIn_; ///< Per vertex v: (instance, u) for every o-edge u->v.
+        std::vector<std::vector<std::pair<uint, uint>>> closeOut_; ///< Per vertex v: (instance, w) for every c-edge v->w.
+        std::vector<bool> hasOpenOut_; ///< Whether the vertex has an outgoing o-edge.
+        bool nonterminalInput_ = false; ///< Whether the input already carries S- or helper-labeled edges.
+        ull initialEdges_ = 0; ///< Number of distinct input edges.
+
+        std::vector<uint> parent_; ///< Union-find parent of every vertex.
+        std::vector<uint> classSize_; ///< Number of vertices of every class, valid for representatives.
+        std::vector<std::unordered_set<uint>> sOut_; ///< Classes T with S(class, T), keyed by representative.
+        std::vector<std::unordered_set<uint>> sIn_; ///< Classes T with S(T, class), keyed by representative.
+        std::vector<std::vector<uint>> members_; ///< Vertices of every class after solving.
+        bool solved_ = false;
+        bool bidirected_ = false; ///< Whether the union-find algorithm for bidirected graphs was used.
+        ull merges_ = 0; ///< Number of class merges.
+        ull derivations_ = 0; ///< Candidate S facts checked.
+
+    public:
+        /**
+         * @brief Constructor for SolverDyck.
+         * @param graphfilepath Path to the input graph file.
+         * @param grammar Reference to a Dyck-shaped Grammar object.
+         * @throws std::runtime_error if the grammar is not Dyck-shaped.
+         */
+        SolverDyck(std::string graphfilepath, Grammar& grammar);
+
+        /**
+         * @brief Constructor for SolverDyck.
+         * @param edges Vector of edges to initialize the graph.
+         * @param grammar Reference to a Dyck-shaped Grammar object.
+         * @throws std::runtime_error if the grammar is not Dyck-shaped.
+         */
+        SolverDyck(std::vector<Edge>& edges, Grammar& grammar);
+
+        /**
+         * @brief Destructor.
+         */
+        ~SolverDyck();
+
+        /**
+         * @brief Computes the S relation, with the bidirected algorithm when it applies.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Checks whether o- and c-edges of every kind mirror each other.
+         * @return True if every o-edge u->v has the c-edge v->u of the same kind and vice versa.
+         */
+        bool isBidirected();
+
+        /**
+         * @brief Union-find algorithm for bidirected graphs.
+         */
+        void runBidirected();
+
+        /**
+         * @brief Worklist algorithm for arbitrary graphs with online collapsing of S-cycles.
+         */
+        void runGeneral();
+
+        /**
+         * @brief Returns the graph's final CFL-reachable edges.
+         * @return Graph hashset (node × label → reachable destination node set).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override;
+
+        /**
+         * @brief Retrieves the total number of CFL-reachable edges in the graph.
+         *
+         * Edges of indexed labels are counted once per index, while getGraph() reports them
+         * without their index.
+         *
+         * @return Number of reachable edges, counted per class without expanding the closure.
+         */
+        ull getEdgeCount() override;
+
+    private:
+        void init();
+        uint instance(uint kind, uint index);
+        int findInstance(uint kind, uint index) const;
+        uint find(uint v);
+        uint unite(uint a, uint b);
+        void finalize();
+        std::unordered_set<uint> helperEnds(uint rep, uint k);
+    };
+}
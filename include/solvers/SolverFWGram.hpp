@@ -6,6 +6,8 @@
 #include "utils/Types.hpp"
 #include "utils/Config.hpp"
 #include "utils/Grammar.hpp"
+#include "utils/Prefetch.hpp"
+#include "utils/Contraction.hpp"
 #include "solvers/SolverBase.hpp"
 
 namespace gracfl 
@@ -22,6 +24,25 @@ namespace gracfl
     protected:
         Grammar& grammar_;  ///< Reference to the grammar defining CFL rules.
         Graph3DOut* graph_; ///< Pointer to the graph structure supporting forward traversal.
+        uint prefetchDistance_; ///< Neighbors the join loops prefetch ahead, 0 disables.
+        bool labelMajor_;       ///< Sweep one label at a time across all vertices instead of vertex by vertex.
+        CycleCollapsing* cycles_ = nullptr; ///< Online cycle collapsing, nullptr if disabled.
+
+        /**
+         * @brief Merges the vertices that the last delta put on a cycle of a transitive label.
+         *
+         * Scans the delta of every transitive label for edges (u, v) whose reverse is known,
+         * unites their classes and moves the rows of the absorbed representatives, before the
+         * iteration joins anything.
+         *
+         * @param numThreads Number of OpenMP threads scanning the deltas.
+         */
+        void collapseCycles(uint numThreads);
+
+        /**
+         * @brief Starts online cycle collapsing if the grammar has a contractible transitive label.
+         */
+        void initCycleCollapsing();
     public:
         /**
          * @brief Constructs a SolverFWGram instance.
@@ -30,16 +51,26 @@ namespace gracfl
          * 
          * @param graphfilepath Path to the graph file.
          * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         * @param cycleCollapsing Merge the vertices of cycles of transitive labels while solving.
+         * @param labelMajor Sweep one label at a time across all vertices instead of vertex by vertex.
+         * @param numOfThreads Threads that build the graph, those of a parallel subclass.
          */
-        SolverFWGram(std::string graphfilepath, Grammar& grammar);
+        SolverFWGram(std::string graphfilepath, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE,
+                     bool cycleCollapsing = false, bool labelMajor = false, uint numOfThreads = 1);
 
         /**
          * @brief Constructs a SolverFWGram instance from edges.
          * 
          * @param edges Vector of edges to initialize the graph.
          * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         * @param cycleCollapsing Merge the vertices of cycles of transitive labels while solving.
+         * @param labelMajor Sweep one label at a time across all vertices instead of vertex by vertex.
+         * @param numOfThreads Threads that build the graph, those of a parallel subclass.
          */
-        SolverFWGram(std::vector<Edge>& edges, Grammar& grammar);
+        SolverFWGram(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE,
+                     bool cycleCollapsing = false, bool labelMajor = false, uint numOfThreads = 1);
 
         /**
          * @brief Destructor for SolverFWGram.
@@ -68,7 +99,7 @@ namespace gracfl
          */
         void runSingleIteration(
             std::vector<std::vector<TemporalVector>>& outEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
             uint labelSize,
@@ -80,7 +111,7 @@ namespace gracfl
          */
         void addSelfEdges();
 
-        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->getHashset(); }
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override;
 
         /**
          * @brief Retrieves the total number of CFL-reachable edges in the graph.
@@ -29,9 +29,17 @@ namespace gracfl
          * @param graphfilepath Path to the graph file to be loaded.
          * @param grammar Reference to the Grammar object used in the analysis.
          * @param numOfThreads Number of OpenMP threads to use during parallel execution.
+         * @param numaAware Place the graph containers on the NUMA nodes of the threads owning them.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         * @param cycleCollapsing Merge the vertices of cycles of transitive labels while solving.
+         * @param labelMajor Sweep one label at a time across all vertices instead of vertex by vertex.
          */
-        SolverFWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads);
-        SolverFWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads);
+        SolverFWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE, bool cycleCollapsing = false,
+                             bool labelMajor = false);
+        SolverFWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE, bool cycleCollapsing = false,
+                             bool labelMajor = false);
 
         /**
          * @brief Executes the full parallel forward-directional CFL-reachability analysis.
@@ -54,7 +62,7 @@ namespace gracfl
          */
         void runSingleIterationParallel(
             std::vector<std::vector<TemporalVector>>& outEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
             uint labelSize,
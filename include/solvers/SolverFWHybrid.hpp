@@ -0,0 +1,107 @@
+#pragma once
+
+#include "utils/graphs/Graph.hpp"
+#include "utils/graphs/GraphHybridOut.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Config.hpp"
+#include "utils/Grammar.hpp"
+#include "utils/Prefetch.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverFWHybrid
+     * @brief Forward solver that picks gram-driven or topo-driven processing anew for every iteration.
+     *
+     * The graph keeps the out-edges both label-partitioned and as labelled-vertex lists (see
+     * GraphHybridOut), so an iteration can run either sweep of the forward solvers. Before each
+     * iteration a cost model estimates both from the number of delta and total edges per label:
+     * the gram-driven sweep visits every (vertex, label) row and opens the C-row of a neighbor
+     * once per rule B C, scanning only matching edges; the topo-driven sweep visits every vertex
+     * once and opens each neighbor's list once for all rules, but scans the edges of every label
+     * there. The cheaper one runs, so a run can start topo-driven while many labels are new at
+     * every vertex and turn gram-driven once the deltas thin out.
+     *
+     * New edges are staged per thread and committed at the end of the iteration, in serial mode
+     * as well, and the vertices are split across the threads (owner computes).
+     */
+    class SolverFWHybrid : public SolverBase
+    {
+    public:
+        /**
+         * @brief Constructs a SolverFWHybrid instance from a graph file.
+         *
+         * @param graphfilepath Path to the graph file.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads, 1 for serial mode.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         */
+        SolverFWHybrid(std::string graphfilepath, Grammar& grammar, uint numOfThreads = 1,
+                       uint prefetchDistance = prefetch::DEFAULT_DISTANCE);
+
+        /**
+         * @brief Constructs a SolverFWHybrid instance from edges.
+         *
+         * @param edges Vector of edges to initialize the graph.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads, 1 for serial mode.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         */
+        SolverFWHybrid(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads = 1,
+                       uint prefetchDistance = prefetch::DEFAULT_DISTANCE);
+
+        /**
+         * @brief Destructor for SolverFWHybrid.
+         */
+        ~SolverFWHybrid();
+
+        /**
+         * @brief Executes the main CFL solving loop until convergence is reached.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Derives the edges of one iteration and makes them the new deltas.
+         * @param topoDriven Run the topo-driven sweep instead of the gram-driven one.
+         * @return Number of edges derived.
+         */
+        ull runSingleIteration(bool topoDriven);
+
+        /**
+         * @brief Whether the cost model expects the topo-driven sweep to be cheaper for the current deltas.
+         */
+        bool preferTopoDriven() const;
+
+        /**
+         * @brief Strategy of every iteration run so far, true where it was topo-driven.
+         */
+        inline const std::vector<bool>& getSchedule() const { return schedule_; }
+
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return toStdHashset(graph_->getHashset()); }
+
+        /**
+         * @brief Retrieves the total number of CFL-reachable edges in the graph.
+         * @return Number of reachable edges.
+         */
+        ull getEdgeCount() override;
+
+    private:
+        Grammar& grammar_;
+        GraphHybridOut* graph_;
+        uint numOfThreads_;
+        uint prefetchDistance_;     ///< Neighbors the join loops prefetch ahead, 0 disables.
+        std::vector<ull> delta_;    ///< Delta edges per label
+        std::vector<ull> total_;    ///< All edges per label
+        std::vector<bool> schedule_;
+
+        void addSelfEdges();
+
+        /// Stages the edges of one gram-driven sweep, returns their number.
+        ull runGramDriven();
+
+        /// Stages the edges of one topo-driven sweep, returns their number.
+        ull runTopoDriven();
+    };
+}
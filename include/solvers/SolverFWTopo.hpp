@@ -6,6 +6,7 @@
 #include "utils/Types.hpp"
 #include "utils/Config.hpp"
 #include "utils/Grammar.hpp"
+#include "utils/Prefetch.hpp"
 #include "solvers/SolverBase.hpp"
 
 namespace gracfl 
@@ -22,14 +23,17 @@ namespace gracfl
     protected:
         Grammar& grammar_;  ///< Reference to the grammar used for parsing and derivation.
         Graph2DOut* graph_; ///< Pointer to the forward 2D graph structure.
+        uint prefetchDistance_; ///< Neighbors the join loops prefetch ahead, 0 disables.
     public:
         /**
          * @brief Constructor for SolverFWTopo.
          * @param graphfilepath Path to the input graph file.
          * @param grammar Reference to the Grammar object used for CFL derivations.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
+         * @param numOfThreads Threads that build the graph, those of a parallel subclass.
          */
-        SolverFWTopo(std::string graphfilepath, Grammar& grammar);
-        SolverFWTopo(std::vector<Edge>& edges, Grammar& grammar);
+        SolverFWTopo(std::string graphfilepath, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE, uint numOfThreads = 1);
+        SolverFWTopo(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance = prefetch::DEFAULT_DISTANCE, uint numOfThreads = 1);
         /**
          * @brief Destructor.
          */
@@ -56,7 +60,7 @@ namespace gracfl
          */
         void runSingleIteration(
             std::vector<TemporalVectorWithLbldVtx>& outEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<uint>>& grammar3index,
             uint labelSize,
@@ -69,7 +73,7 @@ namespace gracfl
          */
         void addSelfEdges();
 
-        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->getHashset(); }
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return toStdHashset(graph_->getHashset()); }
 
         /**
          * @brief Retrieves the total number of CFL-reachable edges in the graph.
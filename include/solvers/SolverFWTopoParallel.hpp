@@ -30,9 +30,13 @@ namespace gracfl
          * @param graphfilepath Path to the graph file to be loaded.
          * @param grammar Reference to the Grammar object used in the analysis.
          * @param numOfThreads Number of OpenMP threads to use during parallel execution.
+         * @param numaAware Place the graph containers on the NUMA nodes of the threads owning them.
+         * @param prefetchDistance Neighbors the join loops prefetch ahead, 0 disables.
          */
-        SolverFWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads);
-        SolverFWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads);
+        SolverFWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE);
+        SolverFWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware = false,
+                             uint prefetchDistance = prefetch::DEFAULT_DISTANCE);
 
         /**
          * @brief Executes the full parallel forward-directional CFL-reachability analysis.
@@ -55,7 +59,7 @@ namespace gracfl
          */
         void runSingleIterationParallel(
             std::vector<TemporalVectorWithLbldVtx>& outEdges,
-            std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+            std::vector<std::vector<FlatHashset>>& hashset,
             std::vector<std::vector<uint>>& grammar2index,
             std::vector<std::vector<uint>>& grammar3index,
             uint labelSize,
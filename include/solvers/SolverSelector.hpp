@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "utils/Edges.hpp"
+#include "utils/Grammar.hpp"
+#include "utils/Config.hpp"
+#include "utils/Types.hpp"
+
+namespace gracfl
+{
+    /**
+     * @brief One solver configuration with its estimated cost.
+     */
+    struct SolverChoice
+    {
+        std::string executionMode;       ///< "serial" or "parallel"
+        std::string traversalDirection;  ///< "fw", "bw" or "bi"
+        std::string processingStrategy;  ///< "gram-driven" or "topo-driven"
+        double cost = 0;                 ///< Estimated cost, comparable between choices of one graph only
+        std::vector<std::string> reasons{}; ///< Terms of the cost model that decided the choice
+    };
+
+    /**
+     * @class SolverSelector
+     * @brief Cost model for picking executionMode, traversalDirection and processingStrategy.
+     *
+     * The statistics are cheap, one pass over the edges: node and edge counts, the label
+     * histogram, degree skew, the joins of the first iteration (sum over vertices and rules
+     * A = BC of in_B(v) * out_C(v)) and the shape of the grammar. The model charges
+     * - the joins, times a locality factor: bi joins the in- and out-lists of one vertex, while
+     *   fw and bw fetch the lists of every neighbor;
+     * - the scan overhead: gram-driven visits every (vertex, label) slot per iteration, topo-driven
+     *   every edge with a rule lookup;
+     * - parallel execution: concurrent containers, divided by the threads the edges can keep busy.
+     */
+    class SolverSelector
+    {
+    public:
+        /**
+         * @brief Computes the statistics.
+         * @param edges Input edges.
+         * @param grammar Grammar the graph is solved for.
+         * @param numThreads Threads available to parallel solvers.
+         */
+        SolverSelector(const std::vector<Edge>& edges, const Grammar& grammar, uint numThreads);
+
+        /**
+         * @brief Ranks the configurations that agree with the non-"auto" settings of config.
+         *
+         * An "auto" direction is chosen from fw and bi only: the bw solvers do not agree with
+         * them on every input, so they run only when asked for.
+         * @param config Configuration whose "auto" settings are to be chosen.
+         * @return Candidates, cheapest first.
+         */
+        std::vector<SolverChoice> rank(const Config& config) const;
+
+        /**
+         * @brief Takes the edges between the vertices of a prefix of the vertex ids.
+         * @param maxEdges Upper bound on the number of edges.
+         * @return Induced subgraph on the first vertices, for probe runs.
+         */
+        std::vector<Edge> sample(ull maxEdges) const;
+
+        /**
+         * @brief Prints the statistics the model is based on.
+         */
+        void printStats() const;
+
+    private:
+        const std::vector<Edge>& edges_;
+        const Grammar& grammar_;
+        uint numThreads_;
+        uint nodeSize_ = 0;
+        std::vector<ull> labelHistogram_;  ///< Edges per label
+        ull usedSlots_ = 0;                ///< (vertex, label) pairs with at least one out-edge
+        uint maxOutDegree_ = 0;
+        uint maxInDegree_ = 0;
+        ull joins_ = 0;                    ///< Pairs joined by binary rules in the first iteration
+        double rulesPerLabel_ = 0;         ///< Average rules triggered by an edge
+    };
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "utils/graphs/Graph.hpp"
+#include "utils/graphs/GraphCSR.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Config.hpp"
+#include "utils/Grammar.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverSpGEMM
+     * @brief CFL reachability solver that evaluates the productions as masked sparse matrix products.
+     *
+     * Every label is a sparse boolean matrix (see GraphCSR). An iteration derives, for each
+     * production, ΔA = (ΔB ∪ ΔB·C ∪ B_old·ΔC) \ A, the unary term for A ::= B and the products
+     * for A ::= B C, where C includes its own delta. The products are computed row by row with
+     * Gustavson's algorithm, rows in parallel, and the complement of A is the output mask, so
+     * only new edges are ever materialized.
+     *
+     * The candidates of a row are gathered first. Rows with few candidates are compressed by
+     * sorting them and looking them up in the mask row (a sparse accumulator); larger rows mark
+     * the mask row and the candidates in a dense array of vertex stamps (a dense accumulator).
+     * No per-edge hash set is kept, so the memory is that of the CSR arrays.
+     *
+     * With shared sets the old rows are hash-consed in a SetPool (see GraphCSR) and the joins
+     * work per distinct set: in ΔB·C_old a set of C reached through several middle vertices is
+     * expanded once per row, and B_old·ΔC, which only depends on the set of the row of B, is
+     * computed once per distinct set and iteration and reused by every row holding that set.
+     */
+    class SolverSpGEMM : public SolverBase
+    {
+    public:
+        /// Rows with at most this many candidates use the sparse accumulator.
+        static constexpr size_t SPARSE_ROW_LIMIT = 256;
+        /// Rows handed to a thread at a time.
+        static constexpr uint ROW_CHUNK = 64;
+
+        /**
+         * @brief Constructs a SolverSpGEMM instance from a graph file.
+         *
+         * @param graphfilepath Path to the graph file.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads computing rows, 1 for serial mode.
+         * @param sharedSets Hash-cons the old rows into shared sets and join per distinct set.
+         */
+        SolverSpGEMM(std::string graphfilepath, Grammar& grammar, uint numOfThreads = 1, bool sharedSets = false);
+
+        /**
+         * @brief Constructs a SolverSpGEMM instance from edges.
+         *
+         * @param edges Vector of edges to initialize the graph.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads computing rows, 1 for serial mode.
+         * @param sharedSets Hash-cons the old rows into shared sets and join per distinct set.
+         */
+        SolverSpGEMM(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads = 1, bool sharedSets = false);
+
+        /**
+         * @brief Destructor for SolverSpGEMM.
+         */
+        ~SolverSpGEMM();
+
+        /**
+         * @brief Executes the main CFL solving loop until convergence is reached.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Derives the edges of one iteration and makes them the new deltas.
+         * @return Number of edges derived.
+         */
+        ull runSingleIteration();
+
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->toHashset(); }
+
+        /**
+         * @brief Retrieves the total number of CFL-reachable edges in the graph.
+         * @return Number of reachable edges.
+         */
+        ull getEdgeCount() override;
+
+    private:
+        /// New entries of one row of one label, in Workspace::entries.
+        struct Run
+        {
+            uint label;
+            uint row;
+            size_t offset;
+            size_t count;
+        };
+
+        /// Accumulators and output buffer of one thread.
+        struct alignas(64) Workspace
+        {
+            std::vector<uint> candidates;  ///< Expanded products of the current row
+            std::vector<uint> stamp;       ///< Dense accumulator, stamp per vertex
+            uint current = 0;              ///< Stamp of the current row
+            std::vector<uint> setStamp;    ///< Stamp per pool set, sets of C already expanded in the row
+            uint currentSet = 0;
+            std::vector<Run> runs;
+            std::vector<uint> entries;
+        };
+
+        /// B_old·ΔC of one pair (B, C), per distinct set of the old rows of B.
+        struct Product
+        {
+            uint B;
+            uint C;
+            std::vector<uint> index;               ///< Position in ids per pool ID, NONE if not used by B
+            std::vector<uint> ids;                 ///< Distinct sets of the old rows of B
+            std::vector<std::vector<uint>> sets;   ///< Sorted product of each distinct set, by position
+        };
+
+        static constexpr uint NONE = 0xFFFFFFFFu;
+
+        Grammar& grammar_;
+        GraphCSR* graph_;
+        uint numOfThreads_;
+        std::vector<uint> derived_;                                ///< Labels with productions
+        std::vector<std::vector<uint>> unary_;                     ///< B of A ::= B, per A
+        std::vector<std::vector<std::pair<uint, uint>>> binary_;   ///< (B, C) of A ::= B C, per A
+        std::vector<Workspace> workspaces_;
+        std::vector<Product> products_;                            ///< Shared sets only
+        std::vector<std::vector<uint>> productOf_;                 ///< Product of each rule in binary_, per A
+
+        void indexRules();
+
+        /**
+         * @brief Computes B_old·ΔC per distinct set for every pair of the shared-sets mode.
+         */
+        void prepareProducts();
+
+        /**
+         * @brief Computes the new entries of row i of label A into the workspace.
+         */
+        void multiplyRow(uint i, uint A, Workspace& ws);
+    };
+}
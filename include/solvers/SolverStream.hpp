@@ -0,0 +1,98 @@
+#pragma once
+
+#include "utils/graphs/Graph.hpp"
+#include "utils/graphs/GraphStream.hpp"
+#include "utils/Edges.hpp"
+#include "utils/Types.hpp"
+#include "utils/Config.hpp"
+#include "utils/Grammar.hpp"
+#include "solvers/SolverBase.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class SolverStream
+     * @brief Edge-centric CFL reachability solver that joins sorted edge streams instead of probing vertex lists.
+     *
+     * Every label is a pair of sorted edge arrays (see GraphStream). An iteration derives, for each
+     * production, ΔA = (ΔB ∪ ΔB·C ∪ B_old·ΔC) \ A like the SpGEMM solver, but evaluates a product
+     * B·C as a merge join of B by target with C by source on the middle vertex, one vertex
+     * partition at a time in parallel. Derived edges are appended to per-thread shuffle buffers,
+     * one per (label, source partition), so no vertex list is probed. At the end of
+     * the iteration each buffer is gathered, sorted and deduplicated in bulk and masked by a merge
+     * scan against the known edges of its partition, which yields the new delta already in order.
+     *
+     * All accesses are sequential scans, apart from binary searches that skip the gaps of a join,
+     * trading the random accesses of the vertex-centric solvers for bandwidth, which pays off on
+     * graphs much larger than the caches.
+     */
+    class SolverStream : public SolverBase
+    {
+    public:
+        /**
+         * @brief Constructs a SolverStream instance from a graph file.
+         *
+         * @param graphfilepath Path to the graph file.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads joining partitions, 1 for serial mode.
+         */
+        SolverStream(std::string graphfilepath, Grammar& grammar, uint numOfThreads = 1);
+
+        /**
+         * @brief Constructs a SolverStream instance from edges.
+         *
+         * @param edges Vector of edges to initialize the graph.
+         * @param grammar Reference to the Grammar object for rule-based traversal.
+         * @param numOfThreads Number of OpenMP threads joining partitions, 1 for serial mode.
+         */
+        SolverStream(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads = 1);
+
+        /**
+         * @brief Destructor for SolverStream.
+         */
+        ~SolverStream();
+
+        /**
+         * @brief Executes the main CFL solving loop until convergence is reached.
+         */
+        void runCFL() override;
+
+        /**
+         * @brief Derives the edges of one iteration and makes them the new deltas.
+         * @return Number of edges derived.
+         */
+        ull runSingleIteration();
+
+        std::vector<std::vector<std::unordered_set<ull>>> getGraph() override { return graph_->toHashset(); }
+
+        /**
+         * @brief Retrieves the total number of CFL-reachable edges in the graph.
+         * @return Number of reachable edges.
+         */
+        ull getEdgeCount() override;
+
+    private:
+        /// A stream of one iteration: left by target joined with right by source, or left copied if right is null.
+        struct Join
+        {
+            uint slot;                       ///< Index of the head label in derived_
+            const std::vector<ull>* left;
+            const std::vector<ull>* right;
+        };
+
+        Grammar& grammar_;
+        GraphStream* graph_;
+        uint numOfThreads_;
+        std::vector<uint> derived_;                                ///< Labels with productions
+        std::vector<std::vector<uint>> unary_;                     ///< B of A ::= B, per A
+        std::vector<std::vector<std::pair<uint, uint>>> binary_;   ///< (B, C) of A ::= B C, per A
+        std::vector<std::vector<std::vector<ull>>> shuffle_;       ///< Per thread, buffer per (slot, source partition)
+
+        void indexRules();
+
+        /**
+         * @brief Streams partition p of a join into the shuffle buffers of the calling thread.
+         */
+        void streamPartition(const Join& join, uint p, std::vector<std::vector<ull>>& shuffle);
+    };
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <unordered_set>
+#include <vector>
+#include "Types.hpp"
+
+namespace gracfl {
+    /// How the arenas obtain their chunks from the system.
+    enum class HugePages
+    {
+        Off,          ///< Regular heap memory
+        Transparent,  ///< 2 MiB aligned mappings advised for transparent huge pages (madvise)
+        Explicit      ///< Mappings from the reserved huge page pool (MAP_HUGETLB), else as Transparent
+    };
+
+    /**
+     * @brief Arena memory in huge page backed mappings, from /proc/self/smaps.
+     *
+     * Only the mappings the arenas advised (transparent) or took from the pool (explicit) count;
+     * resident bytes are the touched part of them. Both are 0 where smaps is unavailable.
+     */
+    struct HugePageUsage
+    {
+        size_t residentBytes = 0;  ///< Touched bytes of the huge page mappings
+        size_t hugeBytes = 0;      ///< Part of residentBytes backed by huge pages
+    };
+    HugePageUsage getHugePageUsage();
+
+    /**
+     * @class Arena
+     * @brief Single-threaded bump allocator with power-of-two size classes.
+     *
+     * Blocks are carved from large chunks and rounded up to a power of two (at least 16 bytes),
+     * so internal fragmentation is bounded by 2x. Freed blocks are pushed onto the free list of
+     * their size class and handed out again before the bump pointer advances; this is what
+     * recycles the old buffer when a vertex list grows. Memory is only returned to the system
+     * when the arena is released, one free() per chunk.
+     *
+     * With huge pages (setHugePages) chunks are 2 MiB aligned mappings of whole huge pages, so
+     * the random accesses of the solvers into the vertex lists and dedup sets need a TLB entry
+     * per 2 MiB instead of per 4 KiB.
+     */
+    class Arena
+    {
+    public:
+        static constexpr size_t MIN_BLOCK = 16;            ///< Smallest block handed out
+        static constexpr size_t CHUNK_SIZE = 1 << 20;      ///< Default chunk size (1 MiB)
+        static constexpr uint NUM_CLASSES = 48;            ///< Number of power-of-two size classes
+        static constexpr size_t HUGE_PAGE = 1 << 21;       ///< Huge page size (2 MiB)
+        static constexpr size_t HUGE_CHUNK_SIZE = 2 * HUGE_PAGE;  ///< Chunk size with huge pages
+
+        /**
+         * @brief Sets how chunks are obtained from now on, for every arena of the process.
+         */
+        static void setHugePages(HugePages mode);
+        static HugePages getHugePages();
+
+        Arena() = default;
+        ~Arena();
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Allocates a block of at least bytes bytes, aligned to MIN_BLOCK.
+         */
+        void* allocate(size_t bytes);
+
+        /**
+         * @brief Returns a block of bytes bytes to the free list of its size class.
+         */
+        void deallocate(void* p, size_t bytes);
+
+        /**
+         * @brief Frees all chunks at once. Every block handed out becomes invalid.
+         */
+        void release();
+
+        /// Bytes obtained from the system.
+        inline size_t getReservedBytes() const { return reserved_; }
+        /// Number of chunks obtained from the system.
+        inline size_t getChunkCount() const { return chunks_.size(); }
+
+        /// Spin lock, only contended when more threads than arenas allocate concurrently.
+        std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+
+    private:
+        struct Chunk
+        {
+            void* p;
+            size_t bytes;
+            bool mapped;  ///< Obtained by mmap rather than the heap
+        };
+
+        std::vector<Chunk> chunks_;            ///< Chunks obtained from the system
+        char* cur_ = nullptr;                  ///< Bump pointer into the last chunk
+        char* end_ = nullptr;                  ///< End of the last chunk
+        void* freeLists_[NUM_CLASSES] = {};    ///< Intrusive free list heads per size class
+        size_t reserved_ = 0;                  ///< Bytes obtained from the system
+
+        void* newChunk(size_t bytes);
+        void* mapChunk(size_t bytes, bool explicitPages);
+    };
+
+    /**
+     * @class ArenaPool
+     * @brief One Arena per OpenMP thread, owned by a graph.
+     *
+     * An allocation is served by the arena of the calling OpenMP thread, so threads that only grow
+     * the containers of their own vertices never contend. All arenas are torn down together.
+     */
+    class ArenaPool
+    {
+    public:
+        /**
+         * @brief Creates one arena per thread of the default OpenMP team.
+         */
+        ArenaPool();
+        ~ArenaPool();
+        ArenaPool(const ArenaPool&) = delete;
+        ArenaPool& operator=(const ArenaPool&) = delete;
+
+        void* allocate(size_t bytes);
+        void deallocate(void* p, size_t bytes);
+
+        /**
+         * @brief Stops recycling freed blocks, turning deallocation into a no-op.
+         *
+         * Called before the containers are destroyed in bulk, right before release().
+         */
+        inline void beginTeardown() { teardown_ = true; }
+
+        /**
+         * @brief Frees the memory of all arenas and re-enables recycling.
+         */
+        void release();
+
+        /// Bytes obtained from the system by all arenas.
+        size_t getReservedBytes() const;
+
+    private:
+        struct alignas(64) Slot { Arena arena; };  ///< Cache-line aligned arena
+        std::vector<Slot*> slots_;                 ///< One arena per thread
+        bool teardown_ = false;                    ///< Whether deallocation is a no-op
+
+        Arena& local();
+    };
+
+    /**
+     * @brief STL allocator drawing from an ArenaPool.
+     *
+     * A default-constructed allocator (no pool) falls back to the global heap, so the containers
+     * keep working outside a graph. The pool propagates on copy, move and swap.
+     */
+    template <typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        ArenaAllocator() noexcept = default;
+        explicit ArenaAllocator(ArenaPool* pool) noexcept : pool_(pool) {}
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : pool_(other.getPool()) {}
+
+        T* allocate(size_t n)
+        {
+            if (pool_ == nullptr)
+            {
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+            }
+            return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+            if (pool_ == nullptr)
+            {
+                ::operator delete(p);
+                return;
+            }
+            pool_->deallocate(p, n * sizeof(T));
+        }
+
+        inline ArenaPool* getPool() const noexcept { return pool_; }
+
+    private:
+        ArenaPool* pool_ = nullptr;
+    };
+
+    template <typename T, typename U>
+    inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.getPool() == b.getPool(); }
+    template <typename T, typename U>
+    inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.getPool() != b.getPool(); }
+
+    /// Vertex list whose buffer lives in an arena.
+    template <typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Types.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class BddManager
+     * @brief Reduced ordered binary decision diagrams over a fixed number of variable levels.
+     *
+     * Nodes are indices into a node table, FALSE and TRUE are the terminals and level 0 is the
+     * top of the order; callers map their variables to levels, which is how the order is chosen.
+     * Nodes are hash-consed in a unique table, so equal functions are the same node, and the
+     * results of recent operations are kept in a direct-mapped cache.
+     *
+     * Nodes are not reference counted. The table grows when it runs full, and collect() frees
+     * every node not reachable from the roots it is given (mark and sweep). Node indices that are
+     * not roots, and the operation cache, are invalid after a collection, so collect only between
+     * operations.
+     */
+    class BddManager
+    {
+    public:
+        using Node = uint;
+
+        static constexpr Node FALSE = 0;
+        static constexpr Node TRUE = 1;
+
+        /**
+         * @brief Creates a manager for numLevels variables.
+         * @param initialNodes Initial capacity of the node table, rounded up to a power of two.
+         */
+        BddManager(uint numLevels, uint initialNodes = 1u << 16);
+
+        inline uint numLevels() const { return numLevels_; }
+        /// Level of a node, numLevels() for the terminals.
+        inline uint level(Node f) const { return nodes_[f].level; }
+        inline Node low(Node f) const { return nodes_[f].low; }
+        inline Node high(Node f) const { return nodes_[f].high; }
+
+        /**
+         * @brief The function that is true where the variable at level is (positive literal).
+         */
+        Node literal(uint level, bool positive = true);
+
+        /**
+         * @brief The node (level, low, high), reduced and shared.
+         */
+        Node mk(uint level, Node low, Node high);
+
+        Node conjoin(Node a, Node b);
+        Node disjoin(Node a, Node b);
+        /// a and not b
+        Node subtract(Node a, Node b);
+        Node ite(Node f, Node g, Node h);
+
+        /**
+         * @brief Conjunction of the positive literals of levels, for quantification.
+         */
+        Node cube(std::vector<uint> levels);
+
+        /**
+         * @brief ∃ levels of cube. a ∧ b, without building a ∧ b first.
+         */
+        Node relprod(Node a, Node b, Node cube);
+
+        /**
+         * @brief Registers a renaming of levels, map[level] is the new level of level.
+         * @return ID to pass to replace().
+         */
+        uint addRenaming(const std::vector<uint>& map);
+
+        /**
+         * @brief Renames the variables of f with a renaming from addRenaming().
+         */
+        Node replace(Node f, uint renaming);
+
+        /**
+         * @brief Number of satisfying assignments of f over all levels.
+         */
+        double satCount(Node f);
+
+        /**
+         * @brief Calls visit once per path to TRUE with the value per level: 0, 1, or -1 if free.
+         */
+        void forEachPath(Node f, const std::function<void(const std::vector<int8_t>&)>& visit);
+
+        /**
+         * @brief Frees the nodes not reachable from roots and clears the operation cache.
+         */
+        void collect(const std::vector<Node>& roots);
+
+        /// Nodes in use, terminals included.
+        inline uint liveNodes() const { return live_; }
+        /// Capacity of the node table.
+        inline uint capacity() const { return nodes_.size(); }
+
+    private:
+        struct BddNode
+        {
+            uint level;
+            Node low;
+            Node high;
+            Node next;   ///< Next node of the same unique-table bucket, or of the free list
+        };
+
+        struct CacheEntry
+        {
+            uint op;
+            Node a;
+            Node b;
+            Node c;
+            Node result;
+        };
+
+        enum Op : uint { OP_NONE, OP_AND, OP_OR, OP_DIFF, OP_ITE, OP_RELPROD, OP_REPLACE };
+
+        static constexpr Node NIL = 0xFFFFFFFFu;
+        static constexpr uint DEAD = 0xFFFFFFFFu;   ///< Level of a free node
+
+        uint numLevels_;
+        std::vector<BddNode> nodes_;
+        std::vector<Node> buckets_;
+        Node free_ = NIL;
+        uint live_ = 0;
+        std::vector<CacheEntry> cache_;
+        std::vector<std::vector<uint>> renamings_;
+
+        inline ull hashOf(uint level, Node low, Node high) const
+        {
+            return (ull(level) * 12582917ull + ull(low) * 4256249ull + ull(high) * 741457ull) & (buckets_.size() - 1);
+        }
+        inline CacheEntry& cacheSlot(uint op, Node a, Node b, Node c)
+        {
+            ull hash = (ull(op) * 2654435761ull) ^ (ull(a) * 40503ull) ^ (ull(b) * 2246822519ull) ^ (ull(c) * 3266489917ull);
+            return cache_[(hash ^ (hash >> 29)) & (cache_.size() - 1)];
+        }
+
+        Node apply(uint op, Node a, Node b);
+        void grow();
+        void rehash();
+    };
+}
@@ -15,14 +15,46 @@ namespace gracfl
         std::string graphFilepath;
         /// Path to the context-free grammar file (required).
         std::string grammarFilepath;
-        /// Direction of traversal: "fw", "bw", or "bi".
+        /// Direction of traversal: "fw", "bw", "bi" or "auto" (chosen by SolverSelector).
         std::string traversalDirection;
-        /// Execution mode: "serial" or "parallel".
+        /// Execution mode: "serial", "parallel", "distributed" (MPI, one process per rank) or "auto" (serial or parallel).
         std::string executionMode;
-        /// Derivation strategy: "gram-driven" or "topo-driven".
+        /// Derivation strategy: "gram-driven", "topo-driven", "spgemm", "bitmatrix", "stream", "bdd", "hybrid" or "auto".
         std::string processingStrategy;
         /// Number of threads for "parallel" mode.
         unsigned   numThreads;
+        /// Place graph containers on the NUMA nodes of the threads owning them ("parallel" mode).
+        bool numaAware = false;
+        /// Make derived edges eligible within the same sweep instead of the next iteration ("bi", "gram-driven").
+        bool asynchronous = false;
+        /// Dedicated Dyck-reachability solver: "auto" (used for Dyck-shaped grammars), "on" or "off".
+        std::string dyckSolver = "auto";
+        /// Contract cycles of transitive (A ::= A A) labels before solving and expand the result.
+        bool sccContraction = false;
+        /// Merge the vertices of cycles of transitive labels as the solver derives them ("fw", "gram-driven").
+        bool cycleCollapsing = false;
+        /// Merge interchangeable vertices (offline variable substitution) before solving and expand the result.
+        bool nodeMerging = false;
+        /// Renumber the vertices before solving: "none", "degree", "rcm" or "community".
+        std::string vertexOrder = "none";
+        /// Resolve "auto" settings by timing probe runs of the best-ranked candidates instead of the cost model alone.
+        bool calibration = false;
+        /// Neighbors the fw/bw join loops prefetch ahead (list headers and data), 0 disables.
+        unsigned prefetchDistance = 8;
+        /// Sweep order of the fw/bw gram-driven join loops: "vertex" (vertex by vertex) or "label" (label by label).
+        std::string sweepOrder = "vertex";
+        /// Back the vertex lists and dedup sets with 2 MiB pages: "off", "transparent" or "explicit".
+        std::string hugePages = "off";
+        /// Solve the grammar's nonterminal strata one after the other, releasing labels no later stratum reads ("serial", "bi", "gram-driven").
+        bool stratified = false;
+        /// Comma-separated labels to compute and keep when stratified, empty for all labels.
+        std::string outputLabels;
+        /// Product kernel of processingStrategy = bitmatrix: "four-russians" or "naive".
+        std::string bitKernel = "four-russians";
+        /// Hash-cons identical neighbor sets and join once per distinct set (processingStrategy = spgemm).
+        bool sharedSets = false;
+        /// Variable order of the vertex bits with processingStrategy = bdd: "interleaved" or "sequential".
+        std::string bddOrder = "interleaved";
 
         Config() = default;
         Config(const std::string& filename);
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "Edges.hpp"
+#include "Grammar.hpp"
+#include "Types.hpp"
+
+namespace gracfl
+{
+    /**
+     * @class VertexContraction
+     * @brief Merges input vertices into classes, so a solver runs on the smaller graph, and maps
+     *        the result back.
+     *
+     * Subclasses pick the classes. A class may only be formed if every nonterminal relation is
+     * uniform over it, X(u, w) = X(v, w) and X(w, u) = X(w, v) for all members u, v; then the
+     * closure of the contracted graph, expanded class by class, is the closure of the input.
+     * Terminal relations are never derived and are taken from the input as is.
+     *
+     * Classes are numbered in the order of their largest member, so the class of the largest
+     * vertex gets the largest id and the contracted graph keeps one vertex per class.
+     *
+     * A class may instead keep a second member, its witness, as a vertex of its own (ids after
+     * the classes). The class vertex then stands for the diagonal pairs (u, u) of the class and
+     * the pair (class, witness) for the pairs (u, v), u != v, as needed when an epsilon self-loop
+     * does not extend to the whole class.
+     */
+    class VertexContraction
+    {
+    public:
+        /**
+         * @brief Keeps a copy of the input; every vertex starts in a class of its own.
+         * @param edges Input edges.
+         * @param grammar Grammar the graph is solved for.
+         */
+        VertexContraction(const std::vector<Edge>& edges, const Grammar& grammar);
+
+        virtual ~VertexContraction() = default;
+
+        /**
+         * @brief Get the contracted edges, for the edge-vector constructors of the solvers.
+         * @return Edges over class ids, without duplicates.
+         */
+        inline std::vector<Edge>& getEdges() { return contractedEdges_; }
+
+        /**
+         * @brief Get the number of distinct input edges.
+         * @return Edge count of the input before any derivation.
+         */
+        inline ull getInputEdgeCount() const { return inputEdgeCount_; }
+
+        /**
+         * @brief Get the class of every input vertex.
+         * @return Class id per vertex.
+         */
+        inline const std::vector<uint>& getClassMap() const { return classOf_; }
+
+        /**
+         * @brief Expands the result of a solver run on getEdges() to the input vertices.
+         * @param graph Contracted closure (class × label → classes).
+         * @return Closure of the input graph (node × label → nodes).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> expand(
+            const std::vector<std::vector<std::unordered_set<ull>>>& graph) const;
+
+        /**
+         * @brief Counts the edges of expand(graph) without building it.
+         * @param graph Contracted closure (class × label → classes).
+         * @return Number of edges of the input closure.
+         */
+        ull expandEdgeCount(const std::vector<std::vector<std::unordered_set<ull>>>& graph) const;
+
+        /**
+         * @brief Prints how many vertices and edges the contraction removed.
+         */
+        void printStats() const;
+
+    protected:
+        /**
+         * @brief Builds the classes and the contracted edges.
+         * @param rep Representative of every input vertex, vertices with the same one are merged.
+         * @param witnesses Keep the second member of every class with more than one member as a witness.
+         */
+        void contract(const std::vector<uint>& rep, bool witnesses = false);
+
+        /// Name of the contraction for printStats().
+        virtual std::string name() const = 0;
+
+        const Grammar& grammar_;                  ///< Grammar the graph is solved for
+        std::vector<Edge> edges_;                 ///< Input edges
+        uint nodeSize_ = 0;                       ///< Number of input vertices
+        std::vector<bool> isNonterminal_;         ///< Whether a label is the LHS of some rule
+        std::vector<uint> classOf_;               ///< Class of every input vertex
+        std::vector<std::vector<uint>> members_;  ///< Input vertices of every class
+        std::vector<int> witness_;                ///< Contracted id of the witness of every class, -1 if none
+        std::vector<int> witnessOf_;              ///< Class of every witness, indexed by id minus the class count
+        std::vector<Edge> contractedEdges_;       ///< Edges over classes
+        ull inputEdgeCount_ = 0;                  ///< Distinct input edges
+    };
+
+    /**
+     * @class SCCContraction
+     * @brief Contracts strongly connected components over the edges of transitive labels.
+     *
+     * For a label A with A ::= A A, the vertices of a cycle of A-edges are pairwise A-related.
+     * Edges labeled B whose only use in the grammar is A ::= B count as A-edges. A component is
+     * contracted only if
+     * - every input edge touching it is such an A-edge, so any derivation through a member can
+     *   be rerouted to another member by an A-edge between the two, and
+     * - every nullable label Y other than A has Y ::= Y A or Y ::= A Y, so the epsilon self-loops
+     *   of the members extend to the whole component.
+     * Both conditions make the contraction exact.
+     */
+    class SCCContraction : public VertexContraction
+    {
+    public:
+        /**
+         * @brief Finds the contractible components and contracts them.
+         * @param edges Input edges.
+         * @param grammar Grammar the graph is solved for.
+         */
+        SCCContraction(const std::vector<Edge>& edges, const Grammar& grammar);
+
+    protected:
+        std::string name() const override { return "SCC contraction"; }
+    };
+
+    /**
+     * @class EquivalenceMerging
+     * @brief Merges structurally equivalent vertices (offline variable substitution).
+     *
+     * Vertices are value-numbered by a hash of their labeled predecessors and successors; vertices
+     * with the same number and identical neighbor lists are interchangeable, so every relation
+     * between them and the rest of the graph is the same and one solve covers all of them. Unlike
+     * pointer equivalence, which only compares predecessors, both directions are compared because
+     * all relations are exported, not only the points-to sets. If the grammar has nullable labels,
+     * a merged class keeps a witness (see VertexContraction) for its pairs of distinct members.
+     * Vertices without edges are left alone.
+     */
+    class EquivalenceMerging : public VertexContraction
+    {
+    public:
+        /**
+         * @brief Finds the classes of equivalent vertices and merges them.
+         * @param edges Input edges.
+         * @param grammar Grammar the graph is solved for.
+         */
+        EquivalenceMerging(const std::vector<Edge>& edges, const Grammar& grammar);
+
+    protected:
+        std::string name() const override { return "Equivalence merging"; }
+    };
+
+    /**
+     * @class CycleCollapsing
+     * @brief Merges the vertices of cycles of transitive labels while a solver runs (online cycle detection).
+     *
+     * Eligibility follows SCCContraction: a vertex is eligible for a contractible transitive label
+     * A if all its input edges are A-edges, and the vertices of a cycle of A-edges between
+     * eligible vertices are merged. Unlike the static contraction it also sees the cycles that
+     * are only closed by derived edges. Detection is lazy: the solver checks every new A-edge
+     * (u, v) between eligible vertices, and if (v, u) is known as well, A is transitive so the
+     * two are on a cycle and their classes are united in a union-find. The solver then moves the
+     * rows of the absorbed representative to the surviving one and reads rows through rep().
+     *
+     * Representatives are kept flat, rep() is one lookup. The nonterminal relations of all
+     * members of a class are equal, so the closure over the representatives expands class by
+     * class; terminal relations are taken from the input as is.
+     */
+    class CycleCollapsing
+    {
+    public:
+        /**
+         * @brief Finds the eligible vertices; every vertex starts in a class of its own.
+         * @param edges Input edges.
+         * @param grammar Grammar the graph is solved for.
+         * @param nodeSize Number of vertices of the solver's graph.
+         */
+        CycleCollapsing(const std::vector<Edge>& edges, const Grammar& grammar, uint nodeSize);
+
+        /// Whether the grammar has a contractible transitive label.
+        inline bool active() const { return !transitive_.empty(); }
+
+        /// Contractible transitive labels.
+        inline const std::vector<uint>& transitiveLabels() const { return transitive_; }
+
+        /// Representative of every vertex.
+        inline const std::vector<uint>& representatives() const { return rep_; }
+
+        inline uint rep(uint v) const { return rep_[v]; }
+
+        /// Whether v, and with it its class, is eligible for the transitive label A.
+        inline bool eligible(uint v, uint A) const { return incident_[v] == (int)A; }
+
+        /**
+         * @brief Unites the classes of the representatives r and s.
+         * @return The representative that is absorbed, its rows move to the other one.
+         */
+        uint unite(uint r, uint s);
+
+        /// Vertices merged into another one so far.
+        inline uint merged() const { return merged_; }
+
+        /**
+         * @brief Expands a closure over the representatives to all vertices.
+         * @param graph Closure (node × label → nodes), the rows of absorbed vertices are ignored.
+         * @return Closure of the input graph (node × label → nodes).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> expand(
+            const std::vector<std::vector<std::unordered_set<ull>>>& graph) const;
+
+        /**
+         * @brief Counts the edges of the expanded closure without building it.
+         * @param hashset Closure (node × label → set of nodes), the rows of absorbed vertices are ignored.
+         */
+        template <typename Sets>
+        ull expandEdgeCount(const std::vector<std::vector<Sets>>& hashset) const
+        {
+            // distinct target classes of every row, weighted by the sizes of both classes
+            ull count = terminalEdgeCount_;
+            std::vector<uint> stamp(rep_.size(), 0);
+            uint row = 0;
+            for (uint r = 0; r < hashset.size(); r++)
+            {
+                if (rep_[r] != r) continue;
+                ull size = members_[r].size();
+                for (uint l = 0; l < hashset[r].size(); l++)
+                {
+                    if (!isNonterminal_[l]) continue;
+                    row++;
+                    for (ull d : hashset[r][l])
+                    {
+                        uint c = rep_[d];
+                        if (stamp[c] == row) continue;
+                        stamp[c] = row;
+                        count += size * members_[c].size();
+                    }
+                }
+            }
+            return count;
+        }
+
+        /**
+         * @brief Prints how many vertices were merged.
+         */
+        void printStats() const;
+
+    private:
+        std::vector<uint> transitive_;             ///< Contractible transitive labels
+        std::vector<int> incident_;                ///< Family of the input edges of every vertex
+        std::vector<bool> isNonterminal_;          ///< Whether a label is the LHS of some rule
+        std::vector<uint> rep_;                    ///< Representative of every vertex
+        std::vector<std::vector<uint>> members_;   ///< Members of every class, by representative
+        std::vector<Edge> terminalEdges_;          ///< Input edges of terminal labels
+        ull terminalEdgeCount_ = 0;                ///< Distinct terminal input edges
+        uint merged_ = 0;
+    };
+}
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Types.hpp"
+#include "Arena.hpp"
 #include "tbb/concurrent_vector.h"
 
 namespace gracfl {
@@ -22,21 +23,25 @@ namespace gracfl {
   
   /**
    * @brief TemporalVector struct for edge storage with NEW/OLD sliding pointers.
+   *
+   * The vertex list is allocated from the arena of the owning graph (heap if none is given).
    */
   struct TemporalVector
   {
     uint OLD_END = 0;
     uint NEW_END = 0;
-    std::vector<uint> vertexList;
+    ArenaVector<uint> vertexList;
     TemporalVector() {}
+    explicit TemporalVector(ArenaPool* arena) : vertexList(ArenaAllocator<uint>(arena)) {}
   };
 
   struct TemporalVectorWithLbldVtx
   {
     uint OLD_END = 0;
     uint NEW_END = 0;
-    std::vector<LbldVtx> vertexList;
+    ArenaVector<LbldVtx> vertexList;
     TemporalVectorWithLbldVtx() {}
+    explicit TemporalVectorWithLbldVtx(ArenaPool* arena) : vertexList(ArenaAllocator<LbldVtx>(arena)) {}
   };
 
   struct TemporalVectorConcurrent
@@ -64,18 +69,22 @@ namespace gracfl {
 
   /**
    * @brief Represents a directed edge with source, destination and grammar label.
+   *
+   * Edges of an indexed family (see Grammar) carry their index, so a family costs one label.
    */
   struct Edge
   {
     uint from;
     uint to;
     uint label;
+    uint index = 0;
     Edge() {}
-    Edge(uint from, uint to, uint label)
+    Edge(uint from, uint to, uint label, uint index = 0)
     {
       this->from = from;
       this->to = to;
       this->label = label;
+      this->index = index;
     }
   };
 }
\ No newline at end of file
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "Arena.hpp"
+#include "Types.hpp"
+
+namespace gracfl {
+    /**
+     * @class FlatHashset
+     * @brief Open-addressing set of vertex ids whose buckets are groups of 8 slots probed with SIMD.
+     *
+     * A key hashes to a group; one group is tested against a key with a single 256-bit compare
+     * (AVX2) or two 128-bit compares (SSE2), plain loops elsewhere. Groups are probed linearly and
+     * filled front to back, and keys are never erased, so a group with an empty slot ends the probe
+     * sequence. Compared with node-based sets, a probe touches one cache line instead of a bucket
+     * chain and empty sets allocate nothing. Slots come from the graph's arena.
+     *
+     * Only ids below EMPTY can be stored; the interface is the subset of std::unordered_set the
+     * graphs use, plus insertBatch() for a run of candidates that share a source and label.
+     */
+    class FlatHashset
+    {
+    public:
+        static constexpr uint EMPTY = 0xFFFFFFFFu;  ///< Marker of a free slot
+        static constexpr uint GROUP = 8;            ///< Slots per group, one SIMD compare
+        static constexpr uint BATCH_AHEAD = 8;      ///< Candidates insertBatch() prefetches the group of ahead
+
+        using value_type = uint;
+
+        /**
+         * @brief Forward iterator over the occupied slots.
+         */
+        class const_iterator
+        {
+        public:
+            const_iterator(const uint* p, const uint* end) : p_(p), end_(end) { skip(); }
+            inline const uint& operator*() const { return *p_; }
+            inline const_iterator& operator++() { ++p_; skip(); return *this; }
+            inline bool operator==(const const_iterator& other) const { return p_ == other.p_; }
+            inline bool operator!=(const const_iterator& other) const { return p_ != other.p_; }
+        private:
+            const uint* p_;
+            const uint* end_;
+            inline void skip() { while (p_ != end_ && *p_ == EMPTY) ++p_; }
+        };
+        using iterator = const_iterator;
+
+        FlatHashset() = default;
+        explicit FlatHashset(const ArenaAllocator<ull>& alloc) : alloc_(alloc) {}
+
+        FlatHashset(const FlatHashset& other) : alloc_(other.alloc_)
+        {
+            copyFrom(other);
+        }
+
+        FlatHashset(FlatHashset&& other) noexcept
+        : alloc_(other.alloc_), slots_(other.slots_), groups_(other.groups_), shift_(other.shift_), size_(other.size_)
+        {
+            other.slots_ = nullptr;
+            other.groups_ = 0;
+            other.size_ = 0;
+        }
+
+        FlatHashset& operator=(const FlatHashset& other)
+        {
+            if (this != &other)
+            {
+                release();
+                alloc_ = other.alloc_;
+                copyFrom(other);
+            }
+            return *this;
+        }
+
+        FlatHashset& operator=(FlatHashset&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                alloc_ = other.alloc_;
+                slots_ = other.slots_;
+                groups_ = other.groups_;
+                shift_ = other.shift_;
+                size_ = other.size_;
+                other.slots_ = nullptr;
+                other.groups_ = 0;
+                other.size_ = 0;
+            }
+            return *this;
+        }
+
+        ~FlatHashset() { release(); }
+
+        inline size_t size() const { return size_; }
+        inline bool empty() const { return size_ == 0; }
+        inline const_iterator begin() const { return const_iterator(slots_, slots_ + groups_ * GROUP); }
+        inline const_iterator end() const { return const_iterator(slots_ + groups_ * GROUP, slots_ + groups_ * GROUP); }
+
+        /**
+         * @brief Finds a key.
+         * @return Iterator to the key, end() if absent.
+         */
+        const_iterator find(ull key) const
+        {
+            if (size_ == 0) return end();
+            const uint k = static_cast<uint>(key);
+            for (size_t g = home(k); ; g = (g + 1) & (groups_ - 1))
+            {
+                const uint* group = slots_ + g * GROUP;
+                uint hit = match(group, k);
+                if (hit) return const_iterator(group + lowestBit(hit), slots_ + groups_ * GROUP);
+                if (match(group, EMPTY)) return end();
+            }
+        }
+
+        inline size_t count(ull key) const { return find(key) != end() ? 1 : 0; }
+
+        /**
+         * @brief Inserts a key.
+         * @return Iterator to the key and whether it was inserted.
+         */
+        std::pair<const_iterator, bool> insert(ull key)
+        {
+            reserve(size_ + 1);
+            uint* slot;
+            bool inserted = place(static_cast<uint>(key), slot);
+            return {const_iterator(slot, slots_ + groups_ * GROUP), inserted};
+        }
+
+        /**
+         * @brief Inserts a run of keys.
+         *
+         * The table only grows when a key that is absent would cross the load limit, so a run of
+         * mostly known candidates does not size it for keys it never stores. The home group of the
+         * candidate BATCH_AHEAD positions later is prefetched while the current one is placed, so
+         * the random group accesses of a run overlap.
+         * @param keys Candidates, may contain duplicates.
+         * @param count Number of candidates.
+         * @param inserted Receives the keys that were absent, in candidate order.
+         * @return Number of keys inserted.
+         */
+        size_t insertBatch(const uint* keys, size_t count, uint* inserted)
+        {
+            // an empty table stores the first candidate anyway, and home() needs a group
+            if (count != 0 && groups_ == 0) reserve(1);
+            size_t n = 0;
+            uint* slot;
+            for (size_t i = 0; i < count; i++)
+            {
+                if (i + BATCH_AHEAD < count) __builtin_prefetch(slots_ + home(keys[i + BATCH_AHEAD]) * GROUP, 1, 3);
+                if ((size_ + 1) * 4 > groups_ * GROUP * 3)
+                {
+                    // full up to the load limit: only a new key makes it grow
+                    if (find(keys[i]) != end()) continue;
+                    reserve(size_ + 1);
+                }
+                if (place(keys[i], slot)) inserted[n++] = keys[i];
+            }
+            return n;
+        }
+
+        /**
+         * @brief Grows the table so that n keys fit without rehashing.
+         */
+        void reserve(size_t n)
+        {
+            // load factor at most 3/4
+            if (n * 4 <= groups_ * GROUP * 3) return;
+            size_t groups = groups_ ? groups_ : 1;
+            while (n * 4 > groups * GROUP * 3) groups *= 2;
+            rehash(groups);
+        }
+
+        /**
+         * @brief Removes all keys, keeping the table.
+         */
+        void clear()
+        {
+            if (slots_) std::memset(slots_, 0xFF, groups_ * GROUP * sizeof(uint));
+            size_ = 0;
+        }
+
+    private:
+        ArenaAllocator<uint> alloc_;
+        uint* slots_ = nullptr;  ///< groups_ * GROUP slots, EMPTY if free
+        size_t groups_ = 0;      ///< Number of groups, a power of two
+        uint shift_ = 64;        ///< 64 - log2(groups_)
+        size_t size_ = 0;
+
+        /// Fibonacci hashing onto the groups.
+        inline size_t home(uint key) const
+        {
+            return groups_ == 1 ? 0 : (static_cast<ull>(key) * 0x9E3779B97F4A7C15ull) >> shift_;
+        }
+
+        /// Bit i is set if slot i of the group holds key.
+        static inline uint match(const uint* group, uint key)
+        {
+#if defined(__AVX2__)
+            __m256i slots = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(group));
+            __m256i eq = _mm256_cmpeq_epi32(slots, _mm256_set1_epi32(static_cast<int>(key)));
+            return static_cast<uint>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+#elif defined(__SSE2__)
+            __m128i k = _mm_set1_epi32(static_cast<int>(key));
+            __m128i lo = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group)), k);
+            __m128i hi = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group + 4)), k);
+            return static_cast<uint>(_mm_movemask_ps(_mm_castsi128_ps(lo)) |
+                                     (_mm_movemask_ps(_mm_castsi128_ps(hi)) << 4));
+#else
+            uint mask = 0;
+            for (uint i = 0; i < GROUP; i++)
+            {
+                mask |= static_cast<uint>(group[i] == key) << i;
+            }
+            return mask;
+#endif
+        }
+
+        static inline uint lowestBit(uint mask) { return static_cast<uint>(__builtin_ctz(mask)); }
+
+        /// Inserts key if absent, the table must have room. slot is set to the slot of the key.
+        inline bool place(uint key, uint*& slot)
+        {
+            for (size_t g = home(key); ; g = (g + 1) & (groups_ - 1))
+            {
+                uint* group = slots_ + g * GROUP;
+                uint hit = match(group, key);
+                if (hit)
+                {
+                    slot = group + lowestBit(hit);
+                    return false;
+                }
+                uint free = match(group, EMPTY);
+                if (free)
+                {
+                    slot = group + lowestBit(free);
+                    *slot = key;
+                    size_++;
+                    return true;
+                }
+            }
+        }
+
+        void rehash(size_t groups)
+        {
+            uint* old = slots_;
+            size_t oldGroups = groups_;
+            slots_ = alloc_.allocate(groups * GROUP);
+            std::memset(slots_, 0xFF, groups * GROUP * sizeof(uint));
+            groups_ = groups;
+            shift_ = 64 - static_cast<uint>(__builtin_ctzll(groups));
+            size_ = 0;
+            uint* slot;
+            for (size_t i = 0; i < oldGroups * GROUP; i++)
+            {
+                if (old[i] != EMPTY) place(old[i], slot);
+            }
+            if (old) alloc_.deallocate(old, oldGroups * GROUP);
+        }
+
+        void copyFrom(const FlatHashset& other)
+        {
+            if (other.groups_ == 0) return;
+            slots_ = alloc_.allocate(other.groups_ * GROUP);
+            std::memcpy(slots_, other.slots_, other.groups_ * GROUP * sizeof(uint));
+            groups_ = other.groups_;
+            shift_ = other.shift_;
+            size_ = other.size_;
+        }
+
+        void release()
+        {
+            if (slots_) alloc_.deallocate(slots_, groups_ * GROUP);
+            slots_ = nullptr;
+            groups_ = 0;
+            shift_ = 64;
+            size_ = 0;
+        }
+    };
+}
@@ -9,6 +9,21 @@
 
 namespace gracfl 
 {
+	/**
+     * @brief One parenthesis kind of a Dyck-shaped grammar.
+     *
+     * The kind contributes S ::= o T with T ::= S c, or S ::= T c with T ::= o S, and/or S ::= o c.
+     */
+	struct DyckKind
+	{
+		uint open;                     ///< Label of the opening parenthesis
+		uint close;                    ///< Label of the closing parenthesis
+		int helper = -1;               ///< Nonterminal T of the kind, -1 if there is only S ::= o c
+		bool helperHoldsOpen = false;  ///< Whether T ::= o S (else T ::= S c)
+		bool direct = false;           ///< Whether S ::= o c is part of the grammar
+		bool indexed = false;          ///< Whether o, c (and T) are indexed families, matched by index
+	};
+
 	/**
      * @class Grammar
      * @brief Loads a normalized context-free grammar and provides quick lookup for
@@ -19,6 +34,16 @@ namespace gracfl
      * - grammar1_: epsilon productions (A ::= )
      * - grammar2_: unary productions (A ::= B)
      * - grammar3_: binary productions (A ::= B C)
+     *
+     * A line `%indexed op_i cp_i T_i` declares indexed families; other symbols, including ones
+     * that end in `_i`, stay plain labels. A family is a single label of the grammar, and graph
+     * edges carry it as `op_<n>` with the index n stored in Edge::index. All indexed symbols of a
+     * rule share one index, so `S op_i T_i` and `T_i S cp_i` match every `op_n` only with `cp_n`,
+     * without a label per index.
+     *
+     * Indices are only matched by SolverDyck; Solver rejects indexed grammars that are not
+     * Dyck-shaped or that would go to any other solver. The generic containers do not keep the
+     * index of an edge, which would add it to every list entry and dedup key of every label.
      */
 	class Grammar 
 	{
@@ -59,6 +84,24 @@ namespace gracfl
 		std::unordered_set<std::string> allLabels_;
 		/// Context-specific labels (e.g., call/return)
 		std::vector<uint> contextLabels_;
+		/// Whether a label is an indexed family (declared by a %indexed line)
+		std::vector<bool> indexed_;
+		/// Whether any label is an indexed family
+		bool hasIndexed_ = false;
+
+		// Dyck shape (see detectDyck()):
+		/// Start symbol S of a Dyck-shaped grammar, -1 if the grammar is not Dyck-shaped
+		int dyckStart_ = -1;
+		/// Whether S ::= (epsilon) is part of the grammar
+		bool dyckEpsilon_ = false;
+		/// Parenthesis kinds of a Dyck-shaped grammar
+		std::vector<DyckKind> dyckKinds_;
+
+		// Strata (see computeStrata()):
+		/// Nonterminals of every stratum, in evaluation order
+		std::vector<std::vector<uint>> strata_;
+		/// Stratum of every label, -1 for labels without unary or binary rules
+		std::vector<int> stratumOf_;
 
 		/**
          * @brief Reads the grammar file and populates rule and index structures.
@@ -66,6 +109,30 @@ namespace gracfl
          */
 		void loadGrammarFile();
 
+		/**
+         * @brief Recognizes a normalized Dyck grammar and fills the dyck* members.
+         *
+         * Accepted are grammars made of S ::= S S, optionally S ::= (epsilon), and per parenthesis
+         * kind the rules of one DyckKind. Parentheses must be terminals used by a single kind, and
+         * without the epsilon rule every kind needs S ::= o c. Anything else leaves dyckStart_ at -1.
+         */
+		void detectDyck();
+
+		/**
+         * @brief Splits the nonterminals into strata, the SCCs of their dependency graph.
+         *
+         * A depends on B if B is on the right-hand side of a unary or binary rule of A. Strata are
+         * ordered so that the rules of a stratum only use labels of earlier strata and of itself,
+         * hence a stratum is final once its own fixpoint is reached.
+         */
+		void computeStrata();
+
+		/**
+         * @brief Checks that the index of every indexed left-hand side is bound by its right-hand side.
+         * @throws std::runtime_error for an indexed epsilon rule or an indexed A without indexed B or C.
+         */
+		void checkIndexedRules() const;
+
 	
 		/**
          * @brief Constructs a Grammar object and loads the grammar from file.
@@ -173,6 +240,69 @@ namespace gracfl
 			return grammar3indexRight_;
 		}
 
+		/**
+         * @brief Check whether the grammar was recognized as Dyck-shaped.
+         * @return True if detectDyck() found a start symbol and its parenthesis kinds.
+         */
+		inline bool isDyck() const
+		{
+			return dyckStart_ >= 0;
+		}
+
+		/**
+         * @brief Check whether a label is an indexed family.
+         * @param symbol Label ID.
+         * @return True if the label was declared by a %indexed line.
+         */
+		inline bool isIndexed(uint symbol) const
+		{
+			return indexed_[symbol];
+		}
+
+		/**
+         * @brief Check whether the grammar has indexed families.
+         * @return True if any label is indexed; only the Dyck solver matches indices.
+         */
+		inline bool hasIndexedLabels() const
+		{
+			return hasIndexed_;
+		}
+
+		/**
+         * @brief Maps an edge label of a graph file to its label ID and index.
+         * @param name Label as written in the graph file, `op_<n>` for the indexed family `op_i`.
+         * @param label Receives the label ID.
+         * @param index Receives n for an indexed family, 0 otherwise.
+         * @return False if the label is not part of the grammar.
+         */
+		bool parseLabel(const std::string& name, uint& label, uint& index) const;
+
+		/**
+         * @brief Get the strata of the nonterminals (see computeStrata()).
+         * @return Labels of every stratum, in evaluation order.
+         */
+		inline const std::vector<std::vector<uint>>& getStrata() const
+		{
+			return strata_;
+		}
+
+		/**
+         * @brief Get the stratum of a label.
+         * @param symbol Label ID.
+         * @return Index into getStrata(), -1 for labels without unary or binary rules.
+         */
+		inline int getStratum(uint symbol) const
+		{
+			return stratumOf_[symbol];
+		}
+
+		/**
+         * @brief Labels whose edges are needed to derive the given labels.
+         * @param output Requested labels, all labels if empty.
+         * @return Per label, whether it is requested or a requested label depends on it.
+         */
+		std::vector<bool> requiredLabels(const std::vector<uint>& output) const;
+
 		/**
          * @brief Get the total number of unique labels in the grammar.
          * @return Number of unique labels.
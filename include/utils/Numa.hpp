@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include "Types.hpp"
+
+namespace gracfl {
+namespace numa {
+    /// Vertex chunk size of the static OpenMP schedule shared by the parallel solvers.
+    constexpr uint VERTEX_CHUNK = 512;
+
+    /**
+     * @brief Number of NUMA nodes usable by this process.
+     * @return Node count, 1 if GraCFL was built without libnuma or NUMA is unavailable.
+     */
+    uint getNumNodes();
+
+    /**
+     * @brief Whether the machine has more than one usable NUMA node.
+     */
+    inline bool isMultiNode() { return getNumNodes() > 1; }
+
+    /**
+     * @brief NUMA node serving OpenMP thread tid of a team of numThreads threads.
+     *
+     * Threads are mapped to nodes in contiguous blocks, so neighbouring thread IDs share a node.
+     */
+    uint nodeOfThread(uint tid, uint numThreads);
+
+    /**
+     * @brief Pins every thread of a numThreads-wide OpenMP team to its node (see nodeOfThread).
+     *
+     * The OpenMP runtime reuses the pinned threads for later teams of the same size. No-op on
+     * single-node machines.
+     */
+    void bindThreads(uint numThreads);
+
+    /**
+     * @brief Re-allocates every per-vertex row from the thread that owns the vertex.
+     *
+     * Uses the same static schedule as the solvers' vertex loops, so that with first-touch
+     * placement (and bound threads) a row ends up on the node of the thread processing it.
+     *
+     * Defined in Numa.cpp, which is compiled with OpenMP, for the row types of the graph containers.
+     *
+     * @param rows Per-vertex containers, indexed by vertex ID.
+     * @param numThreads Number of OpenMP threads of the solver.
+     */
+    template <typename Row>
+    void placeRows(std::vector<Row>& rows, uint numThreads);
+
+    /**
+     * @brief Binds the solver threads and moves the graph containers next to them.
+     *
+     * The graph must provide placeContainers(numThreads). No-op on single-node machines.
+     *
+     * @param graph Graph of a parallel solver.
+     * @param numThreads Number of OpenMP threads of the solver.
+     */
+    template <typename GraphT>
+    void placeGraph(GraphT* graph, uint numThreads)
+    {
+        if (!isMultiNode())
+        {
+            return;
+        }
+        bindThreads(numThreads);
+        graph->placeContainers(numThreads);
+    }
+}
+}
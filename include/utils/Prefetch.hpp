@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "Edges.hpp"
+#include "Types.hpp"
+
+namespace gracfl {
+namespace prefetch {
+    /// Default number of neighbors the join loops prefetch ahead, 0 disables prefetching.
+    constexpr uint DEFAULT_DISTANCE = 8;
+
+    /// Hint that p will be read soon, kept in all cache levels.
+    inline void read(const void* p)
+    {
+        __builtin_prefetch(p, 0, 3);
+    }
+
+    /**
+     * @brief Prefetches the lists a grammar-driven join loop reads for upcoming neighbors.
+     *
+     * Iteration j of the loop reads rows[nbrs[j]][label] for the label of every rule. Reaching
+     * that data takes three dependent loads (the neighbor's row, the list header in it, the list
+     * data), so each one is requested at its own distance and only dereferences what an earlier
+     * iteration already brought in: the row at j + distance, the headers at j + 2/3 distance and
+     * the first line of list data at j + 1/3 distance.
+     *
+     * @param rows Per-vertex, per-label lists (outEdges_ or inEdges_).
+     * @param nbrs Neighbor list the loop walks.
+     * @param j Current position in nbrs.
+     * @param end End of the walked range of nbrs.
+     * @param rules (list label, derived label) pairs of the rules applied per neighbor.
+     * @param distance Prefetch distance in neighbors, 0 disables.
+     * @param newOnly The loop reads only the new part of the lists, [OLD_END, NEW_END).
+     */
+    template <typename List>
+    inline void joinLists(const std::vector<std::vector<List>>& rows, const uint* nbrs, uint j, uint end,
+                          const std::vector<std::pair<uint, uint>>& rules, uint distance, bool newOnly)
+    {
+        if (distance == 0 || rules.empty()) return;
+        uint far = j + distance;
+        if (far < end) read(&rows[nbrs[far]]);
+        uint mid = j + distance * 2 / 3;
+        if (mid < end)
+        {
+            const std::vector<List>& row = rows[nbrs[mid]];
+            for (const auto& rule : rules) read(&row[rule.first]);
+        }
+        uint near = j + distance / 3;
+        if (near < end)
+        {
+            const std::vector<List>& row = rows[nbrs[near]];
+            for (const auto& rule : rules)
+            {
+                const List& list = row[rule.first];
+                uint from = newOnly ? list.OLD_END : 0;
+                if (from < list.NEW_END) read(list.vertexList.data() + from);
+            }
+        }
+    }
+
+    /**
+     * @brief Prefetches the lists a topology-driven join loop reads for upcoming neighbors.
+     *
+     * Iteration j reads rows[nbrs[j].vtx], one list per vertex, so two stages suffice: the list
+     * header at j + distance and the first line of list data at j + distance / 2.
+     *
+     * @param rows Per-vertex labeled lists.
+     * @param nbrs Labeled neighbor list the loop walks.
+     * @param j Current position in nbrs.
+     * @param end End of the walked range of nbrs.
+     * @param distance Prefetch distance in neighbors, 0 disables.
+     * @param newOnly The loop reads only the new part of the lists, [OLD_END, NEW_END).
+     */
+    template <typename List>
+    inline void topoLists(const std::vector<List>& rows, const LbldVtx* nbrs, uint j, uint end,
+                          uint distance, bool newOnly)
+    {
+        if (distance == 0) return;
+        uint far = j + distance;
+        if (far < end) read(&rows[nbrs[far].vtx]);
+        uint near = j + distance / 2;
+        if (near < end)
+        {
+            const List& list = rows[nbrs[near].vtx];
+            uint from = newOnly ? list.OLD_END : 0;
+            if (from < list.NEW_END) read(list.vertexList.data() + from);
+        }
+    }
+}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Types.hpp"
+
+namespace gracfl {
+    /**
+     * @class SetPool
+     * @brief Hash-consed pool of sorted vertex sets, shared by reference count.
+     *
+     * intern() returns the ID of the set equal to its argument and only stores the set if no
+     * equal one exists, so identical neighbor sets are kept once however many rows refer to
+     * them. Sets are immutable: a row whose set grows interns the grown set and releases the
+     * old one (copy-on-write). Freed IDs are reused. ID EMPTY is the empty set, it is always
+     * present and never counted. Sets are found by hash in an open-addressing table of IDs.
+     *
+     * The pool itself is not thread-safe; hashes can be computed in parallel beforehand.
+     *
+     * Only GraphCSR uses the pool. The TemporalVector lists of Graph3DOut/Graph3DBi are grown in
+     * place by every sweep and read through their old/new windows while they grow, so a shared
+     * list would have to be copied on each append of each hot loop; the CSR rows are replaced
+     * whole once per iteration, which is where copy-on-write costs nothing extra.
+     */
+    class SetPool
+    {
+    public:
+        static constexpr uint EMPTY = 0;  ///< ID of the empty set
+
+        SetPool();
+
+        /**
+         * @brief Hash of a sorted set, as intern() expects it.
+         */
+        static ull hashOf(const uint* data, size_t size);
+
+        /**
+         * @brief Returns the ID of the set equal to set, adding it if absent, and takes a reference.
+         * @param set Sorted vertices without duplicates; moved from only if it is added.
+         * @param hash hashOf(set).
+         */
+        uint intern(std::vector<uint>&& set, ull hash);
+
+        /**
+         * @brief Drops a reference to a set, freeing it with the last one.
+         */
+        void release(uint id);
+
+        inline const std::vector<uint>& get(uint id) const { return sets_[id]; }
+        /// IDs handed out so far are below capacity().
+        inline uint capacity() const { return sets_.size(); }
+        /// Distinct non-empty sets stored.
+        inline ull distinct() const { return distinct_; }
+        /// Vertices stored over all distinct sets.
+        inline ull entries() const { return entries_; }
+
+    private:
+        std::vector<std::vector<uint>> sets_;
+        std::vector<ull> hashes_;
+        std::vector<ull> refs_;
+        std::vector<uint> free_;
+        std::vector<uint> table_;   ///< IDs by hash, linear probing, power-of-two size
+        ull occupied_ = 0;          ///< Slots of table_ holding an ID or a tombstone
+        ull distinct_ = 0;
+        ull entries_ = 0;
+
+        static constexpr uint FREE = 0xFFFFFFFFu;       ///< Slot never used
+        static constexpr uint TOMBSTONE = 0xFFFFFFFEu;  ///< Slot of a freed set
+
+        /**
+         * @brief Rebuilds table_ with room for four times the live sets, dropping the tombstones.
+         */
+        void grow();
+    };
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <omp.h>
+#include "../Types.hpp"
+
+namespace gracfl {
+    /**
+     * @class EdgeStaging
+     * @brief Per-thread buffers for the edges a parallel iteration derives, appended to the graph at its end.
+     *
+     * The owner-computes solvers derive all edges of a vertex on the thread processing it, so the
+     * dedup sets can be updated right away but the lists other threads are reading need not be.
+     * Staged edges are gathered per list while a thread stays on one vertex and closed into one run
+     * per (vertex, list) when it moves on. commit() hands every run to the graph in a single append,
+     * so a list grows at most once per iteration and is never resized while being read.
+     *
+     * A team of one thread has no concurrent readers: then direct() is set, the graph appends its
+     * edges right away as the serial solvers do, and nothing is staged or copied.
+     *
+     * @tparam T Entry type of the lists (vertex ID or labeled vertex).
+     */
+    template <typename T>
+    class EdgeStaging
+    {
+    public:
+        /**
+         * @brief Sizes one buffer per thread of a team, keeping them if nothing changed.
+         * @param numThreads Team size of the parallel loops.
+         * @param lists Number of lists per vertex (labels, or 1 for labeled lists).
+         */
+        void reset(uint numThreads, uint lists)
+        {
+            direct_ = numThreads <= 1;
+            if (direct_ || (buffers_.size() == numThreads && lists_ == lists)) return;
+            buffers_.assign(numThreads, Buffer());
+            for (Buffer& buffer : buffers_) buffer.pending.resize(lists);
+            lists_ = lists;
+        }
+
+        /// Whether edges are appended right away instead of staged, for a team of one thread.
+        inline bool direct() const { return direct_; }
+
+        /**
+         * @brief Stages an entry of a list of vertex, in the buffer of the calling thread.
+         */
+        inline void add(uint vertex, uint list, const T& entry)
+        {
+            pendingOf(vertex, list).push_back(entry);
+        }
+
+        /**
+         * @brief Stages count entries of a list of vertex, in the buffer of the calling thread.
+         */
+        inline void add(uint vertex, uint list, const T* entries, size_t count)
+        {
+            if (count == 0) return;
+            std::vector<T>& pending = pendingOf(vertex, list);
+            pending.insert(pending.end(), entries, entries + count);
+        }
+
+        /**
+         * @brief Passes the runs of one buffer to append and empties it.
+         *
+         * Buffers hold the edges of disjoint vertex sets, so they can be committed concurrently by
+         * any threads once the derivations of the iteration are done.
+         *
+         * @param thread Buffer of this thread of the team.
+         * @param append Called as append(vertex, list, entries, count) once per run.
+         */
+        template <typename Append>
+        void commit(uint thread, Append append)
+        {
+            if (direct_) return;
+            Buffer& buffer = buffers_[thread];
+            close(buffer);
+            for (const Run& run : buffer.runs)
+            {
+                append(run.vertex, run.list, buffer.entries.data() + run.offset, run.count);
+            }
+            buffer.runs.clear();
+            buffer.entries.clear();
+        }
+
+    private:
+        static constexpr uint NONE = std::numeric_limits<uint>::max();
+
+        struct Run
+        {
+            uint vertex;
+            uint list;
+            size_t offset;  ///< First entry in Buffer::entries
+            size_t count;
+        };
+
+        struct alignas(64) Buffer
+        {
+            uint vertex = NONE;                      ///< Vertex of the pending entries
+            std::vector<std::vector<T>> pending;     ///< Entries of vertex, per list
+            std::vector<uint> touched;               ///< Lists with pending entries
+            std::vector<Run> runs;                   ///< Closed runs, in staging order
+            std::vector<T> entries;                  ///< Entries of the closed runs
+        };
+
+        std::vector<Buffer> buffers_;
+        uint lists_ = 0;
+        bool direct_ = false;
+
+        inline std::vector<T>& pendingOf(uint vertex, uint list)
+        {
+            Buffer& buffer = buffers_[omp_get_thread_num()];
+            if (buffer.vertex != vertex)
+            {
+                close(buffer);
+                buffer.vertex = vertex;
+            }
+            if (buffer.pending[list].empty()) buffer.touched.push_back(list);
+            return buffer.pending[list];
+        }
+
+        static void close(Buffer& buffer)
+        {
+            for (uint list : buffer.touched)
+            {
+                std::vector<T>& pending = buffer.pending[list];
+                buffer.runs.push_back({buffer.vertex, list, buffer.entries.size(), pending.size()});
+                buffer.entries.insert(buffer.entries.end(), pending.begin(), pending.end());
+                pending.clear();
+            }
+            buffer.touched.clear();
+            buffer.vertex = NONE;
+        }
+    };
+}
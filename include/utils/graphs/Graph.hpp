@@ -2,6 +2,9 @@
 
 #include "../Edges.hpp"
 #include "../Grammar.hpp"
+#include "../Arena.hpp"
+#include "../FlatHashset.hpp"
+#include "../Numa.hpp"
 #include "tbb/concurrent_unordered_set.h"
 
 // Graph.hpp
@@ -16,14 +19,18 @@ namespace gracfl {
          uint numLabels_ = 0;
          /// Flat list of edges read from input
          std::vector<Edge> edges_;
+         /// Per-thread arenas backing the vertex lists and dedup sets of the derived graphs
+         ArenaPool arena_;
+         /// Threads that build the containers, those of the solver that uses the graph
+         uint numThreads_ = 1;
     public:
         Graph() = default;
-        Graph(std::string& graphfilepath, const Grammar& grammar);
-        Graph(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
         virtual ~Graph() = default;
         void loadGraphFile(std::string& graphfilepath, const Grammar& grammar);
         void loadEdges(std::vector<Edge>& edges, const Grammar& grammar);
-        ull countEdgeHelper(std::vector<std::vector<std::unordered_set<ull>>>& hashset);
+        ull countEdgeHelper(std::vector<std::vector<FlatHashset>>& hashset);
         ull countEdgeHelperConcurrent(std::vector<std::vector<tbb::concurrent_unordered_set<ull>>>& hashset);
 
         /**
@@ -49,5 +56,43 @@ namespace gracfl {
          * @return Vector of edges in the graph.
          */
         inline std::vector<Edge>& getEdges() { return edges_; }
+
+        /**
+         * @brief Get the arenas of the graph containers.
+         * @return Arena pool owned by this graph.
+         */
+        inline ArenaPool& getArena() { return arena_; }
+
+        /**
+         * @brief Get the number of threads that build the containers.
+         * @return Team size of the solver that uses the graph, 1 for the serial solvers.
+         */
+        inline uint getNumThreads() const { return numThreads_; }
+
+    protected:
+        /**
+         * @brief Fills rows with n copies of prototype, one row per vertex, in parallel.
+         *
+         * Rows are built by getNumThreads() threads with the static schedule of the parallel
+         * solvers, so with first-touch placement a row starts out on the node of the thread that
+         * will process it. Defined in Graph.cpp, which is compiled with OpenMP, for the row types
+         * of the graph containers.
+         */
+        template <typename Row>
+        void initRows(std::vector<Row>& rows, size_t n, const Row& prototype);
+
+        /**
+         * @brief Groups the edges by one of their vertices, with getNumThreads() threads.
+         *
+         * A counting pass sizes the groups, a prefix sum places them and a scatter fills them.
+         * Each group is then sorted, so the edges of a vertex keep their input order and the
+         * containers come out the same as with a serial pass.
+         *
+         * @param vertexOf Vertex the edges are grouped by, &Edge::from or &Edge::to.
+         * @param nodeSize Number of groups.
+         * @param offsets Receives nodeSize + 1 group offsets into order.
+         * @param order Receives the edge indices, grouped by vertex.
+         */
+        void groupEdges(uint Edge::* vertexOf, size_t nodeSize, std::vector<ull>& offsets, std::vector<uint>& order);
     };
 }
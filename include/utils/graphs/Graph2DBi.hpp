@@ -20,21 +20,29 @@ namespace gracfl {
     public:
         std::vector<TemporalVectorWithLbldVtx> outEdges_; ///< Outgoing edges organized by  source vertex
         std::vector<TemporalVectorWithLbldVtx> inEdges_; ///< Incoming edges organized by  destination vertex
-        std::vector<std::vector<std::unordered_set<ull>>> hashset_; ///< Hashset for edge presence tracking (node × label → set of out neighbors)
+        std::vector<std::vector<FlatHashset>> hashset_; ///< Hashset for edge presence tracking (node × label → set of out neighbors)
         
         /**
          * @brief Constructs a Graph2DBi object.
          * @param graphfilepath Path to the graph file to be loaded.
          * @param grammar Reference to the grammar object for labeled edge interpretation.
+         * @param numThreads Threads building the containers, those of the solver that uses the graph.
          */
-        Graph2DBi(std::string& graphfilepath, const Grammar& grammar);
+        Graph2DBi(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
 
         /**
          * @brief Constructs a Graph2DBi object from a vector of edges.
          * @param edges Reference to the vector of edges to be loaded.
          * @param grammar Reference to the grammar object for labeled edge interpretation.
+         * @param numThreads Threads building the containers, those of the solver that uses the graph.
          */
-        Graph2DBi(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph2DBi(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Destroys the containers and frees their arenas in bulk.
+         */
+        ~Graph2DBi();
+
 
         /**
          * @brief Initializes internal containers for graph data.
@@ -86,6 +94,6 @@ namespace gracfl {
          * @brief Retrieves the edge presence hashset.
          * @return Reference to the 3D hashset used to track edges.
          */
-        inline std::vector<std::vector<std::unordered_set<ull>>>& getHashset() { return hashset_; }
+        inline std::vector<std::vector<FlatHashset>>& getHashset() { return hashset_; }
     };
 }
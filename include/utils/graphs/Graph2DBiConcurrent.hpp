@@ -5,6 +5,7 @@
 #include "../Edges.hpp"
 #include "Graph.hpp"
 #include "../Types.hpp"
+#include "../Numa.hpp"
 #include "tbb/concurrent_vector.h"
 #include "tbb/concurrent_queue.h"
 #include "tbb/concurrent_unordered_set.h"
@@ -25,14 +26,15 @@ namespace gracfl {
         std::vector<TemporalVectorConcurrentWithLbldVtx> inEdges_;
         std::vector<std::vector<tbb::concurrent_unordered_set<ull>>> hashset_;
 
-        Graph2DBiConcurrent(std::string& graphfilepath, const Grammar& grammar);
-        Graph2DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph2DBiConcurrent(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph2DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
         void initContainers();
         void addInitialEdges();
         void clearContainers();
         void addSelfEdge(Edge& edge);
         void checkAndAddEdge(Edge& edge, bool& terminate);
         ull countEdge();
+        void placeContainers(uint numThreads);
 
         inline std::vector<TemporalVectorConcurrentWithLbldVtx>& getOutEdges()  { return outEdges_; }
         inline std::vector<TemporalVectorConcurrentWithLbldVtx>& getInEdges() { return inEdges_; }
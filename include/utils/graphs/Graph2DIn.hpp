@@ -4,7 +4,9 @@
 #include <unordered_set>
 #include "../Edges.hpp"
 #include "Graph.hpp"
+#include "EdgeStaging.hpp"
 #include "../Types.hpp"
+#include "../Numa.hpp"
 
 namespace gracfl {
     /**
@@ -19,18 +21,42 @@ namespace gracfl {
     {
     public:
         std::vector<TemporalVectorWithLbldVtx> inEdges_;
-        std::vector<std::vector<std::unordered_set<ull>>> inHashset_;
+        std::vector<std::vector<FlatHashset>> inHashset_;
         
-        Graph2DIn(std::string& graphfilepath, const Grammar& grammar);
-        Graph2DIn(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph2DIn(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph2DIn(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Destroys the containers and frees their arenas in bulk.
+         */
+        ~Graph2DIn();
+
         void initContainers();
         void addInitialEdges();
         void clearContainers();
         void addSelfEdge(Edge& edge);
         void checkAndAddEdge(Edge& edge, bool& terminate);
+        /**
+         * @brief Like checkAndAddEdge, but a new edge is staged by the calling thread until commitStaged().
+         * @return Whether the edge is new.
+         */
+        bool stageEdge(Edge& edge);
+        /**
+         * @brief Sizes the staging buffers for the parallel loops of a team of numThreads threads;
+         *        a team of one appends its edges right away instead.
+         */
+        void beginStaging(uint numThreads);
+        /**
+         * @brief Appends the edges staged by a thread of the team, one append per list.
+         */
+        void commitStaged(uint thread);
         ull countEdge();
+        void placeContainers(uint numThreads);
 
         inline std::vector<TemporalVectorWithLbldVtx>& getInEdges() { return inEdges_; }
-        inline std::vector<std::vector<std::unordered_set<ull>>>& getInHashset() { return inHashset_; }
+        inline std::vector<std::vector<FlatHashset>>& getInHashset() { return inHashset_; }
+
+    private:
+        EdgeStaging<LbldVtx> staging_;  ///< Derived edges of the current parallel iteration, per thread
     };
 }
@@ -20,19 +20,36 @@ namespace gracfl {
     public:
         std::vector<std::vector<TemporalVector>> outEdges_;
         std::vector<std::vector<TemporalVector>> inEdges_;
-        std::vector<std::vector<std::unordered_set<ull>>> hashset_;
+        std::vector<std::vector<FlatHashset>> hashset_;
         
-        Graph3DBi(std::string& graphfilepath, const Grammar& grammar);
-        Graph3DBi(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph3DBi(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph3DBi(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Destroys the containers and frees their arenas in bulk.
+         */
+        ~Graph3DBi();
+
         void initContainers();
         void addInitialEdges();
         void clearContainers();
         void addSelfEdge(Edge& edge);
         void checkAndAddEdge(Edge& edge, bool& terminate);
+        /**
+         * @brief Adds the absent edges among a run of candidates with the same source and label.
+         *
+         * The candidates are tested against the dedup set in one batch and the new ones are
+         * appended to the out-edge list in one go. The targets may point into any vertex list of this graph.
+         */
+        void checkAndAddEdges(uint from, uint label, const uint* targets, size_t count, bool& terminate);
+        /**
+         * @brief Drops all edges of a label, freeing its lists and dedup sets.
+         */
+        void releaseLabel(uint label);
         ull countEdge();
 
         inline std::vector<std::vector<TemporalVector>>& getOutEdges()  { return outEdges_; }
         inline std::vector<std::vector<TemporalVector>>& getInEdges() { return inEdges_; }
-        inline std::vector<std::vector<std::unordered_set<ull>>>& getHashset() { return hashset_; }
+        inline std::vector<std::vector<FlatHashset>>& getHashset() { return hashset_; }
     };
 }
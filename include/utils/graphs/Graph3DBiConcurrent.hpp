@@ -5,6 +5,7 @@
 #include "../Edges.hpp"
 #include "Graph.hpp"
 #include "../Types.hpp"
+#include "../Numa.hpp"
 #include "tbb/concurrent_vector.h"
 #include "tbb/concurrent_queue.h"
 #include "tbb/concurrent_unordered_set.h"
@@ -26,14 +27,15 @@ namespace gracfl {
         std::vector<std::vector<TemporalVectorConcurrent>> inEdges_;
         std::vector<std::vector<tbb::concurrent_unordered_set<ull>>> hashset_;
 
-        Graph3DBiConcurrent(std::string& graphfilepath, const Grammar& grammar);
-        Graph3DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph3DBiConcurrent(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph3DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
         void initContainers();
         void addInitialEdges();
         void clearContainers();
         void addSelfEdge(Edge& edge);
         void checkAndAddEdge(Edge& edge, bool& terminate);
         ull countEdge();
+        void placeContainers(uint numThreads);
 
         inline std::vector<std::vector<TemporalVectorConcurrent>>& getOutEdges()  { return outEdges_; }
         inline std::vector<std::vector<TemporalVectorConcurrent>>& getInEdges() { return inEdges_; }
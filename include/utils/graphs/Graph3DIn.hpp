@@ -4,7 +4,9 @@
 #include <unordered_set>
 #include "../Edges.hpp"
 #include "Graph.hpp"
+#include "EdgeStaging.hpp"
 #include "../Types.hpp"
+#include "../Numa.hpp"
 
 namespace gracfl {
     /**
@@ -18,18 +20,54 @@ namespace gracfl {
     {
     public:
         std::vector<std::vector<TemporalVector>> inEdges_;
-        std::vector<std::vector<std::unordered_set<ull>>> inHashset_;
+        std::vector<std::vector<FlatHashset>> inHashset_;
+
+        Graph3DIn(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph3DIn(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Destroys the containers and frees their arenas in bulk.
+         */
+        ~Graph3DIn();
 
-        Graph3DIn(std::string& graphfilepath, const Grammar& grammar);
-        Graph3DIn(std::vector<Edge>& edges, const Grammar& grammar);
         void initContainers();
         void addInitialEdges();
         void clearContainers();
         void addSelfEdge(Edge& edge);
         void checkAndAddEdge(Edge& edge, bool& terminate);
+        /**
+         * @brief Adds the absent edges among a run of candidates with the same destination and label.
+         *
+         * The candidates are tested against the dedup set in one batch and the new ones are
+         * appended to the in-edge list in one go. The sources may point into any vertex list of this graph.
+         */
+        void checkAndAddEdges(uint to, uint label, const uint* sources, size_t count, bool& terminate);
+        /**
+         * @brief Like checkAndAddEdge, but a new edge is staged by the calling thread until commitStaged().
+         * @return Whether the edge is new.
+         */
+        bool stageEdge(Edge& edge);
+        /**
+         * @brief Like checkAndAddEdges, but the new edges are staged by the calling thread until commitStaged().
+         * @return Number of new edges.
+         */
+        size_t stageEdges(uint to, uint label, const uint* sources, size_t count);
+        /**
+         * @brief Sizes the staging buffers for the parallel loops of a team of numThreads threads;
+         *        a team of one appends its edges right away instead.
+         */
+        void beginStaging(uint numThreads);
+        /**
+         * @brief Appends the edges staged by a thread of the team, one append per list.
+         */
+        void commitStaged(uint thread);
         ull countEdge();
+        void placeContainers(uint numThreads);
 
         inline std::vector<std::vector<TemporalVector>>& getInEdges() { return inEdges_; }
-        inline std::vector<std::vector<std::unordered_set<ull>>>& getInHashset() { return inHashset_; }
+        inline std::vector<std::vector<FlatHashset>>& getInHashset() { return inHashset_; }
+
+    private:
+        EdgeStaging<uint> staging_;  ///< Derived edges of the current parallel iteration, per thread
     };
 }
@@ -4,7 +4,9 @@
 #include <unordered_set>
 #include "../Edges.hpp"
 #include "Graph.hpp"
+#include "EdgeStaging.hpp"
 #include "../Types.hpp"
+#include "../Numa.hpp"
 
 namespace gracfl {
     /**
@@ -19,18 +21,75 @@ namespace gracfl {
     {
     public:
         std::vector<std::vector<TemporalVector>> outEdges_;
-        std::vector<std::vector<std::unordered_set<ull>>> hashset_;
+        std::vector<std::vector<FlatHashset>> hashset_;
         
-        Graph3DOut(std::string& graphfilepath, const Grammar& grammar);
-        Graph3DOut(std::vector<Edge>& edges, const Grammar& grammar);
+        Graph3DOut(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        Graph3DOut(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Destroys the containers and frees their arenas in bulk.
+         */
+        ~Graph3DOut();
+
         void initContainers();
         void addInitialEdges();
         void clearContainers();
         void addSelfEdge(Edge& edge);
         void checkAndAddEdge(Edge& edge, bool& terminate);
+        /**
+         * @brief Adds the absent edges among a run of candidates with the same source and label.
+         *
+         * The candidates are tested against the dedup set in one batch and the new ones are
+         * appended to the out-edge list in one go. The targets may point into any vertex list of this graph.
+         */
+        void checkAndAddEdges(uint from, uint label, const uint* targets, size_t count, bool& terminate);
+        /**
+         * @brief Like checkAndAddEdge, but a new edge is staged by the calling thread until commitStaged().
+         * @return Whether the edge is new.
+         */
+        bool stageEdge(Edge& edge);
+        /**
+         * @brief Like checkAndAddEdges, but the new edges are staged by the calling thread until commitStaged().
+         * @return Number of new edges.
+         */
+        size_t stageEdges(uint from, uint label, const uint* targets, size_t count);
+        /**
+         * @brief Sizes the staging buffers for the parallel loops of a team of numThreads threads;
+         *        a team of one appends its edges right away instead.
+         */
+        void beginStaging(uint numThreads);
+        /**
+         * @brief Appends the edges staged by a thread of the team, one append per list.
+         */
+        void commitStaged(uint thread);
         ull countEdge();
+        void placeContainers(uint numThreads);
+
+        /**
+         * @brief Maps the targets of every edge added from now on to their representative.
+         * @param rep Representative of every vertex, owned by the caller, or nullptr to stop.
+         */
+        inline void redirectTargets(const std::vector<uint>* rep) { redirect_ = rep ? rep->data() : nullptr; }
+
+        /**
+         * @brief Moves the rows of vertex from into the rows of vertex into, for a merge of the two.
+         *
+         * Targets are mapped to their representative (see redirectTargets) on the way. The rows of
+         * into become all delta, so the next iteration joins them in full with every row reaching
+         * them, and the rows of from are freed.
+         */
+        void mergeRows(uint from, uint into);
 
         inline std::vector<std::vector<TemporalVector>>& getOutEdges() { return outEdges_; }
-        inline std::vector<std::vector<std::unordered_set<ull>>>& getHashset() { return hashset_; }
+        inline std::vector<std::vector<FlatHashset>>& getHashset() { return hashset_; }
+
+    private:
+        EdgeStaging<uint> staging_;  ///< Derived edges of the current parallel iteration, per thread
+        const uint* redirect_ = nullptr;  ///< Representative of every vertex, if targets are redirected
+
+        /**
+         * @brief The targets mapped to their representatives in a per-thread buffer, or targets itself.
+         */
+        const uint* redirected(const uint* targets, size_t count);
     };
 }
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include "../Edges.hpp"
+#include "Graph.hpp"
+#include "../Types.hpp"
+
+namespace gracfl {
+    /**
+     * @class Graph3DPartition
+     * @brief A label-partitioned graph holding only the vertices owned by one rank of a distributed run.
+     *
+     * Vertices are block-partitioned over the ranks. For every owned vertex the rank stores the
+     * outgoing and incoming edges grouped by label, together with separate dedup sets for both
+     * sides, so that all joins whose middle vertex is owned can be evaluated locally. Containers are
+     * indexed by the local vertex ID (global ID - begin of the owned range).
+     */
+    class Graph3DPartition : public Graph
+    {
+    public:
+        std::vector<std::vector<TemporalVector>> outEdges_; ///< Outgoing edges of owned vertices (local vertex × label)
+        std::vector<std::vector<TemporalVector>> inEdges_; ///< Incoming edges of owned vertices (local vertex × label)
+        std::vector<std::vector<FlatHashset>> outHashset_; ///< Dedup set of owned sources (local vertex × label → destinations)
+        std::vector<std::vector<FlatHashset>> inHashset_; ///< Dedup set of owned destinations (local vertex × label → sources)
+
+        /**
+         * @brief Constructs the partition of a rank from a graph file.
+         * @param graphfilepath Path to the graph file to be loaded.
+         * @param grammar Reference to the grammar object for labeled edge interpretation.
+         * @param rank Rank owning this partition.
+         * @param numRanks Total number of ranks.
+         */
+        Graph3DPartition(std::string& graphfilepath, const Grammar& grammar, uint rank, uint numRanks);
+
+        /**
+         * @brief Constructs the partition of a rank from a vector of edges.
+         * @param edges Reference to the vector of edges to be loaded.
+         * @param grammar Reference to the grammar object for labeled edge interpretation.
+         * @param rank Rank owning this partition.
+         * @param numRanks Total number of ranks.
+         */
+        Graph3DPartition(std::vector<Edge>& edges, const Grammar& grammar, uint rank, uint numRanks);
+
+        /**
+         * @brief Destroys the containers and frees their arenas in bulk.
+         */
+        ~Graph3DPartition();
+
+
+        void initContainers();
+
+        /**
+         * @brief Adds the initial edges touching an owned vertex and releases the global edge list.
+         */
+        void addInitialEdges();
+        void clearContainers();
+        void addSelfEdge(Edge& edge);
+
+        /**
+         * @brief Adds the edge to the out-lists of its (owned) source if it is not present yet.
+         */
+        void checkAndAddOutEdge(Edge& edge, bool& terminate);
+
+        /**
+         * @brief Adds the edge to the in-lists of its (owned) destination if it is not present yet.
+         */
+        void checkAndAddInEdge(Edge& edge, bool& terminate);
+
+        /**
+         * @brief Counts the edges whose source is owned by this rank.
+         */
+        ull countEdge();
+
+        /// Rank owning the global vertex v.
+        inline uint owner(uint v) const { return v / chunk_; }
+        /// Whether the global vertex v is owned by this rank.
+        inline bool isOwned(uint v) const { return v >= begin_ && v < end_; }
+        /// Local index of an owned global vertex.
+        inline uint toLocal(uint v) const { return v - begin_; }
+        /// First owned global vertex ID.
+        inline uint getBegin() const { return begin_; }
+        /// Number of owned vertices.
+        inline uint getLocalNodeSize() const { return end_ - begin_; }
+
+        inline std::vector<std::vector<TemporalVector>>& getOutEdges() { return outEdges_; }
+        inline std::vector<std::vector<TemporalVector>>& getInEdges() { return inEdges_; }
+        inline std::vector<std::vector<FlatHashset>>& getOutHashset() { return outHashset_; }
+
+    private:
+        uint rank_;     ///< Rank owning this partition
+        uint numRanks_; ///< Total number of ranks
+        uint chunk_;    ///< Number of vertices per rank
+        uint begin_;    ///< First owned vertex
+        uint end_;      ///< One past the last owned vertex
+
+        void computeRange();
+    };
+}
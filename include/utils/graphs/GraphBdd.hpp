@@ -0,0 +1,111 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <unordered_set>
+#include "../Edges.hpp"
+#include "../Bdd.hpp"
+#include "Graph.hpp"
+#include "../Types.hpp"
+
+namespace gracfl {
+    /**
+     * @class GraphBdd
+     * @brief A graph stored as one binary decision diagram per label over bit-encoded vertex pairs.
+     *
+     * A vertex is a k-bit number, k = ceil(log2 n), and an edge (u, v) an assignment of the source
+     * domain x to u and the target domain y to v; a third domain z holds the middle vertex of a
+     * composition. The variable order is either "interleaved" (the bits of x, y and z alternate,
+     * most significant first) or "sequential" (all bits of x, then of y, then of z). Like the
+     * other solver graphs, the relation of a label is split into old_ and delta_.
+     */
+    class GraphBdd : public Graph
+    {
+    public:
+        using Node = BddManager::Node;
+
+        std::vector<Node> old_;    ///< Edges known before the last iteration, per label
+        std::vector<Node> delta_;  ///< Edges derived by the last iteration, per label
+
+        GraphBdd(std::string& graphfilepath, const Grammar& grammar, const std::string& order = "interleaved");
+        GraphBdd(std::vector<Edge>& edges, const Grammar& grammar, const std::string& order = "interleaved");
+        ~GraphBdd();
+
+        inline BddManager& manager() { return *manager_; }
+
+        /**
+         * @brief Adds a self-loop at every vertex to the delta of label, for epsilon productions.
+         */
+        void addSelfEdges(uint label);
+
+        /**
+         * @brief The composition {(u, w) | (u, v) ∈ left, (v, w) ∈ right}, as one relational product.
+         */
+        Node compose(Node left, Node right);
+
+        /**
+         * @brief Folds the delta of label into its old edges and makes added the new delta.
+         * @param added Edges disjoint from the relation of label.
+         */
+        void merge(uint label, Node added);
+
+        /**
+         * @brief Number of edges of a relation.
+         */
+        ull countRelation(Node relation);
+
+        /**
+         * @brief Frees the dead nodes once the live ones have doubled since the last collection.
+         * @param roots Nodes in use besides the relations of the graph.
+         */
+        void collectGarbage(const std::vector<Node>& roots);
+
+        ull countEdge();
+
+        /**
+         * @brief Copies the relations into plain unordered_sets (node × label → nodes).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> toHashset();
+
+    private:
+        enum Domain : uint { X, Y, Z };
+
+        BddManager* manager_ = nullptr;
+        uint bits_ = 1;
+        bool interleaved_ = true;
+        uint yToZ_ = 0;              ///< Renaming of the target bits to the middle bits
+        uint xToZ_ = 0;              ///< Renaming of the source bits to the middle bits
+        Node zCube_ = BddManager::TRUE;
+        uint gcThreshold_ = 0;         ///< Live nodes at which collectGarbage() collects
+        std::vector<std::pair<uint, uint>> pairBits_;   ///< Source and target bits in level order, as (domain, bit)
+
+        /**
+         * @brief Level of bit (0 is the most significant) of a domain in the variable order.
+         */
+        inline uint levelOf(uint domain, uint bit) const
+        {
+            return interleaved_ ? bit * 3 + domain : domain * bits_ + bit;
+        }
+
+        void initRelations(const std::string& order);
+
+        /**
+         * @brief The bits of the edge (source, target) in level order, the first in the highest bit.
+         */
+        ull keyOf(uint source, uint target) const;
+
+        /**
+         * @brief The relation of the edges with keys[lo, hi), sorted keys sharing their first depth bits.
+         *
+         * Splits the range on key bit depth and recurses, so every edge costs one step per bit
+         * and only reduced nodes are created.
+         */
+        Node build(const std::vector<ull>& keys, size_t lo, size_t hi, uint depth);
+
+        /**
+         * @brief Values of a domain on a path of forEachPath, with every free bit expanded.
+         */
+        std::vector<uint> expand(const std::vector<int8_t>& values, uint domain) const;
+    };
+}
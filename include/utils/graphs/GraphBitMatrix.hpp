@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <unordered_set>
+#include "../Edges.hpp"
+#include "Graph.hpp"
+#include "../Types.hpp"
+
+namespace gracfl {
+    /**
+     * @brief Dense n × n boolean matrix, one bit per (row, column), rows padded to whole words.
+     *
+     * Column j of row i is bit j % 64 of word j / 64 of the row. active[i] tells whether row i
+     * has any bit set, so the kernels skip empty rows without reading them. A released matrix
+     * keeps no words and counts as all zero.
+     */
+    struct BitMatrix
+    {
+        uint rows = 0;
+        uint words = 0;                 ///< Words per row
+        std::vector<uint64_t> bits;     ///< rows × words, empty if released
+        std::vector<uint8_t> active;    ///< Row has a bit set
+        bool any = false;               ///< Some row has a bit set
+
+        void allocate(uint n)
+        {
+            rows = n;
+            words = (n + 63) / 64;
+            bits.assign(static_cast<size_t>(rows) * words, 0);
+            active.assign(rows, 0);
+            any = false;
+        }
+
+        void release()
+        {
+            std::vector<uint64_t>().swap(bits);
+            std::vector<uint8_t>().swap(active);
+            any = false;
+        }
+
+        inline bool allocated() const { return !bits.empty(); }
+        inline uint64_t* row(uint i) { return bits.data() + static_cast<size_t>(i) * words; }
+        inline const uint64_t* row(uint i) const { return bits.data() + static_cast<size_t>(i) * words; }
+        inline bool test(uint i, uint j) const { return (row(i)[j >> 6] >> (j & 63)) & 1; }
+        inline void set(uint i, uint j) { row(i)[j >> 6] |= uint64_t(1) << (j & 63); }
+    };
+
+    /**
+     * @class GraphBitMatrix
+     * @brief A graph stored as dense bit matrices per label for the bit-matrix solver.
+     *
+     * full_ holds every known edge of a label and delta_ the edges derived by the last iteration
+     * (the input edges at the start), a subset of full_. A matrix takes n² / 8 bytes, so this
+     * representation is meant for graphs of up to a few hundred thousand vertices with few labels.
+     */
+    class GraphBitMatrix : public Graph
+    {
+    public:
+        std::vector<BitMatrix> full_;   ///< All known edges, per label
+        std::vector<BitMatrix> delta_;  ///< Edges derived by the last iteration, per label
+
+        GraphBitMatrix(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        GraphBitMatrix(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Sets the input edges in full_ and delta_ of their labels.
+         */
+        void initMatrices();
+
+        /**
+         * @brief Adds a self-loop at every vertex to full_ and delta_ of label, for epsilon productions.
+         */
+        void addSelfEdges(uint label);
+
+        /**
+         * @brief Recomputes the row flags of a matrix with getNumThreads() threads.
+         */
+        void updateActive(BitMatrix& matrix);
+
+        ull countEdge();
+
+        /**
+         * @brief Bytes held by the matrices.
+         */
+        ull memoryBytes() const;
+
+        /**
+         * @brief Copies the relations into plain unordered_sets (node × label → nodes).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> toHashset();
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <unordered_set>
+#include "../Edges.hpp"
+#include "Graph.hpp"
+#include "../Types.hpp"
+#include "../SetPool.hpp"
+
+namespace gracfl {
+    /**
+     * @brief Sparse boolean matrix in CSR form, the relation of one label.
+     *
+     * Row i holds the targets of the edges from i, sorted and without duplicates. A matrix
+     * without entries keeps no row offsets at all, so labels that never occur cost nothing.
+     */
+    struct CSRMatrix
+    {
+        std::vector<ull> rowPtr;   ///< nodeSize + 1 row offsets into colIdx, empty if there are no entries
+        std::vector<uint> colIdx;  ///< Targets, sorted per row
+
+        inline ull nnz() const { return colIdx.size(); }
+        inline bool empty() const { return colIdx.empty(); }
+        inline ull rowSize(uint i) const { return rowPtr.empty() ? 0 : rowPtr[i + 1] - rowPtr[i]; }
+        /// Targets of row i, only valid if rowSize(i) > 0.
+        inline const uint* row(uint i) const { return colIdx.data() + rowPtr[i]; }
+    };
+
+    /**
+     * @class GraphCSR
+     * @brief A graph stored as one pair of CSR matrices per label for the SpGEMM solver.
+     *
+     * The relation of a label is split like the sliding pointers of the vertex lists: old_ holds
+     * the edges known before the last iteration and delta_ the edges it derived. The two are
+     * disjoint, their union is the relation. merge() folds delta_ into old_ and installs the
+     * edges of the next iteration as delta_.
+     *
+     * With shared sets, the old rows are not kept in old_ but as IDs into a SetPool, one per
+     * (label, vertex), so rows with the same neighbors (common in points-to closures) share one
+     * copy. A row that gains edges gets a new set, the one it shared is left untouched. Read old
+     * rows through oldRow()/oldRowSize(), which serve both layouts.
+     */
+    class GraphCSR : public Graph
+    {
+    public:
+        std::vector<CSRMatrix> old_;    ///< Edges known before the last iteration, per label
+        std::vector<CSRMatrix> delta_;  ///< Edges derived by the last iteration, per label
+
+        GraphCSR(std::string& graphfilepath, const Grammar& grammar, bool sharedSets = false, uint numThreads = 1);
+        GraphCSR(std::vector<Edge>& edges, const Grammar& grammar, bool sharedSets = false, uint numThreads = 1);
+
+        /**
+         * @brief Builds the input edges of every label as delta_, old_ starts empty.
+         */
+        void initMatrices();
+
+        /**
+         * @brief Adds a self-loop at every vertex to the delta of label, for epsilon productions.
+         */
+        void addSelfEdges(uint label);
+
+        /**
+         * @brief Folds the delta of label into its old edges and makes added the new delta.
+         * @param added Edges disjoint from the relation of label, rows sorted.
+         */
+        void merge(uint label, CSRMatrix&& added);
+
+        inline bool sharedSets() const { return sharedSets_; }
+        inline const SetPool& pool() const { return pool_; }
+
+        /**
+         * @brief Pool ID of the old row i of label, SetPool::EMPTY without shared sets.
+         */
+        inline uint oldSet(uint label, uint i) const
+        {
+            return oldSets_[label].empty() ? SetPool::EMPTY : oldSets_[label][i];
+        }
+
+        inline ull oldRowSize(uint label, uint i) const
+        {
+            return sharedSets_ ? pool_.get(oldSet(label, i)).size() : old_[label].rowSize(i);
+        }
+
+        /// Old targets of row i of label, only valid if oldRowSize(label, i) > 0.
+        inline const uint* oldRow(uint label, uint i) const
+        {
+            return sharedSets_ ? pool_.get(oldSet(label, i)).data() : old_[label].row(i);
+        }
+
+        ull countEdge();
+
+        /**
+         * @brief Old rows that are not empty, each counted once however many share a set.
+         */
+        ull countOldRows();
+
+        /**
+         * @brief Copies the relations into plain unordered_sets (node × label → nodes).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> toHashset();
+
+    private:
+        bool sharedSets_;
+        SetPool pool_;
+        std::vector<std::vector<uint>> oldSets_;  ///< Pool ID per vertex, per label; empty if all rows are
+
+        void mergeShared(uint label);
+    };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include "../Edges.hpp"
+#include "Graph3DOut.hpp"
+#include "../Types.hpp"
+#include "../Numa.hpp"
+
+namespace gracfl {
+    /**
+     * @class GraphHybridOut
+     * @brief Outgoing edges kept both label-partitioned (as in Graph3DOut) and as one labelled-vertex list per vertex.
+     *
+     * The label-partitioned rows and the dedup sets are those of Graph3DOut, and every edge is
+     * added through them. The labelled-vertex view (as in Graph2DOut) is appended from the rows
+     * when the pointers slide, so after slidePointers() both views hold the same edges with the
+     * same old/delta split, and a solver can run an iteration on either of them.
+     */
+    class GraphHybridOut : public Graph3DOut
+    {
+    public:
+        std::vector<TemporalVectorWithLbldVtx> lbldEdges_;  ///< Labelled-vertex view of the out-edges
+
+        GraphHybridOut(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        GraphHybridOut(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Destroys the labelled-vertex view ahead of the containers of Graph3DOut.
+         */
+        ~GraphHybridOut();
+
+        /**
+         * @brief Builds the labelled-vertex view from the rows; call once the initial and epsilon edges are added.
+         * @param delta Set to the number of delta edges per label.
+         * @param total Set to the number of edges per label.
+         */
+        void initView(std::vector<ull>& delta, std::vector<ull>& total);
+
+        /**
+         * @brief Makes the edges added since the last call the new delta of both views.
+         *
+         * Also counts, per label, the edges of the new delta and all edges, for the cost model
+         * of the solver.
+         *
+         * @param numThreads Number of OpenMP threads.
+         * @param delta Set to the number of delta edges per label.
+         * @param total Set to the number of edges per label.
+         */
+        void slidePointers(uint numThreads, std::vector<ull>& delta, std::vector<ull>& total);
+
+        void placeContainers(uint numThreads);
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <unordered_set>
+#include "../Edges.hpp"
+#include "Graph.hpp"
+#include "../Types.hpp"
+
+namespace gracfl {
+    /**
+     * @brief The edges of one label as two sorted arrays of packed keys.
+     *
+     * bySource holds COMBINE(source, target) and byTarget COMBINE(target, source), both sorted
+     * and without duplicates, so the edges of a vertex in either direction are one contiguous run.
+     */
+    struct EdgeArrays
+    {
+        std::vector<ull> bySource;  ///< COMBINE(source, target), sorted
+        std::vector<ull> byTarget;  ///< COMBINE(target, source), sorted
+
+        inline ull size() const { return bySource.size(); }
+        inline bool empty() const { return bySource.empty(); }
+    };
+
+    /**
+     * @class GraphStream
+     * @brief A graph stored as label-sorted edge arrays for the edge-centric streaming solver.
+     *
+     * Like GraphCSR, the relation of a label is split into old_, the edges known before the last
+     * iteration, and delta_, the edges it derived. Vertices are cut into 2^RADIX_BITS partitions
+     * of consecutive IDs by their high bits, so a partition is a contiguous range of every array
+     * sorted by that vertex, and arrays are sorted by a radix pass over the partitions followed by
+     * an in-cache sort of each partition.
+     */
+    class GraphStream : public Graph
+    {
+    public:
+        static constexpr uint RADIX_BITS = 8;   ///< Bits of the vertex partition
+
+        std::vector<EdgeArrays> old_;    ///< Edges known before the last iteration, per label
+        std::vector<EdgeArrays> delta_;  ///< Edges derived by the last iteration, per label
+
+        GraphStream(std::string& graphfilepath, const Grammar& grammar, uint numThreads = 1);
+        GraphStream(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads = 1);
+
+        /**
+         * @brief Builds the input edges of every label as delta_, old_ starts empty.
+         */
+        void initStreams();
+
+        /**
+         * @brief Adds a self-loop at every vertex to the delta of label, for epsilon productions.
+         */
+        void addSelfEdges(uint label);
+
+        /**
+         * @brief Folds the delta of label into its old edges and makes added the new delta.
+         * @param added Keys COMBINE(source, target), sorted and disjoint from the relation of label.
+         */
+        void merge(uint label, std::vector<ull>&& added);
+
+        inline uint numPartitions() const { return 1u << RADIX_BITS; }
+        inline uint partitionOf(uint vertex) const { return vertex >> partitionShift_; }
+
+        /**
+         * @brief Index range of the keys whose high half lies in partition p.
+         * @param keys Sorted keys.
+         */
+        std::pair<ull, ull> partitionRange(const std::vector<ull>& keys, uint p) const;
+
+        /**
+         * @brief Sorts keys by radix-partitioning them on the high half and sorting every partition.
+         */
+        void radixSort(std::vector<ull>& keys) const;
+
+        /**
+         * @brief Swaps the halves of sorted keys and sorts the result, bySource to byTarget.
+         */
+        std::vector<ull> transpose(const std::vector<ull>& keys) const;
+
+        ull countEdge();
+
+        /**
+         * @brief Copies the relations into plain unordered_sets (node × label → nodes).
+         */
+        std::vector<std::vector<std::unordered_set<ull>>> toHashset();
+
+    private:
+        uint partitionShift_ = 0;
+
+        /**
+         * @brief Scatters keys into out grouped by partition, swapping their halves if asked.
+         * @return Offset of every partition in out, numPartitions() + 1 entries.
+         */
+        std::vector<ull> partition(const std::vector<ull>& keys, std::vector<ull>& out, bool swap) const;
+
+        /**
+         * @brief Replaces into with the sorted union of into and add, merging partitions in parallel.
+         */
+        void mergeSorted(std::vector<ull>& into, const std::vector<ull>& add) const;
+    };
+}
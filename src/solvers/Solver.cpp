@@ -3,6 +3,7 @@
 #include <stdexcept>  
 #include <string> 
 #include <map> 
+#include <sstream>
 #include "solvers/Solver.hpp"
 
 namespace gracfl
@@ -11,73 +12,311 @@ namespace gracfl
     : config_(config)
     , grammar_(new Grammar(config.grammarFilepath))  
     {
-       solver_ = selectSolver();
+       // before any graph container is built
+       Arena::setHugePages(config_.hugePages == "explicit"    ? HugePages::Explicit
+                         : config_.hugePages == "transparent" ? HugePages::Transparent
+                                                              : HugePages::Off);
+       if (config_.sccContraction && config_.nodeMerging)
+       {
+            throw std::runtime_error("sccContraction and nodeMerging cannot be combined");
+       }
+       if (grammar_->hasIndexedLabels() && (config_.sccContraction || config_.nodeMerging))
+       {
+            throw std::runtime_error("sccContraction and nodeMerging do not support indexed labels");
+       }
+       if (config_.sccContraction || config_.nodeMerging)
+       {
+            std::string graphFilepath = config_.graphFilepath;
+            Graph input(graphFilepath, *grammar_);
+            if (config_.sccContraction)
+            {
+                contraction_.reset(new SCCContraction(input.getEdges(), *grammar_));
+            }
+            else
+            {
+                contraction_.reset(new EquivalenceMerging(input.getEdges(), *grammar_));
+            }
+            contraction_->printStats();
+       }
+       if (config_.vertexOrder != "none")
+       {
+            if (contraction_ != nullptr)
+            {
+                reordering_.reset(new VertexReordering(contraction_->getEdges(), *grammar_, config_.vertexOrder));
+            }
+            else
+            {
+                std::string graphFilepath = config_.graphFilepath;
+                Graph input(graphFilepath, *grammar_);
+                std::vector<Edge> edges = input.getEdges();
+                reordering_.reset(new VertexReordering(edges, *grammar_, config_.vertexOrder));
+            }
+            reordering_->printStats();
+       }
+       if (config_.executionMode == "auto" || config_.traversalDirection == "auto" ||
+           config_.processingStrategy == "auto")
+       {
+            resolveAutoSettings();
+       }
+       solver_.reset(selectSolver());
        if (solver_ == nullptr)
        {
             throw std::runtime_error("Invalid Config!");
        }
     }
 
-    Solver::~Solver()
-    {
-        delete grammar_;
-    }
+    Solver::~Solver() = default;
 
     SolverBase* Solver::selectSolver() 
     {
+        if (config_.asynchronous &&
+            (config_.executionMode == "distributed" ||
+             config_.traversalDirection != "bi" ||
+             config_.processingStrategy != "gram-driven"))
+        {
+            throw std::runtime_error("asynchronous mode supports traversalDirection = bi with processingStrategy = gram-driven in serial or parallel mode");
+        }
+        if (config_.cycleCollapsing &&
+            (config_.executionMode == "distributed" ||
+             config_.traversalDirection != "fw" ||
+             config_.processingStrategy != "gram-driven" ||
+             config_.asynchronous || config_.dyckSolver == "on"))
+        {
+            throw std::runtime_error("cycle collapsing supports traversalDirection = fw with processingStrategy = gram-driven in serial or parallel mode");
+        }
+        if (config_.stratified &&
+            (config_.executionMode != "serial" || config_.traversalDirection != "bi" ||
+             config_.processingStrategy != "gram-driven" || config_.asynchronous))
+        {
+            throw std::runtime_error("stratified evaluation supports executionMode = serial with traversalDirection = bi and processingStrategy = gram-driven");
+        }
+
+        // only the Dyck solver matches the indices of indexed labels
+        if (grammar_->hasIndexedLabels() &&
+            (!grammar_->isDyck() || config_.dyckSolver == "off" ||
+             config_.executionMode == "distributed" || config_.asynchronous || config_.cycleCollapsing ||
+             config_.stratified)) {
+            throw std::runtime_error("indexed labels require a Dyck-shaped grammar solved with dyckSolver = auto or on");
+        }
+        if (config_.dyckSolver == "on") {
+            if (!grammar_->isDyck()) {
+                throw std::runtime_error("dyckSolver = on requires a Dyck-shaped grammar");
+            }
+            return makeSolver<SolverDyck>();
+        }
+        if (config_.dyckSolver == "auto" && grammar_->isDyck() &&
+            config_.executionMode != "distributed" && !config_.asynchronous && !config_.cycleCollapsing &&
+            !config_.stratified) {
+            return makeSolver<SolverDyck>();
+        }
+
+        // the matrix products and stream joins have no traversal direction, rows or partitions are split across the threads
+        if (config_.processingStrategy == "spgemm") {
+            if (config_.executionMode == "serial") {
+                return makeSolver<SolverSpGEMM>(1u, config_.sharedSets);
+            } else if (config_.executionMode == "parallel") {
+                return makeSolver<SolverSpGEMM>(config_.numThreads, config_.sharedSets);
+            }
+        }
+        if (config_.processingStrategy == "bitmatrix") {
+            bool fourRussians = config_.bitKernel == "four-russians";
+            if (config_.executionMode == "serial") {
+                return makeSolver<SolverBitMatrix>(1u, fourRussians);
+            } else if (config_.executionMode == "parallel") {
+                return makeSolver<SolverBitMatrix>(config_.numThreads, fourRussians);
+            }
+        }
+        if (config_.processingStrategy == "stream") {
+            if (config_.executionMode == "serial") {
+                return makeSolver<SolverStream>(1u);
+            } else if (config_.executionMode == "parallel") {
+                return makeSolver<SolverStream>(config_.numThreads);
+            }
+        }
+
+        // diagram operations are sequential, the BDD solver runs serially in either mode
+        if (config_.processingStrategy == "bdd" &&
+            (config_.executionMode == "serial" || config_.executionMode == "parallel")) {
+            return makeSolver<SolverBdd>(config_.bddOrder);
+        }
+
+        // the hybrid solver switches between the fw gram- and topo-driven sweeps per iteration
+        if (config_.processingStrategy == "hybrid") {
+            if (config_.traversalDirection != "fw" || config_.executionMode == "distributed") {
+                throw std::runtime_error("processingStrategy = hybrid supports traversalDirection = fw in serial or parallel mode");
+            }
+            if (config_.executionMode == "serial") {
+                return makeSolver<SolverFWHybrid>(1u, config_.prefetchDistance);
+            } else if (config_.executionMode == "parallel") {
+                return makeSolver<SolverFWHybrid>(config_.numThreads, config_.prefetchDistance);
+            }
+        }
+
+        bool labelMajor = config_.sweepOrder == "label";
         if (config_.executionMode == "serial") {
             if (config_.traversalDirection == "fw") {
                 if (config_.processingStrategy == "gram-driven") {
-                    return new SolverFWGram(config_.graphFilepath, *grammar_);
+                    return makeSolver<SolverFWGram>(config_.prefetchDistance, config_.cycleCollapsing, labelMajor);
                 } else if (config_.processingStrategy == "topo-driven") {
-                    return new SolverFWTopo(config_.graphFilepath, *grammar_);
+                    return makeSolver<SolverFWTopo>(config_.prefetchDistance);
                 }
             }
             else if (config_.traversalDirection == "bw") {
                 if (config_.processingStrategy == "gram-driven") {
-                    return new SolverBWGram(config_.graphFilepath, *grammar_);
+                    return makeSolver<SolverBWGram>(config_.prefetchDistance, labelMajor);
                 } else if (config_.processingStrategy == "topo-driven") {
-                    return new SolverBWTopo(config_.graphFilepath, *grammar_);
+                    return makeSolver<SolverBWTopo>(config_.prefetchDistance);
                 }
             }
             else if (config_.traversalDirection == "bi") {
                 if (config_.processingStrategy == "gram-driven") {
-                    return new SolverBIGram(config_.graphFilepath, *grammar_);
+                    return makeSolver<SolverBIGram>(config_.asynchronous, config_.stratified, outputLabelIds());
                 } else if (config_.processingStrategy == "topo-driven") {
-                    return new SolverBITopo(config_.graphFilepath, *grammar_);
+                    return makeSolver<SolverBITopo>();
                 }
             }                        
         } 
         else if (config_.executionMode == "parallel") {
             if (config_.traversalDirection == "fw") {
                 if (config_.processingStrategy == "gram-driven") {
-                    return new SolverFWGramParallel(config_.graphFilepath, *grammar_, config_.numThreads);
+                    return makeSolver<SolverFWGramParallel>(config_.numThreads, config_.numaAware, config_.prefetchDistance,
+                                                            config_.cycleCollapsing, labelMajor);
                 } else if (config_.processingStrategy == "topo-driven") {
-                    return new SolverFWTopoParallel(config_.graphFilepath, *grammar_, config_.numThreads);
+                    return makeSolver<SolverFWTopoParallel>(config_.numThreads, config_.numaAware, config_.prefetchDistance);
                 }
             }
             else if (config_.traversalDirection == "bw") {
                 if (config_.processingStrategy == "gram-driven") {
-                    return new SolverBWGramParallel(config_.graphFilepath, *grammar_, config_.numThreads);
+                    return makeSolver<SolverBWGramParallel>(config_.numThreads, config_.numaAware, config_.prefetchDistance,
+                                                            labelMajor);
                 } else if (config_.processingStrategy == "topo-driven") {
-                    return new SolverBWTopoParallel(config_.graphFilepath, *grammar_, config_.numThreads);
+                    return makeSolver<SolverBWTopoParallel>(config_.numThreads, config_.numaAware, config_.prefetchDistance);
                 }
             }
             else if (config_.traversalDirection == "bi") {
                 if (config_.processingStrategy == "gram-driven") {
-                    return new SolverBIGramParallel(config_.graphFilepath, *grammar_, config_.numThreads);
+                    return makeSolver<SolverBIGramParallel>(config_.numThreads, config_.numaAware, config_.asynchronous);
                 } 
                 else if (config_.processingStrategy == "topo-driven") {
-                    return new SolverBITopoParallel(config_.graphFilepath, *grammar_, config_.numThreads);
+                    return makeSolver<SolverBITopoParallel>(config_.numThreads, config_.numaAware);
                 }
             }
         }
+        else if (config_.executionMode == "distributed") {
+#ifdef GRACFL_USE_MPI
+            if (config_.traversalDirection == "bi" && config_.processingStrategy == "gram-driven") {
+                return makeSolver<SolverBIGramDistributed>();
+            }
+            throw std::runtime_error("distributed mode supports traversalDirection = bi with processingStrategy = gram-driven");
+#else
+            throw std::runtime_error("distributed mode requires GraCFL to be built with MPI");
+#endif
+        }
         return nullptr;
     }
 
+    std::vector<uint> Solver::outputLabelIds() const
+    {
+        std::vector<uint> ids;
+        std::stringstream ss(config_.outputLabels);
+        std::string label;
+        while (std::getline(ss, label, ','))
+        {
+            label.erase(0, label.find_first_not_of(" \t"));
+            label.erase(label.find_last_not_of(" \t") + 1);
+            if (label.empty())
+            {
+                continue;
+            }
+            auto it = grammar_->getSymbolToIDMap().find(label);
+            if (it == grammar_->getSymbolToIDMap().end())
+            {
+                throw std::runtime_error("Unknown output label: " + label);
+            }
+            ids.push_back(it->second);
+        }
+        return ids;
+    }
+
+    void Solver::resolveAutoSettings()
+    {
+        std::vector<Edge> inputEdges;
+        if (contraction_ == nullptr && reordering_ == nullptr)
+        {
+            std::string graphFilepath = config_.graphFilepath;
+            Graph input(graphFilepath, *grammar_);
+            inputEdges = input.getEdges();
+        }
+        const std::vector<Edge>& edges = reordering_ ? reordering_->getEdges()
+                                       : contraction_ ? contraction_->getEdges() : inputEdges;
+
+        std::cout << "---------------------------------------" << std::endl;
+        std::cout << "Automatic Solver Selection" << std::endl;
+        std::cout << "---------------------------------------" << std::endl;
+        SolverSelector selector(edges, *grammar_, config_.numThreads);
+        selector.printStats();
+        std::vector<SolverChoice> choices = selector.rank(config_);
+        SolverChoice best = choices.front();
+        bool dyck = config_.dyckSolver == "on" ||
+                    (config_.dyckSolver == "auto" && grammar_->isDyck() &&
+                     !config_.asynchronous && !config_.cycleCollapsing && !config_.stratified);
+
+        // probes of a Dyck grammar would all run the Dyck solver
+        if (config_.calibration && choices.size() > 1 && !dyck)
+        {
+            // time the best-ranked candidates on a sample, with their output muted
+            const size_t maxProbes = 4;
+            const ull sampleEdges = 20000;
+            std::vector<Edge> sample = selector.sample(sampleEdges);
+            probeEdges_ = &sample;
+            Config original = config_;
+            double bestTime = -1;
+            for (size_t i = 0; i < choices.size() && i < maxProbes; i++)
+            {
+                config_.executionMode = choices[i].executionMode;
+                config_.traversalDirection = choices[i].traversalDirection;
+                config_.processingStrategy = choices[i].processingStrategy;
+
+                std::streambuf* out = std::cout.rdbuf(nullptr);
+                std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+                std::unique_ptr<SolverBase> probe(selectSolver());
+                probe->runCFL();
+                probe.reset();
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                std::cout.rdbuf(out);
+
+                std::cout << "Probe " << choices[i].executionMode << " " << choices[i].traversalDirection << " "
+                          << choices[i].processingStrategy << "\t= " << elapsed.count() << " seconds" << std::endl;
+                if (bestTime < 0 || elapsed.count() < bestTime)
+                {
+                    bestTime = elapsed.count();
+                    best = choices[i];
+                    best.reasons = {"fastest probe on " + std::to_string(sample.size()) + " sampled edges"};
+                }
+            }
+            config_ = original;
+            probeEdges_ = nullptr;
+        }
+
+        config_.executionMode = best.executionMode;
+        config_.traversalDirection = best.traversalDirection;
+        config_.processingStrategy = best.processingStrategy;
+        std::cout << "Selected\t= " << best.executionMode << " " << best.traversalDirection << " "
+                  << best.processingStrategy << " (estimated cost " << best.cost << ")" << std::endl;
+        for (const std::string& reason : best.reasons)
+        {
+            std::cout << "  because " << reason << std::endl;
+        }
+        if (dyck)
+        {
+            std::cout << "  (the Dyck solver takes over, see dyckSolver)" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
     void Solver::solve()
     {
-        ull initEdgeCnt = solver_->getEdgeCount();
+        ull initEdgeCnt = contraction_ ? contraction_->getInputEdgeCount() : solver_->getEdgeCount();
         std::cout << "---------------------------------------" << std::endl;
         std::cout << "Start of the CFL Reachability Analysis" << std::endl;
         std::cout << "---------------------------------------" << std::endl;
@@ -93,23 +332,54 @@ namespace gracfl
         std::cout << "End of the CFL Reachability Analysis" << std::endl;
         std::cout << "---------------------------------------" << std::endl;
 
-        ull newEdgeCnt = solver_->getEdgeCount() - initEdgeCnt;
+        ull totalEdgeCnt = contraction_ ? contraction_->expandEdgeCount(getSolverGraph()) : solver_->getEdgeCount();
+        ull newEdgeCnt = totalEdgeCnt - initEdgeCnt;
 
         std::cout << "---------------Results-----------------" << std::endl;
         std::cout << "---------------------------------------" << std::endl;
 
         std::cout << "Initial Edges\t= " << initEdgeCnt << std::endl;
-        std::cout << "New Edges\t= " << newEdgeCnt << std::endl;
+        if (config_.outputLabels.empty())
+        {
+            std::cout << "New Edges\t= " << newEdgeCnt << std::endl;
+        }
+        else
+        {
+            // the other labels were released, so the edges kept are not a superset of the input
+            std::cout << "Output Edges\t= " << totalEdgeCnt << std::endl;
+        }
         std::cout << "Total Time\t= " << elapsedSeconds.count() << " seconds" << std::endl;
+        if (config_.hugePages != "off")
+        {
+            HugePageUsage usage = getHugePageUsage();
+            double coverage = usage.residentBytes ? 100.0 * usage.hugeBytes / usage.residentBytes : 0;
+            std::cout << "Huge Pages\t= " << (usage.hugeBytes >> 20) << " of " << (usage.residentBytes >> 20)
+                      << " MiB (" << coverage << "%)" << std::endl;
+        }
 
         std::cout << "---------------END---------------------\n\n\n" << std::endl;
     }
 
-    std::vector<std::vector<std::unordered_set<ull>>> Solver::getGraph()
+    std::vector<std::vector<std::unordered_set<ull>>> Solver::getSolverGraph()
     {
+        if (reordering_ != nullptr)
+        {
+            return reordering_->restore(solver_->getGraph());
+        }
         return solver_->getGraph();
     }
 
+    std::vector<std::vector<std::unordered_set<ull>>> Solver::getGraph()
+    {
+        if (contraction_ != nullptr)
+        {
+            // the distributed solver returns an empty graph on every rank but 0
+            std::vector<std::vector<std::unordered_set<ull>>> graph = getSolverGraph();
+            return graph.empty() ? graph : contraction_->expand(graph);
+        }
+        return getSolverGraph();
+    }
+
     std::unordered_map<uint, std::string> Solver::getLabelIDToSymbolMap() const
     {
         return grammar_->getIDToSymbolMap();
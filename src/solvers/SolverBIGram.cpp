@@ -1,17 +1,28 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <sys/resource.h>
 #include "solvers/SolverBIGram.hpp"
 
 namespace gracfl 
 {
-    SolverBIGram::SolverBIGram(std::string graphfilepath, Grammar& grammar)
+    SolverBIGram::SolverBIGram(std::string graphfilepath, Grammar& grammar, bool asynchronous,
+                               bool stratified, std::vector<uint> outputLabels)
     : grammar_(grammar)
     , graph_(new Graph3DBi(graphfilepath, grammar))
+    , asynchronous_(asynchronous)
+    , stratified_(stratified)
+    , outputLabels_(std::move(outputLabels))
     {
     }
 
-    SolverBIGram::SolverBIGram(std::vector<Edge>& edges, Grammar& grammar)
+    SolverBIGram::SolverBIGram(std::vector<Edge>& edges, Grammar& grammar, bool asynchronous,
+                               bool stratified, std::vector<uint> outputLabels)
     : grammar_(grammar)
     , graph_(new Graph3DBi(edges, grammar))
+    , asynchronous_(asynchronous)
+    , stratified_(stratified)
+    , outputLabels_(std::move(outputLabels))
     {
     }
 
@@ -22,7 +33,17 @@ namespace gracfl
 
     void  SolverBIGram::runCFL()
     {
-       
+        if (asynchronous_)
+        {
+            runCFLAsync();
+            return;
+        }
+        if (stratified_)
+        {
+            runCFLStratified();
+            return;
+        }
+
         uint itr = 0;
         bool terminate;
         auto& outEdges = graph_->outEdges_;
@@ -30,7 +51,6 @@ namespace gracfl
         auto& hashset = graph_->hashset_;
         auto& grammar2index = grammar_.grammar2index_;
         auto& grammar3indexLeft  = grammar_.grammar3indexLeft_;
-        auto& grammar3indexRight = grammar_.grammar3indexRight_;
         auto labelSize = grammar_.getLabelSize();
         auto nodeSize = graph_->getNodeSize();
 
@@ -44,22 +64,261 @@ namespace gracfl
                 hashset, 
                 grammar2index,
                 grammar3indexLeft,
-                grammar3indexRight,
                 labelSize,
                 nodeSize,
                 terminate);
             std::cout << "Iteration " << itr << std::endl;
         } while(!terminate);
+
+        std::cout << "Iterations\t= " << itr << std::endl;
+        std::cout << "Derivations\t= " << derivations_ << std::endl;
     }
 
+    void SolverBIGram::runCFLAsync()
+    {
+        uint sweep = 0;
+        ull processed;
+        bool unchanged; // termination is by quiescence, the flag is not consulted
+        auto& outEdges = graph_->outEdges_;
+        auto& inEdges = graph_->inEdges_;
+        auto& grammar2index = grammar_.grammar2index_;
+        auto& grammar3indexLeft  = grammar_.grammar3indexLeft_;
+        auto& grammar3indexRight = grammar_.grammar3indexRight_;
+        auto labelSize = grammar_.getLabelSize();
+        auto nodeSize = graph_->getNodeSize();
+
+        addSelfEdges(); // add epsilon edges
+        do {
+            sweep++;
+            processed = 0;
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
+                {
+                    // Process unprocessed in-edges labeled g, including the ones derived in this sweep
+                    TemporalVector& in = inEdges[i][g];
+                    for (; in.OLD_END < in.vertexList.size(); in.OLD_END++)
+                    {
+                        uint inNbr = in.vertexList[in.OLD_END];
+
+                        // ------- Rule Type: A = B -------
+                        for (uint m = 0; m < grammar2index[g].size(); m++)
+                        {
+                            uint A = grammar2index[g][m];
+                            Edge newEdge(inNbr, i, A);
+                            graph_->checkAndAddEdge(newEdge, unchanged);
+                        }
+                        derivations_ += grammar2index[g].size();
+
+                        // ------- Rule Type: A = BC -------
+                        for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                        {
+                            uint C = grammar3indexLeft[g][m].first;
+                            uint A = grammar3indexLeft[g][m].second;
+
+                            uint END_DONE_OUT = outEdges[i][C].OLD_END;
+                            graph_->checkAndAddEdges(inNbr, A, outEdges[i][C].vertexList.data(), END_DONE_OUT, unchanged);
+                            derivations_ += END_DONE_OUT;
+                        }
+                        processed++;
+                    }
+
+                    // Process unprocessed out-edges labeled g
+                    TemporalVector& out = outEdges[i][g];
+                    for (; out.OLD_END < out.vertexList.size(); out.OLD_END++)
+                    {
+                        uint nbr = out.vertexList[out.OLD_END];
+
+                        // ------- Rule Type: A = CB -------
+                        for (uint m = 0; m < grammar3indexRight[g].size(); m++)
+                        {
+                            uint C = grammar3indexRight[g][m].first;
+                            uint A = grammar3indexRight[g][m].second;
+
+                            uint END_DONE_IN = inEdges[i][C].OLD_END;
+                            for (uint h = 0; h < END_DONE_IN; h++)
+                            {
+                                Edge newEdge(inEdges[i][C].vertexList[h], nbr, A);
+                                graph_->checkAndAddEdge(newEdge, unchanged);
+                            }
+                            derivations_ += END_DONE_IN;
+                        }
+                        processed++;
+                    }
+                }
+            }
+            std::cout << "Sweep " << sweep << " (edges processed: " << processed << ")" << std::endl;
+        } while (processed > 0);
+
+        std::cout << "Iterations\t= " << sweep << std::endl;
+        std::cout << "Derivations\t= " << derivations_ << std::endl;
+    }
+
+
+    void SolverBIGram::runCFLStratified()
+    {
+        auto& outEdges = graph_->outEdges_;
+        auto& inEdges = graph_->inEdges_;
+        auto& hashset = graph_->hashset_;
+        auto labelSize = grammar_.getLabelSize();
+        auto nodeSize = graph_->getNodeSize();
+        const auto& strata = grammar_.getStrata();
+        const auto& symbols = grammar_.getIDToSymbolMap();
+
+        // labels no output label depends on are never materialized
+        std::vector<bool> required = grammar_.requiredLabels(outputLabels_);
+        std::vector<bool> output(labelSize, outputLabels_.empty());
+        for (uint A : outputLabels_)
+        {
+            output[A] = true;
+        }
+        std::vector<bool> released(labelSize, false);
+
+        // last stratum that is solved and reads a label
+        std::vector<int> lastUse(labelSize, -1);
+        for (const auto& rule : grammar_.getRule2())
+        {
+            if (required[rule[0]])
+            {
+                lastUse[rule[1]] = std::max(lastUse[rule[1]], grammar_.getStratum(rule[0]));
+            }
+        }
+        for (const auto& rule : grammar_.getRule3())
+        {
+            if (required[rule[0]])
+            {
+                lastUse[rule[1]] = std::max(lastUse[rule[1]], grammar_.getStratum(rule[0]));
+                lastUse[rule[2]] = std::max(lastUse[rule[2]], grammar_.getStratum(rule[0]));
+            }
+        }
+        for (uint g = 0; g < labelSize; g++)
+        {
+            if (!required[g])
+            {
+                graph_->releaseLabel(g);
+                released[g] = true;
+            }
+        }
+
+        // add epsilon edges
+        for (uint i = 0; i < nodeSize; i++)
+        {
+            for (const auto& rule : grammar_.getRule1())
+            {
+                if (required[rule[0]])
+                {
+                    Edge edge(i, i, rule[0]);
+                    graph_->addSelfEdge(edge);
+                }
+            }
+        }
+
+        uint itr = 0;
+        for (uint s = 0; s < strata.size(); s++)
+        {
+            std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+            ull derivationsBefore = derivations_;
+            uint iterations = 0;
+            bool active = false;
+            for (uint A : strata[s])
+            {
+                active = active || required[A];
+            }
+
+            if (active)
+            {
+                // the rules of this stratum only, indexed like the grammar's
+                std::vector<std::vector<uint>> grammar2index(labelSize);
+                std::vector<std::vector<std::pair<uint, uint>>> grammar3indexLeft(labelSize);
+                for (const auto& rule : grammar_.getRule2())
+                {
+                    if (grammar_.getStratum(rule[0]) == (int)s)
+                    {
+                        grammar2index[rule[1]].push_back(rule[0]);
+                    }
+                }
+                for (const auto& rule : grammar_.getRule3())
+                {
+                    if (grammar_.getStratum(rule[0]) == (int)s)
+                    {
+                        grammar3indexLeft[rule[1]].emplace_back(rule[2], rule[0]);
+                    }
+                }
+
+                // earlier strata are final, but all their edges are new to the rules of this one
+                for (uint i = 0; i < nodeSize; i++)
+                {
+                    for (uint g = 0; g < labelSize; g++)
+                    {
+                        outEdges[i][g].OLD_END = 0;
+                        outEdges[i][g].NEW_END = outEdges[i][g].vertexList.size();
+                        inEdges[i][g].OLD_END = 0;
+                        inEdges[i][g].NEW_END = inEdges[i][g].vertexList.size();
+                    }
+                }
+
+                bool terminate;
+                do {
+                    iterations++;
+                    terminate = true;
+                    runSingleIteration(
+                        outEdges,
+                        inEdges,
+                        hashset,
+                        grammar2index,
+                        grammar3indexLeft,
+                        labelSize,
+                        nodeSize,
+                        terminate);
+                } while (!terminate);
+            }
+
+            // labels whose last reader is done
+            uint freed = 0;
+            for (uint g = 0; g < labelSize; g++)
+            {
+                if (!released[g] && !output[g] && lastUse[g] <= (int)s)
+                {
+                    graph_->releaseLabel(g);
+                    released[g] = true;
+                    freed++;
+                }
+            }
+
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            std::cout << "Stratum " << s << " (";
+            for (uint j = 0; j < strata[s].size(); j++)
+            {
+                std::cout << (j ? " " : "") << symbols.at(strata[s][j]);
+            }
+            std::cout << "): ";
+            if (active)
+            {
+                std::cout << iterations << " iterations, " << derivations_ - derivationsBefore << " derivations, ";
+            }
+            else
+            {
+                std::cout << "skipped, ";
+            }
+            std::cout << elapsed.count() << " seconds, " << freed << " labels released, arena "
+                      << (graph_->getArena().getReservedBytes() >> 20) << " MiB, peak RSS "
+                      << (usage.ru_maxrss >> 10) << " MiB" << std::endl;
+            itr += iterations;
+        }
+
+        std::cout << "Strata\t\t= " << strata.size() << std::endl;
+        std::cout << "Iterations\t= " << itr << std::endl;
+        std::cout << "Derivations\t= " << derivations_ << std::endl;
+    }
 
     void SolverBIGram::runSingleIteration(
         std::vector<std::vector<TemporalVector>>& outEdges,
         std::vector<std::vector<TemporalVector>>& inEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+        std::vector<std::vector<FlatHashset>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
-        std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
@@ -69,63 +328,28 @@ namespace gracfl
         {
             for (uint g = 0; g < labelSize; g++)
             {
-                uint nbr;
                 uint START_NEW = inEdges[i][g].OLD_END;
                 uint END_NEW = inEdges[i][g].NEW_END;
             
-                // Process new in-edges labeled g
+                // ------- Rule Type: A = B -------
                 for (uint j = START_NEW; j < END_NEW; j++)
                 {
                     uint inNbr = inEdges[i][g].vertexList[j];
-
-                    // ------- Rule Type: A = B -------
                     for (uint m = 0; m < grammar2index[g].size(); m++)
                     {
                         uint A = grammar2index[g][m];
                         Edge newEdge(inNbr, i, A);
                         graph_->checkAndAddEdge(newEdge, terminate);
                     }
-
-                    // ------- Rule Type: A = BC -------
-                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
-                    {
-                        uint C = grammar3indexLeft[g][m].first;
-                        uint A = grammar3indexLeft[g][m].second;
-
-                        uint START_OLD_OUT = 0;
-                        uint END_NEW_OUT = outEdges[i][C].NEW_END;
-                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint nbr = outEdges[i][C].vertexList[h];
-                            Edge newEdge(inNbr, nbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
                 }
+                derivations_ += (ull)(END_NEW - START_NEW) * grammar2index[g].size();
 
-
-                uint START_NEW_OUT = outEdges[i][g].OLD_END;
-                uint END_NEW_OUT = outEdges[i][g].NEW_END;
-                // Process new out-edges labeled g
-                for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++)
-                {   
-                    uint nbr = outEdges[i][g].vertexList[j];
-
-                    // ------- Rule Type 3: A = CB -------
-                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
-                    {
-                        uint C = grammar3indexRight[g][m].first;
-                        uint A = grammar3indexRight[g][m].second;
-
-                        uint START_OLD_IN = 0;
-                        uint END_OLD_IN = inEdges[i][C].OLD_END;
-                        for (uint h = START_OLD_IN; h < END_OLD_IN; h++)
-                        {
-                            uint inNbr = inEdges[i][C].vertexList[h];
-                            Edge newEdge(inNbr, nbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                // ------- Rule Type: A = BC, joined at i -------
+                for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                {
+                    uint C = grammar3indexLeft[g][m].first;
+                    uint A = grammar3indexLeft[g][m].second;
+                    joinAtVertex(inEdges[i][g], outEdges[i][C], A, terminate);
                 }
             }
         }
@@ -143,6 +367,30 @@ namespace gracfl
         }
     }
 
+    void SolverBIGram::joinAtVertex(TemporalVector& in, TemporalVector& out, uint A, bool& terminate)
+    {
+        uint OLD_END_IN = in.OLD_END;
+        uint NEW_END_IN = in.NEW_END;
+        uint OLD_END_OUT = out.OLD_END;
+        uint NEW_END_OUT = out.NEW_END;
+        ull newIn = NEW_END_IN - OLD_END_IN;
+        ull newOut = NEW_END_OUT - OLD_END_OUT;
+        derivations_ += newIn * NEW_END_OUT + OLD_END_IN * newOut;
+
+        // new in-edges x all out-edges
+        for (uint j = OLD_END_IN; NEW_END_OUT > 0 && j < NEW_END_IN; j++)
+        {
+            uint inNbr = in.vertexList[j];
+            graph_->checkAndAddEdges(inNbr, A, out.vertexList.data(), NEW_END_OUT, terminate);
+        }
+        // old in-edges x new out-edges
+        for (uint j = 0; newOut > 0 && j < OLD_END_IN; j++)
+        {
+            uint inNbr = in.vertexList[j];
+            graph_->checkAndAddEdges(inNbr, A, out.vertexList.data() + OLD_END_OUT, newOut, terminate);
+        }
+    }
+
     void SolverBIGram::addSelfEdges()
     {
         for (uint i = 0; i < graph_->getNodeSize(); i++)
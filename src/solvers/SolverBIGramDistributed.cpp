@@ -0,0 +1,525 @@
+#ifdef GRACFL_USE_MPI
+
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <climits>
+#include <string>
+#include <stdexcept>
+#include <mpi.h>
+#include "solvers/SolverBIGramDistributed.hpp"
+
+namespace gracfl
+{
+    static void finalizeMPI()
+    {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized)
+        {
+            MPI_Finalize();
+        }
+    }
+
+    // Initializes MPI if the embedding program did not, and finalizes it at exit.
+    static void ensureMPI(uint& rank, uint& numRanks)
+    {
+        int initialized = 0;
+        MPI_Initialized(&initialized);
+        if (!initialized)
+        {
+            MPI_Init(nullptr, nullptr);
+            std::atexit(finalizeMPI);
+        }
+
+        int r, n;
+        MPI_Comm_rank(MPI_COMM_WORLD, &r);
+        MPI_Comm_size(MPI_COMM_WORLD, &n);
+        rank = r;
+        numRanks = n;
+    }
+
+    // Aborts every rank: throwing on one rank would leave the others waiting in a collective.
+    static void abortMPI(const std::string& message)
+    {
+        std::cerr << "Error: " << message << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    static inline void putVarint(std::vector<unsigned char>& out, uint value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((unsigned char)value);
+    }
+
+    static inline uint getVarint(const unsigned char*& in)
+    {
+        uint value = 0;
+        uint shift = 0;
+        while (*in & 0x80)
+        {
+            value |= (uint)(*in++ & 0x7F) << shift;
+            shift += 7;
+        }
+        value |= (uint)(*in++) << shift;
+        return value;
+    }
+
+    // Sorts the edges by (label, from, to), drops duplicates and delta/varint encodes them.
+    static void encodeEdges(std::vector<Edge>& edges, std::vector<unsigned char>& out)
+    {
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+            if (a.label != b.label) return a.label < b.label;
+            if (a.from != b.from) return a.from < b.from;
+            return a.to < b.to;
+        });
+        edges.erase(std::unique(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+            return a.label == b.label && a.from == b.from && a.to == b.to;
+        }), edges.end());
+
+        if (edges.size() > UINT_MAX)
+        {
+            abortMPI("more than " + std::to_string(UINT_MAX) + " edges for one rank in one iteration");
+        }
+        putVarint(out, edges.size());
+        uint label = 0, from = 0, to = 0;
+        for (const Edge& edge : edges)
+        {
+            if (edge.label != label)
+            {
+                from = 0;
+                to = 0;
+            }
+            if (edge.from != from)
+            {
+                to = 0;
+            }
+            putVarint(out, edge.label - label);
+            putVarint(out, edge.from - from);
+            putVarint(out, edge.to - to);
+            label = edge.label;
+            from = edge.from;
+            to = edge.to;
+        }
+    }
+
+    static void decodeEdges(const unsigned char*& in, std::vector<Edge>& edges)
+    {
+        uint count = getVarint(in);
+        edges.resize(count);
+        uint label = 0, from = 0, to = 0;
+        for (uint k = 0; k < count; k++)
+        {
+            uint dLabel = getVarint(in);
+            if (dLabel != 0)
+            {
+                from = 0;
+                to = 0;
+            }
+            label += dLabel;
+            uint dFrom = getVarint(in);
+            if (dFrom != 0)
+            {
+                to = 0;
+            }
+            from += dFrom;
+            to += getVarint(in);
+            edges[k] = Edge(from, to, label);
+        }
+    }
+
+    SolverBIGramDistributed::SolverBIGramDistributed(std::string graphfilepath, Grammar& grammar)
+    : grammar_(grammar)
+    {
+        ensureMPI(rank_, numRanks_);
+        graph_ = new Graph3DPartition(graphfilepath, grammar, rank_, numRanks_);
+        outBuffers_.resize(numRanks_);
+        inBuffers_.resize(numRanks_);
+    }
+
+    SolverBIGramDistributed::SolverBIGramDistributed(std::vector<Edge>& edges, Grammar& grammar)
+    : grammar_(grammar)
+    {
+        ensureMPI(rank_, numRanks_);
+        graph_ = new Graph3DPartition(edges, grammar, rank_, numRanks_);
+        outBuffers_.resize(numRanks_);
+        inBuffers_.resize(numRanks_);
+    }
+
+    void SolverBIGramDistributed::setRoundBytes(size_t roundBytes)
+    {
+        if (roundBytes < 12 * (size_t)numRanks_ || roundBytes > (size_t)INT_MAX)
+        {
+            throw std::runtime_error("round size must be between 12 bytes per rank and INT_MAX bytes");
+        }
+        roundBytes_ = roundBytes;
+    }
+
+    SolverBIGramDistributed::~SolverBIGramDistributed()
+    {
+        delete graph_;
+    }
+
+    void SolverBIGramDistributed::runCFL()
+    {
+        uint itr = 0;
+        bool terminate;
+        auto& outEdges = graph_->outEdges_;
+        auto& inEdges = graph_->inEdges_;
+        auto& grammar2index = grammar_.grammar2index_;
+        auto& grammar3indexLeft  = grammar_.grammar3indexLeft_;
+        auto& grammar3indexRight = grammar_.grammar3indexRight_;
+        auto labelSize = grammar_.getLabelSize();
+        auto localNodeSize = graph_->getLocalNodeSize();
+
+        addSelfEdges(); // add epsilon edges
+        do {
+            itr++;
+            terminate = true;
+            runSingleIteration(
+                outEdges,
+                inEdges,
+                grammar2index,
+                grammar3indexLeft,
+                grammar3indexRight,
+                labelSize,
+                localNodeSize,
+                terminate);
+            exchangeEdges(terminate);
+
+            // ----------------- Update Sliding Pointers -----------------
+            for (uint i = 0; i < localNodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
+                {
+                    outEdges[i][g].OLD_END = outEdges[i][g].NEW_END;
+                    outEdges[i][g].NEW_END = outEdges[i][g].vertexList.size();
+                    inEdges[i][g].OLD_END = inEdges[i][g].NEW_END;
+                    inEdges[i][g].NEW_END = inEdges[i][g].vertexList.size();
+                }
+            }
+
+            // global termination: stop only when no rank derived a new edge
+            int localChanged = terminate ? 0 : 1;
+            int globalChanged = 0;
+            MPI_Allreduce(&localChanged, &globalChanged, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+            terminate = (globalChanged == 0);
+
+            if (rank_ == 0)
+            {
+                std::cout << "Iteration " << itr << std::endl;
+            }
+        } while(!terminate);
+
+        ull local[2] = {sentEdges_, sentBytes_};
+        ull global[2] = {0, 0};
+        MPI_Reduce(local, global, 2, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank_ == 0)
+        {
+            std::cout << "Ranks\t\t= " << numRanks_ << std::endl;
+            std::cout << "Shipped Edges\t= " << global[0] << " (" << global[1] << " bytes)" << std::endl;
+        }
+    }
+
+    void SolverBIGramDistributed::emitEdge(Edge& edge, bool& terminate)
+    {
+        if (graph_->isOwned(edge.from))
+        {
+            graph_->checkAndAddOutEdge(edge, terminate);
+        }
+        else
+        {
+            outBuffers_[graph_->owner(edge.from)].push_back(edge);
+        }
+
+        if (graph_->isOwned(edge.to))
+        {
+            graph_->checkAndAddInEdge(edge, terminate);
+        }
+        else
+        {
+            inBuffers_[graph_->owner(edge.to)].push_back(edge);
+        }
+    }
+
+    void SolverBIGramDistributed::runSingleIteration(
+        std::vector<std::vector<TemporalVector>>& outEdges,
+        std::vector<std::vector<TemporalVector>>& inEdges,
+        std::vector<std::vector<uint>>& grammar2index,
+        std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
+        std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
+        uint labelSize,
+        uint localNodeSize,
+        bool& terminate)
+    {
+        uint begin = graph_->getBegin();
+
+        // Derive new edges around every owned middle vertex
+        for (uint i = 0; i < localNodeSize; i++)
+        {
+            uint v = begin + i;
+            for (uint g = 0; g < labelSize; g++)
+            {
+                uint START_NEW = inEdges[i][g].OLD_END;
+                uint END_NEW = inEdges[i][g].NEW_END;
+
+                // Process new in-edges labeled g
+                for (uint j = START_NEW; j < END_NEW; j++)
+                {
+                    uint inNbr = inEdges[i][g].vertexList[j];
+
+                    // ------- Rule Type: A = B -------
+                    for (uint m = 0; m < grammar2index[g].size(); m++)
+                    {
+                        uint A = grammar2index[g][m];
+                        Edge newEdge(inNbr, v, A);
+                        emitEdge(newEdge, terminate);
+                    }
+
+                    // ------- Rule Type: A = BC -------
+                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                    {
+                        uint C = grammar3indexLeft[g][m].first;
+                        uint A = grammar3indexLeft[g][m].second;
+
+                        uint START_OLD_OUT = 0;
+                        uint END_NEW_OUT = outEdges[i][C].NEW_END;
+                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
+                        {
+                            uint nbr = outEdges[i][C].vertexList[h];
+                            Edge newEdge(inNbr, nbr, A);
+                            emitEdge(newEdge, terminate);
+                        }
+                    }
+                }
+
+                uint START_NEW_OUT = outEdges[i][g].OLD_END;
+                uint END_NEW_OUT = outEdges[i][g].NEW_END;
+                // Process new out-edges labeled g
+                for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++)
+                {
+                    uint nbr = outEdges[i][g].vertexList[j];
+
+                    // ------- Rule Type 3: A = CB -------
+                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
+                    {
+                        uint C = grammar3indexRight[g][m].first;
+                        uint A = grammar3indexRight[g][m].second;
+
+                        uint START_OLD_IN = 0;
+                        uint END_OLD_IN = inEdges[i][C].OLD_END;
+                        for (uint h = START_OLD_IN; h < END_OLD_IN; h++)
+                        {
+                            uint inNbr = inEdges[i][C].vertexList[h];
+                            Edge newEdge(inNbr, nbr, A);
+                            emitEdge(newEdge, terminate);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void SolverBIGramDistributed::exchangeEdges(bool& terminate)
+    {
+        // ------- Pack one compressed message per destination rank -------
+        std::vector<unsigned char> sendBuffer;
+        std::vector<size_t> sendStarts(numRanks_, 0);
+        std::vector<unsigned long long> sendSizes(numRanks_, 0);
+        for (uint r = 0; r < numRanks_; r++)
+        {
+            size_t start = sendBuffer.size();
+            sentEdges_ += outBuffers_[r].size() + inBuffers_[r].size();
+            if (r != rank_)
+            {
+                encodeEdges(outBuffers_[r], sendBuffer);
+                encodeEdges(inBuffers_[r], sendBuffer);
+            }
+            outBuffers_[r].clear();
+            inBuffers_[r].clear();
+            sendStarts[r] = start;
+            sendSizes[r] = sendBuffer.size() - start;
+        }
+        sentBytes_ += sendBuffer.size();
+
+        // ------- Exchange message sizes, then the messages in rounds -------
+        std::vector<unsigned long long> recvSizes(numRanks_, 0);
+        MPI_Alltoall(sendSizes.data(), 1, MPI_UNSIGNED_LONG_LONG, recvSizes.data(), 1, MPI_UNSIGNED_LONG_LONG,
+                     MPI_COMM_WORLD);
+        size_t perRank = roundBytes_ / numRanks_;
+        unsigned long long localRounds = 0;
+        for (uint r = 0; r < numRanks_; r++)
+        {
+            localRounds = std::max(localRounds, (sendSizes[r] + perRank - 1) / perRank);
+        }
+        unsigned long long rounds = 0;
+        MPI_Allreduce(&localRounds, &rounds, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+
+        std::vector<std::vector<unsigned char>> messages(numRanks_);
+        for (uint r = 0; r < numRanks_; r++)
+        {
+            messages[r].reserve(recvSizes[r]);
+        }
+        std::vector<int> sendCounts(numRanks_, 0);
+        std::vector<int> sendDispls(numRanks_, 0);
+        std::vector<int> recvCounts(numRanks_, 0);
+        std::vector<int> recvDispls(numRanks_, 0);
+        std::vector<unsigned char> sendRound;
+        std::vector<unsigned char> recvRound;
+        for (unsigned long long round = 0; round < rounds; round++)
+        {
+            // every count is at most perRank and every total at most roundBytes_, so all fit in an int
+            size_t offset = round * perRank;
+            sendRound.clear();
+            int recvTotal = 0;
+            for (uint r = 0; r < numRanks_; r++)
+            {
+                size_t sendCount = sendSizes[r] > offset ? std::min<size_t>(perRank, sendSizes[r] - offset) : 0;
+                size_t recvCount = recvSizes[r] > offset ? std::min<size_t>(perRank, recvSizes[r] - offset) : 0;
+                sendDispls[r] = sendRound.size();
+                sendCounts[r] = sendCount;
+                const unsigned char* chunk = sendBuffer.data() + sendStarts[r] + offset;
+                sendRound.insert(sendRound.end(), chunk, chunk + sendCount);
+                recvDispls[r] = recvTotal;
+                recvCounts[r] = recvCount;
+                recvTotal += recvCount;
+            }
+            recvRound.resize(recvTotal);
+            MPI_Alltoallv(sendRound.data(), sendCounts.data(), sendDispls.data(), MPI_UNSIGNED_CHAR,
+                          recvRound.data(), recvCounts.data(), recvDispls.data(), MPI_UNSIGNED_CHAR,
+                          MPI_COMM_WORLD);
+            for (uint r = 0; r < numRanks_; r++)
+            {
+                messages[r].insert(messages[r].end(), recvRound.begin() + recvDispls[r],
+                                   recvRound.begin() + recvDispls[r] + recvCounts[r]);
+            }
+        }
+
+        // ------- Apply the received edges -------
+        std::vector<Edge> edges;
+        for (uint r = 0; r < numRanks_; r++)
+        {
+            if (messages[r].empty())
+            {
+                continue;
+            }
+            const unsigned char* in = messages[r].data();
+            decodeEdges(in, edges);
+            for (Edge& edge : edges)
+            {
+                graph_->checkAndAddOutEdge(edge, terminate);
+            }
+            decodeEdges(in, edges);
+            for (Edge& edge : edges)
+            {
+                graph_->checkAndAddInEdge(edge, terminate);
+            }
+        }
+    }
+
+    void SolverBIGramDistributed::addSelfEdges()
+    {
+        for (uint i = 0; i < graph_->getLocalNodeSize(); i++)
+        {
+            uint v = graph_->getBegin() + i;
+            for (uint l = 0; l < grammar_.getRule1().size(); l++)
+            {
+                Edge edge(v, v, grammar_.grammar1_[l][0]);
+                graph_->addSelfEdge(edge);
+            }
+        }
+    }
+
+    ull SolverBIGramDistributed::getEdgeCount()
+    {
+        ull local = graph_->countEdge();
+        ull global = 0;
+        MPI_Allreduce(&local, &global, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        return global;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> SolverBIGramDistributed::getLocalGraph()
+    {
+        auto& outHashset = graph_->getOutHashset();
+        std::vector<std::vector<std::unordered_set<ull>>> result(
+            outHashset.size(), std::vector<std::unordered_set<ull>>(grammar_.getLabelSize()));
+        for (uint i = 0; i < outHashset.size(); i++)
+        {
+            for (uint g = 0; g < outHashset[i].size(); g++)
+            {
+                for (ull to : outHashset[i][g])
+                {
+                    result[i][g].insert(to);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> SolverBIGramDistributed::getGraph()
+    {
+        // (from, to, label) triples per message; a shorter message is the last one of a rank
+        const size_t chunkSize = roundBytes_ / sizeof(uint) / 3 * 3;
+        auto& outHashset = graph_->getOutHashset();
+
+        if (rank_ != 0)
+        {
+            std::vector<uint> chunk;
+            for (uint i = 0; i < outHashset.size(); i++)
+            {
+                for (uint g = 0; g < outHashset[i].size(); g++)
+                {
+                    for (ull to : outHashset[i][g])
+                    {
+                        chunk.push_back(graph_->getBegin() + i);
+                        chunk.push_back(to);
+                        chunk.push_back(g);
+                        if (chunk.size() == chunkSize)
+                        {
+                            MPI_Send(chunk.data(), chunk.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD);
+                            chunk.clear();
+                        }
+                    }
+                }
+            }
+            MPI_Send(chunk.data(), chunk.size(), MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD);
+            return {};
+        }
+
+        std::vector<std::vector<std::unordered_set<ull>>> result(
+            graph_->getNodeSize(), std::vector<std::unordered_set<ull>>(grammar_.getLabelSize()));
+        for (uint i = 0; i < outHashset.size(); i++)
+        {
+            for (uint g = 0; g < outHashset[i].size(); g++)
+            {
+                for (ull to : outHashset[i][g])
+                {
+                    result[graph_->getBegin() + i][g].insert(to);
+                }
+            }
+        }
+        std::vector<uint> chunk;
+        for (uint r = 1; r < numRanks_; r++)
+        {
+            int count;
+            do {
+                MPI_Status status;
+                MPI_Probe(r, 0, MPI_COMM_WORLD, &status);
+                MPI_Get_count(&status, MPI_UNSIGNED, &count);
+                chunk.resize(count);
+                MPI_Recv(chunk.data(), count, MPI_UNSIGNED, r, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                for (int k = 0; k < count; k += 3)
+                {
+                    result[chunk[k]][chunk[k + 2]].insert(chunk[k + 1]);
+                }
+            } while ((size_t)count == chunkSize);
+        }
+        return result;
+    }
+}
+
+#endif // GRACFL_USE_MPI
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <deque>
 #include "solvers/SolverBIGramParallel.hpp"
 
 namespace gracfl 
@@ -28,18 +29,41 @@ namespace gracfl
         return result;
     }
 
-    SolverBIGramParallel::SolverBIGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
+    static constexpr uint NUM_LIST_LOCKS = 1 << 16;   // stripes of the per-list append locks
+    static constexpr uint ASYNC_BATCH = 64;            // edges taken from the local queue at once
+
+    /// Work queue of one thread in asynchronous mode.
+    struct alignas(64) WorkQueue
+    {
+        std::deque<Edge> edges;
+        std::atomic<bool> lock{false};
+
+        void acquire() { while (lock.exchange(true, std::memory_order_acquire)) {} }
+        void release() { lock.store(false, std::memory_order_release); }
+    };
+
+    SolverBIGramParallel::SolverBIGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware, bool asynchronous)
     : grammar_(grammar)
-    , graph_(new Graph3DBiConcurrent(graphfilepath, grammar))
+    , graph_(new Graph3DBiConcurrent(graphfilepath, grammar, numOfThreads))
+    , asynchronous_(asynchronous)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
-    SolverBIGramParallel::SolverBIGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
+    SolverBIGramParallel::SolverBIGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware, bool asynchronous)
     : grammar_(grammar)
-    , graph_(new Graph3DBiConcurrent(edges, grammar))
+    , graph_(new Graph3DBiConcurrent(edges, grammar, numOfThreads))
+    , asynchronous_(asynchronous)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
     SolverBIGramParallel::~SolverBIGramParallel()
@@ -51,7 +75,12 @@ namespace gracfl
 
     void  SolverBIGramParallel::runCFL()
     {
-       
+        if (asynchronous_)
+        {
+            runCFLAsync();
+            return;
+        }
+
         uint itr = 0;
         bool terminate;
         auto& outEdges = graph_->outEdges_;
@@ -59,7 +88,6 @@ namespace gracfl
         auto& hashset = graph_->hashset_;
         auto& grammar2index = grammar_.grammar2index_;
         auto& grammar3indexLeft  = grammar_.grammar3indexLeft_;
-        auto& grammar3indexRight = grammar_.grammar3indexRight_;
         auto labelSize = grammar_.getLabelSize();
         auto nodeSize = graph_->getNodeSize();
 
@@ -73,12 +101,189 @@ namespace gracfl
                 hashset, 
                 grammar2index,
                 grammar3indexLeft,
-                grammar3indexRight,
                 labelSize,
                 nodeSize,
                 terminate);
             std::cout << "Iteration " << itr << std::endl;
         } while(!terminate);
+
+        std::cout << "Iterations\t= " << itr << std::endl;
+        std::cout << "Derivations\t= " << derivations_ << std::endl;
+    }
+
+    void SolverBIGramParallel::runCFLAsync()
+    {
+        auto& outEdges = graph_->outEdges_;
+        auto labelSize = grammar_.getLabelSize();
+        auto nodeSize = graph_->getNodeSize();
+        uint numThreads = numOfThreads_;
+        std::vector<WorkQueue> queues(numThreads);
+        std::atomic<ull> pending(0); // edges queued or being processed
+        ull processed = 0;
+        ull derivations = 0;
+        ull steals = 0;
+
+        addSelfEdges(); // add epsilon edges
+        std::vector<std::atomic<bool>>(NUM_LIST_LOCKS).swap(listLocks_);
+
+        #pragma omp parallel num_threads(numThreads) reduction(+:processed, derivations, steals)
+        {
+            uint tid = omp_get_thread_num();
+            WorkQueue& local = queues[tid];
+            std::vector<Edge> batch;
+            std::vector<Edge> derived;
+
+            // Seed the queue with the edges of the vertices this thread owns in the synchronous mode
+            #pragma omp for schedule(static, 512) nowait
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
+                {
+                    for (uint h = 0; h < outEdges[i][g].NEW_END; h++)
+                    {
+                        local.edges.emplace_back(i, outEdges[i][g].vertexList[h], g);
+                    }
+                }
+            }
+            pending.fetch_add(local.edges.size());
+            #pragma omp barrier
+
+            while (true)
+            {
+                // take a batch from the back of the local queue, else steal half of another queue from the front
+                local.acquire();
+                for (uint k = 0; k < ASYNC_BATCH && !local.edges.empty(); k++)
+                {
+                    batch.push_back(local.edges.back());
+                    local.edges.pop_back();
+                }
+                local.release();
+                for (uint v = 1; batch.empty() && v < numThreads; v++)
+                {
+                    WorkQueue& victim = queues[(tid + v) % numThreads];
+                    victim.acquire();
+                    size_t take = (victim.edges.size() + 1) / 2;
+                    for (size_t k = 0; k < take; k++)
+                    {
+                        batch.push_back(victim.edges.front());
+                        victim.edges.pop_front();
+                    }
+                    victim.release();
+                    steals += (take > 0);
+                }
+
+                if (batch.empty())
+                {
+                    // quiescence: nothing queued anywhere and nobody can derive more
+                    if (pending.load() == 0)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+
+                for (const Edge& edge : batch)
+                {
+                    processEdgeAsync(edge, derived, derivations);
+                }
+                processed += batch.size();
+
+                if (!derived.empty())
+                {
+                    pending.fetch_add(derived.size());
+                    local.acquire();
+                    local.edges.insert(local.edges.end(), derived.begin(), derived.end());
+                    local.release();
+                    derived.clear();
+                }
+                pending.fetch_sub(batch.size());
+                batch.clear();
+            }
+        }
+
+        derivations_ = derivations;
+        std::cout << "Edges Processed\t= " << processed << std::endl;
+        std::cout << "Steals\t\t= " << steals << std::endl;
+        std::cout << "Derivations\t= " << derivations_ << std::endl;
+    }
+
+    void SolverBIGramParallel::processEdgeAsync(const Edge& edge, std::vector<Edge>& derived, ull& derivations)
+    {
+        auto& outEdges = graph_->outEdges_;
+        auto& inEdges = graph_->inEdges_;
+        auto& grammar2index = grammar_.grammar2index_;
+        auto& grammar3indexLeft  = grammar_.grammar3indexLeft_;
+        auto& grammar3indexRight = grammar_.grammar3indexRight_;
+        uint u = edge.from;
+        uint v = edge.to;
+        uint B = edge.label;
+
+        // ------- Rule Type: A = B -------
+        for (uint m = 0; m < grammar2index[B].size(); m++)
+        {
+            Edge newEdge(u, v, grammar2index[B][m]);
+            if (addEdgeAsync(newEdge))
+            {
+                derived.push_back(newEdge);
+            }
+        }
+        derivations += grammar2index[B].size();
+
+        // ------- Rule Type: A = BC, joined at v -------
+        for (uint m = 0; m < grammar3indexLeft[B].size(); m++)
+        {
+            uint C = grammar3indexLeft[B][m].first;
+            uint A = grammar3indexLeft[B][m].second;
+            TemporalVectorConcurrent& out = outEdges[v][C];
+            uint END_OUT = __atomic_load_n(&out.NEW_END, __ATOMIC_SEQ_CST);
+            for (uint h = 0; h < END_OUT; h++)
+            {
+                Edge newEdge(u, out.vertexList[h], A);
+                if (addEdgeAsync(newEdge))
+                {
+                    derived.push_back(newEdge);
+                }
+            }
+            derivations += END_OUT;
+        }
+
+        // ------- Rule Type: A = CB, joined at u -------
+        for (uint m = 0; m < grammar3indexRight[B].size(); m++)
+        {
+            uint C = grammar3indexRight[B][m].first;
+            uint A = grammar3indexRight[B][m].second;
+            TemporalVectorConcurrent& in = inEdges[u][C];
+            uint END_IN = __atomic_load_n(&in.NEW_END, __ATOMIC_SEQ_CST);
+            for (uint h = 0; h < END_IN; h++)
+            {
+                Edge newEdge(in.vertexList[h], v, A);
+                if (addEdgeAsync(newEdge))
+                {
+                    derived.push_back(newEdge);
+                }
+            }
+            derivations += END_IN;
+        }
+    }
+
+    bool SolverBIGramParallel::addEdgeAsync(const Edge& edge)
+    {
+        if (!graph_->hashset_[edge.from][edge.label].insert(edge.to).second)
+        {
+            return false;
+        }
+
+        TemporalVectorConcurrent* lists[2] = {&graph_->outEdges_[edge.from][edge.label], &graph_->inEdges_[edge.to][edge.label]};
+        uint vertices[2] = {edge.to, edge.from};
+        for (uint k = 0; k < 2; k++)
+        {
+            std::atomic<bool>& lock = listLocks_[(reinterpret_cast<uintptr_t>(lists[k]) / sizeof(TemporalVectorConcurrent)) % NUM_LIST_LOCKS];
+            while (lock.exchange(true, std::memory_order_acquire)) {}
+            lists[k]->vertexList.push_back(vertices[k]);
+            __atomic_store_n(&lists[k]->NEW_END, (uint)lists[k]->vertexList.size(), __ATOMIC_SEQ_CST);
+            lock.store(false, std::memory_order_release);
+        }
+        return true;
     }
 
 
@@ -88,78 +293,46 @@ namespace gracfl
         std::vector<std::vector<tbb::concurrent_unordered_set<ull>>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
-        std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
     {
+        ull derivations = 0;
+
         // Derive new edges based on grammar rules 
-        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
+        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:derivations)
         for (uint i = 0; i < nodeSize; i++)
         {
             for (uint g = 0; g < labelSize; g++)
             {
-                uint nbr;
                 uint START_NEW = inEdges[i][g].OLD_END;
                 uint END_NEW = inEdges[i][g].NEW_END;
             
-                // Process new in-edges labeled g
+                // ------- Rule Type: A = B -------
                 for (uint j = START_NEW; j < END_NEW; j++)
                 {
                     uint inNbr = inEdges[i][g].vertexList[j];
-
-                    // ------- Rule Type: A = B -------
                     for (uint m = 0; m < grammar2index[g].size(); m++)
                     {
                         uint A = grammar2index[g][m];
                         Edge newEdge(inNbr, i, A);
                         graph_->checkAndAddEdge(newEdge, terminate);
                     }
-
-                    // ------- Rule Type: A = BC -------
-                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
-                    {
-                        uint C = grammar3indexLeft[g][m].first;
-                        uint A = grammar3indexLeft[g][m].second;
-
-                        uint START_OLD_OUT = 0;
-                        uint END_NEW_OUT = outEdges[i][C].NEW_END;
-                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint nbr = outEdges[i][C].vertexList[h];
-                            Edge newEdge(inNbr, nbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
                 }
+                derivations += (ull)(END_NEW - START_NEW) * grammar2index[g].size();
 
-
-                uint START_NEW_OUT = outEdges[i][g].OLD_END;
-                uint END_NEW_OUT = outEdges[i][g].NEW_END;
-                // Process new out-edges labeled g
-                for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++)
-                {   
-                    uint nbr = outEdges[i][g].vertexList[j];
-
-                    // ------- Rule Type 3: A = CB -------
-                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
-                    {
-                        uint C = grammar3indexRight[g][m].first;
-                        uint A = grammar3indexRight[g][m].second;
-
-                        uint START_OLD_IN = 0;
-                        uint END_OLD_IN = inEdges[i][C].OLD_END;
-                        for (uint h = START_OLD_IN; h < END_OLD_IN; h++)
-                        {
-                            uint inNbr = inEdges[i][C].vertexList[h];
-                            Edge newEdge(inNbr, nbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                // ------- Rule Type: A = BC, joined at i -------
+                for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                {
+                    uint C = grammar3indexLeft[g][m].first;
+                    uint A = grammar3indexLeft[g][m].second;
+                    joinAtVertex(inEdges[i][g], outEdges[i][C], A, terminate, derivations);
                 }
             }
         }
 
+        derivations_ += derivations;
+
         // Update sliding pointers for next iteration
         #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
         for (uint i = 0; i < nodeSize; i++)
@@ -174,6 +347,43 @@ namespace gracfl
         }
     }
 
+    void SolverBIGramParallel::joinAtVertex(
+        TemporalVectorConcurrent& in,
+        TemporalVectorConcurrent& out,
+        uint A,
+        bool& terminate,
+        ull& derivations)
+    {
+        uint OLD_END_IN = in.OLD_END;
+        uint NEW_END_IN = in.NEW_END;
+        uint OLD_END_OUT = out.OLD_END;
+        uint NEW_END_OUT = out.NEW_END;
+        ull newIn = NEW_END_IN - OLD_END_IN;
+        ull newOut = NEW_END_OUT - OLD_END_OUT;
+        derivations += newIn * NEW_END_OUT + OLD_END_IN * newOut;
+
+        // new in-edges x all out-edges
+        for (uint j = OLD_END_IN; NEW_END_OUT > 0 && j < NEW_END_IN; j++)
+        {
+            uint inNbr = in.vertexList[j];
+            for (uint h = 0; h < NEW_END_OUT; h++)
+            {
+                Edge newEdge(inNbr, out.vertexList[h], A);
+                graph_->checkAndAddEdge(newEdge, terminate);
+            }
+        }
+        // old in-edges x new out-edges
+        for (uint j = 0; newOut > 0 && j < OLD_END_IN; j++)
+        {
+            uint inNbr = in.vertexList[j];
+            for (uint h = OLD_END_OUT; h < NEW_END_OUT; h++)
+            {
+                Edge newEdge(inNbr, out.vertexList[h], A);
+                graph_->checkAndAddEdge(newEdge, terminate);
+            }
+        }
+    }
+
     void SolverBIGramParallel::addSelfEdges()
     {
         #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
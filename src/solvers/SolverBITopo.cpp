@@ -53,7 +53,7 @@ namespace gracfl
     void SolverBITopo::runSingleIteration(
         std::vector<TemporalVectorWithLbldVtx>& outEdges,
         std::vector<TemporalVectorWithLbldVtx>& inEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+        std::vector<std::vector<FlatHashset>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<uint>>& grammar3index,
         uint labelSize,
@@ -27,18 +27,26 @@ namespace gracfl
         return result;
     }
 
-    SolverBITopoParallel::SolverBITopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
+    SolverBITopoParallel::SolverBITopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware)
     : grammar_(grammar)
-    , graph_(new Graph2DBiConcurrent(graphfilepath, grammar))
+    , graph_(new Graph2DBiConcurrent(graphfilepath, grammar, numOfThreads))
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
-    SolverBITopoParallel::SolverBITopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
+    SolverBITopoParallel::SolverBITopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware)
     : grammar_(grammar)
-    , graph_(new Graph2DBiConcurrent(edges, grammar))
+    , graph_(new Graph2DBiConcurrent(edges, grammar, numOfThreads))
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
     SolverBITopoParallel::~SolverBITopoParallel()
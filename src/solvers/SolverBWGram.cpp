@@ -3,15 +3,19 @@
 
 namespace gracfl 
 {
-    SolverBWGram::SolverBWGram(std::string graphfilepath, Grammar& grammar)
+    SolverBWGram::SolverBWGram(std::string graphfilepath, Grammar& grammar, uint prefetchDistance, bool labelMajor, uint numOfThreads)
     : grammar_(grammar)
-    , graph_(new Graph3DIn(graphfilepath, grammar))
+    , graph_(new Graph3DIn(graphfilepath, grammar, numOfThreads))
+    , prefetchDistance_(prefetchDistance)
+    , labelMajor_(labelMajor)
     {
     }
 
-    SolverBWGram::SolverBWGram(std::vector<Edge>& edges, Grammar& grammar)
+    SolverBWGram::SolverBWGram(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance, bool labelMajor, uint numOfThreads)
     : grammar_(grammar)
-    , graph_(new Graph3DIn(edges, grammar))
+    , graph_(new Graph3DIn(edges, grammar, numOfThreads))
+    , prefetchDistance_(prefetchDistance)
+    , labelMajor_(labelMajor)
     {
     }
 
@@ -49,7 +53,7 @@ namespace gracfl
 
     void  SolverBWGram::runSingleIteration(
         std::vector<std::vector<TemporalVector>>& inEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+        std::vector<std::vector<FlatHashset>>& inHashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
         uint labelSize,
@@ -57,63 +61,79 @@ namespace gracfl
         bool& terminate
     )
     {
-        for (uint i = 0; i < nodeSize; i++)
+        // joins the edges of label g at vertex i with the rows they reach
+        auto joinRow = [&](uint i, uint g)
         {
-            for (uint g = 0; g < labelSize; g++)
+            uint inNbr1;
+            uint START_NEW = inEdges[i][g].OLD_END;
+            uint END_NEW = inEdges[i][g].NEW_END;
+
+            for (uint j = START_NEW; j < END_NEW; j++)
+            {
+                prefetch::joinLists(inEdges, inEdges[i][g].vertexList.data(), j, END_NEW,
+                                    grammar3indexRight[g], prefetchDistance_, false);
+                inNbr1 = inEdges[i][g].vertexList[j];
+                
+                for (uint m = 0; m < grammar2index[g].size(); m++)
+                {
+                    uint A = grammar2index[g][m];
+                    Edge newEdge(inNbr1, i, A);
+                    graph_->checkAndAddEdge(newEdge, terminate);
+                }
+
+                for (uint m = 0; m < grammar3indexRight[g].size(); m++)
+                {
+                    uint B = grammar3indexRight[g][m].first;
+                    uint A = grammar3indexRight[g][m].second;
+
+                    uint START_OLD_OUT = 0;
+                    uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
+                    graph_->checkAndAddEdges(i, A, inEdges[inNbr1][B].vertexList.data() + START_OLD_OUT,
+                                             END_NEW_OUT - START_OLD_OUT, terminate);
+                }
+            }
+
+            uint START_OLD = 0;
+            uint END_OLD = inEdges[i][g].OLD_END;
+            for (uint j = START_OLD; j < END_OLD; j++)
             {
-                uint inNbr1;
-                uint START_NEW = inEdges[i][g].OLD_END;
-                uint END_NEW = inEdges[i][g].NEW_END;
+                prefetch::joinLists(inEdges, inEdges[i][g].vertexList.data(), j, END_OLD,
+                                    grammar3indexRight[g], prefetchDistance_, true);
+                inNbr1 = inEdges[i][g].vertexList[j];
 
-                for (uint j = START_NEW; j < END_NEW; j++)
+                for (uint m = 0; m < grammar3indexRight[g].size(); m++)
                 {
-                    inNbr1 = inEdges[i][g].vertexList[j];
-                    
-                    for (uint m = 0; m < grammar2index[g].size(); m++)
-                    {
-                        uint A = grammar2index[g][m];
-                        Edge newEdge(inNbr1, i, A);
-                        graph_->checkAndAddEdge(newEdge, terminate);
-                    }
-
-                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
-                    {
-                        uint B = grammar3indexRight[g][m].first;
-                        uint A = grammar3indexRight[g][m].second;
-
-                        uint START_OLD_OUT = 0;
-                        uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
-                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint inNbr2 = inEdges[inNbr1][B].vertexList[h];
-                            Edge newEdge(inNbr2, i, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    // C = g
+                    uint B = grammar3indexRight[g][m].first;
+                    uint A = grammar3indexRight[g][m].second;
+
+                    uint START_NEW_OUT = inEdges[inNbr1][B].OLD_END;
+                    uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
+                    graph_->checkAndAddEdges(i, A, inEdges[inNbr1][B].vertexList.data() + START_NEW_OUT,
+                                             END_NEW_OUT - START_NEW_OUT, terminate);
                 }
+            }
+        };
 
-                uint START_OLD = 0;
-                uint END_OLD = inEdges[i][g].OLD_END;
-                for (uint j = START_OLD; j < END_OLD; j++)
+        if (labelMajor_)
+        {
+            // one label at a time: its productions and the rows they reach stay in cache
+            for (uint g = 0; g < labelSize; g++)
+            {
+                if (grammar2index[g].empty() && grammar3indexRight[g].empty()) continue;
+                for (uint i = 0; i < nodeSize; i++)
+                {
+                    joinRow(i, g);
+                }
+            }
+        }
+        else
+        {
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
                 {
-                    inNbr1 = inEdges[i][g].vertexList[j];
-
-                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
-                    {
-                        // C = g
-                        uint B = grammar3indexRight[g][m].first;
-                        uint A = grammar3indexRight[g][m].second;
-
-                        uint START_NEW_OUT = inEdges[inNbr1][B].OLD_END;
-                        uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
-
-                        for (uint h = START_NEW_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint inNbr2 = inEdges[inNbr1][B].vertexList[h];
-                            Edge newEdge(inNbr2, i, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    joinRow(i, g);
                 }
             }
         }
@@ -3,16 +3,26 @@
 
 namespace gracfl 
 {
-    SolverBWGramParallel::SolverBWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
-    : SolverBWGram(graphfilepath, grammar)
+    SolverBWGramParallel::SolverBWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance,
+                                               bool labelMajor)
+    : SolverBWGram(graphfilepath, grammar, prefetchDistance, labelMajor, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
-    SolverBWGramParallel::SolverBWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
-    : SolverBWGram(edges, grammar)
+    SolverBWGramParallel::SolverBWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance,
+                                               bool labelMajor)
+    : SolverBWGram(edges, grammar, prefetchDistance, labelMajor, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
     void  SolverBWGramParallel::runCFL()
@@ -45,75 +55,108 @@ namespace gracfl
 
     void SolverBWGramParallel::runSingleIterationParallel(
         std::vector<std::vector<TemporalVector>>& inEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+        std::vector<std::vector<FlatHashset>>& inHashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexRight,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
     {
-        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
-        for (uint i = 0; i < nodeSize; i++)
+        // new edges are staged per thread and appended once all threads are done
+        graph_->beginStaging(numOfThreads_);
+        // joins the edges of label g at vertex i with the rows they reach, returns the edges staged
+        auto joinRow = [&](uint i, uint g) -> ull
         {
-            for (uint g = 0; g < labelSize; g++)
-            {
-                uint inNbr1;
-                uint START_NEW = inEdges[i][g].OLD_END;
-                uint END_NEW = inEdges[i][g].NEW_END;
+            ull staged = 0;
+            uint inNbr1;
+            uint START_NEW = inEdges[i][g].OLD_END;
+            uint END_NEW = inEdges[i][g].NEW_END;
 
-                for (uint j = START_NEW; j < END_NEW; j++)
+            for (uint j = START_NEW; j < END_NEW; j++)
+            {
+                prefetch::joinLists(inEdges, inEdges[i][g].vertexList.data(), j, END_NEW,
+                                    grammar3indexRight[g], prefetchDistance_, false);
+                inNbr1 = inEdges[i][g].vertexList[j];
+                
+                for (uint m = 0; m < grammar2index[g].size(); m++)
                 {
-                    inNbr1 = inEdges[i][g].vertexList[j];
-                    
-                    for (uint m = 0; m < grammar2index[g].size(); m++)
-                    {
-                        uint A = grammar2index[g][m];
-                        Edge newEdge(inNbr1, i, A);
-                        graph_->checkAndAddEdge(newEdge, terminate);
-                    }
+                    uint A = grammar2index[g][m];
+                    Edge newEdge(inNbr1, i, A);
+                    staged += graph_->stageEdge(newEdge);
+                }
 
-                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
-                    {
-                        uint B = grammar3indexRight[g][m].first;
-                        uint A = grammar3indexRight[g][m].second;
+                for (uint m = 0; m < grammar3indexRight[g].size(); m++)
+                {
+                    uint B = grammar3indexRight[g][m].first;
+                    uint A = grammar3indexRight[g][m].second;
 
-                        uint START_OLD_OUT = 0;
-                        uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
-                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint inNbr2 = inEdges[inNbr1][B].vertexList[h];
-                            Edge newEdge(inNbr2, i, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    uint START_OLD_OUT = 0;
+                    uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
+                    staged += graph_->stageEdges(i, A, inEdges[inNbr1][B].vertexList.data() + START_OLD_OUT,
+                                                 END_NEW_OUT - START_OLD_OUT);
                 }
+            }
 
-                uint START_OLD = 0;
-                uint END_OLD = inEdges[i][g].OLD_END;
-                for (uint j = START_OLD; j < END_OLD; j++)
-                {
-                    inNbr1 = inEdges[i][g].vertexList[j];
+            uint START_OLD = 0;
+            uint END_OLD = inEdges[i][g].OLD_END;
+            for (uint j = START_OLD; j < END_OLD; j++)
+            {
+                prefetch::joinLists(inEdges, inEdges[i][g].vertexList.data(), j, END_OLD,
+                                    grammar3indexRight[g], prefetchDistance_, true);
+                inNbr1 = inEdges[i][g].vertexList[j];
 
-                    for (uint m = 0; m < grammar3indexRight[g].size(); m++)
-                    {
-                        // C = g
-                        uint B = grammar3indexRight[g][m].first;
-                        uint A = grammar3indexRight[g][m].second;
+                for (uint m = 0; m < grammar3indexRight[g].size(); m++)
+                {
+                    // C = g
+                    uint B = grammar3indexRight[g][m].first;
+                    uint A = grammar3indexRight[g][m].second;
 
-                        uint START_NEW_OUT = inEdges[inNbr1][B].OLD_END;
-                        uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
+                    uint START_NEW_OUT = inEdges[inNbr1][B].OLD_END;
+                    uint END_NEW_OUT = inEdges[inNbr1][B].NEW_END;
+                    staged += graph_->stageEdges(i, A, inEdges[inNbr1][B].vertexList.data() + START_NEW_OUT,
+                                                 END_NEW_OUT - START_NEW_OUT);
+                }
+            }
+            return staged;
+        };
 
-                        for (uint h = START_NEW_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint inNbr2 = inEdges[inNbr1][B].vertexList[h];
-                            Edge newEdge(inNbr2, i, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+        ull added = 0;
+        if (labelMajor_)
+        {
+            // one label at a time, split across the threads: its productions and the rows they reach stay in cache
+            for (uint g = 0; g < labelSize; g++)
+            {
+                if (grammar2index[g].empty() && grammar3indexRight[g].empty()) continue;
+                #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
+                for (uint i = 0; i < nodeSize; i++)
+                {
+                    added += joinRow(i, g);
+                }
+            }
+        }
+        else
+        {
+            #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
+                {
+                    added += joinRow(i, g);
                 }
             }
         }
 
+        // ----------------- Commit Staged Edges -----------------
+        #pragma omp parallel for schedule(static, 1) num_threads(numOfThreads_)
+        for (uint t = 0; t < numOfThreads_; t++)
+        {
+            graph_->commitStaged(t);
+        }
+        if (added > 0)
+        {
+            terminate = false;
+        }
+
         // ----------------- Update Sliding Pointers -----------------
         #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
         for (uint i = 0; i < nodeSize; i++)
@@ -3,15 +3,17 @@
 
 namespace gracfl 
 {
-    SolverBWTopo::SolverBWTopo(std::string graphfilepath, Grammar& grammar)
+    SolverBWTopo::SolverBWTopo(std::string graphfilepath, Grammar& grammar, uint prefetchDistance, uint numOfThreads)
     : grammar_(grammar)
-    , graph_(new Graph2DIn(graphfilepath, grammar))
+    , graph_(new Graph2DIn(graphfilepath, grammar, numOfThreads))
+    , prefetchDistance_(prefetchDistance)
     {
     }
 
-    SolverBWTopo::SolverBWTopo(std::vector<Edge>& edges, Grammar& grammar)
+    SolverBWTopo::SolverBWTopo(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance, uint numOfThreads)
     : grammar_(grammar)
-    , graph_(new Graph2DIn(edges, grammar))
+    , graph_(new Graph2DIn(edges, grammar, numOfThreads))
+    , prefetchDistance_(prefetchDistance)
     {
     }
 
@@ -50,7 +52,7 @@ namespace gracfl
 
     void SolverBWTopo::runSingleIteration(
         std::vector<TemporalVectorWithLbldVtx>& inEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+        std::vector<std::vector<FlatHashset>>& inHashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<uint>>& grammar3index,
         uint labelSize,
@@ -66,8 +68,9 @@ namespace gracfl
 
 			for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++)
 			{
+				prefetch::topoLists(inEdges, inEdges[i].vertexList.data(), j, END_NEW_OUT, prefetchDistance_, false);
 				nbr = inEdges[i].vertexList[j];
-				std::vector<uint> leftLabels = grammar2index[nbr.label];
+				const std::vector<uint>& leftLabels = grammar2index[nbr.label];
 
                 // ------- Rule Type: A = B -------
 				for (uint g = 0; g < leftLabels.size(); g++)
@@ -83,7 +86,7 @@ namespace gracfl
 				for (uint h = START_OLD; h < END_NEW; h++)
 				{
 					LbldVtx outInNbr = inEdges[nbr.vtx].vertexList[h];
-					std::vector<uint> leftLabels = grammar3index[outInNbr.label * labelSize +  nbr.label];
+					const std::vector<uint>& leftLabels = grammar3index[outInNbr.label * labelSize +  nbr.label];
 
 					for (uint g = 0; g < leftLabels.size(); g++)
 					{
@@ -98,6 +101,7 @@ namespace gracfl
 			uint OLD_END_IN = inEdges[i].OLD_END;
 			for (uint j = OLD_START_IN; j < OLD_END_IN; j++)
 			{
+				prefetch::topoLists(inEdges, inEdges[i].vertexList.data(), j, OLD_END_IN, prefetchDistance_, true);
 				LbldVtx nbr = inEdges[i].vertexList[j];
 
 				uint NEW_START_IN = inEdges[nbr.vtx].OLD_END;
@@ -105,7 +109,7 @@ namespace gracfl
 				for (uint h = NEW_START_IN; h < NEW_END_IN; h++)
 				{
 					LbldVtx outInNbr = inEdges[nbr.vtx].vertexList[h];
-					std::vector<uint> leftLabels = grammar3index[outInNbr.label * labelSize + nbr.label];
+					const std::vector<uint>& leftLabels = grammar3index[outInNbr.label * labelSize + nbr.label];
 
 					for (uint g = 0; g < leftLabels.size(); g++)
 					{
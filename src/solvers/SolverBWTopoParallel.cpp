@@ -4,16 +4,24 @@
 
 namespace gracfl 
 {
-    SolverBWTopoParallel::SolverBWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
-    : SolverBWTopo(graphfilepath, grammar)
+    SolverBWTopoParallel::SolverBWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance)
+    : SolverBWTopo(graphfilepath, grammar, prefetchDistance, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
-    SolverBWTopoParallel::SolverBWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
-    : SolverBWTopo(edges, grammar)
+    SolverBWTopoParallel::SolverBWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance)
+    : SolverBWTopo(edges, grammar, prefetchDistance, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
     void SolverBWTopoParallel::runCFL()
@@ -46,15 +54,18 @@ namespace gracfl
 
     void SolverBWTopoParallel::runSingleIterationParallel(
         std::vector<TemporalVectorWithLbldVtx>& inEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& inHashset,
+        std::vector<std::vector<FlatHashset>>& inHashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<uint>>& grammar3index,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
     {
+        // new edges are staged per thread and appended once all threads are done
+        graph_->beginStaging(numOfThreads_);
+        ull added = 0;
         // Derive new edges based on grammar rules
-        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
+        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
 		for (uint i = 0; i < nodeSize; i++)
 		{
 			LbldVtx nbr;
@@ -63,15 +74,16 @@ namespace gracfl
 
 			for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++)
 			{
+				prefetch::topoLists(inEdges, inEdges[i].vertexList.data(), j, END_NEW_OUT, prefetchDistance_, false);
 				nbr = inEdges[i].vertexList[j];
-				std::vector<uint> leftLabels = grammar2index[nbr.label];
+				const std::vector<uint>& leftLabels = grammar2index[nbr.label];
 
                 // ------- Rule Type: A = B -------
 				for (uint g = 0; g < leftLabels.size(); g++)
 				{
                     Edge newEdge(nbr.vtx, i, leftLabels[g]);
                     // check if the edge already exists and add to the graph
-                    graph_->checkAndAddEdge(newEdge, terminate);
+                    added += graph_->stageEdge(newEdge);
 				}
 
 				uint START_OLD = 0;
@@ -80,13 +92,13 @@ namespace gracfl
 				for (uint h = START_OLD; h < END_NEW; h++)
 				{
 					LbldVtx outInNbr = inEdges[nbr.vtx].vertexList[h];
-					std::vector<uint> leftLabels = grammar3index[outInNbr.label * labelSize +  nbr.label];
+					const std::vector<uint>& leftLabels = grammar3index[outInNbr.label * labelSize +  nbr.label];
 
 					for (uint g = 0; g < leftLabels.size(); g++)
 					{
                         Edge newEdge(outInNbr.vtx, i, leftLabels[g]);
                         // check if the edge already exists and add to the graph
-                        graph_->checkAndAddEdge(newEdge, terminate);
+                        added += graph_->stageEdge(newEdge);
 					}
 				}
 			}
@@ -95,6 +107,7 @@ namespace gracfl
 			uint OLD_END_IN = inEdges[i].OLD_END;
 			for (uint j = OLD_START_IN; j < OLD_END_IN; j++)
 			{
+				prefetch::topoLists(inEdges, inEdges[i].vertexList.data(), j, OLD_END_IN, prefetchDistance_, true);
 				LbldVtx nbr = inEdges[i].vertexList[j];
 
 				uint NEW_START_IN = inEdges[nbr.vtx].OLD_END;
@@ -102,18 +115,29 @@ namespace gracfl
 				for (uint h = NEW_START_IN; h < NEW_END_IN; h++)
 				{
 					LbldVtx outInNbr = inEdges[nbr.vtx].vertexList[h];
-					std::vector<uint> leftLabels = grammar3index[outInNbr.label * labelSize + nbr.label];
+					const std::vector<uint>& leftLabels = grammar3index[outInNbr.label * labelSize + nbr.label];
 
 					for (uint g = 0; g < leftLabels.size(); g++)
 					{
                         Edge newEdge(outInNbr.vtx, i, leftLabels[g]);
                         // check if the edge already exists and add to the graph
-                        graph_->checkAndAddEdge(newEdge, terminate);
+                        added += graph_->stageEdge(newEdge);
 					}
 				}
 			}
 		}
 
+        // ----------------- Commit Staged Edges -----------------
+        #pragma omp parallel for schedule(static, 1) num_threads(numOfThreads_)
+        for (uint t = 0; t < numOfThreads_; t++)
+        {
+            graph_->commitStaged(t);
+        }
+        if (added > 0)
+        {
+            terminate = false;
+        }
+
         // ----------------- Update Sliding Pointers -----------------
         #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
 		for (int i = 0; i < nodeSize; i++)
@@ -0,0 +1,89 @@
+#include <iostream>
+#include "solvers/SolverBdd.hpp"
+
+namespace gracfl
+{
+    SolverBdd::SolverBdd(std::string graphfilepath, Grammar& grammar, std::string order)
+    : grammar_(grammar)
+    , graph_(new GraphBdd(graphfilepath, grammar, order))
+    {
+    }
+
+    SolverBdd::SolverBdd(std::vector<Edge>& edges, Grammar& grammar, std::string order)
+    : grammar_(grammar)
+    , graph_(new GraphBdd(edges, grammar, order))
+    {
+    }
+
+    SolverBdd::~SolverBdd()
+    {
+        delete graph_;
+    }
+
+    void SolverBdd::runCFL()
+    {
+        uint itr = 0;
+        ull derived;
+
+        for (const auto& rule : grammar_.getRule1())
+        {
+            graph_->addSelfEdges(rule[0]); // add epsilon edges
+        }
+        do {
+            itr++;
+            derived = runSingleIteration();
+            std::cout << "Iteration " << itr << std::endl;
+        } while (derived > 0);
+
+        BddManager& manager = graph_->manager();
+        std::cout << "BDD nodes\t= " << manager.liveNodes() << " live of " << manager.capacity() << std::endl;
+    }
+
+    ull SolverBdd::runSingleIteration()
+    {
+        BddManager& manager = graph_->manager();
+        const std::vector<GraphBdd::Node>& old = graph_->old_;
+        const std::vector<GraphBdd::Node>& delta = graph_->delta_;
+        uint labelSize = grammar_.getLabelSize();
+
+        std::vector<GraphBdd::Node> next(labelSize, BddManager::FALSE);
+        for (const auto& rule : grammar_.getRule2())
+        {
+            next[rule[0]] = manager.disjoin(next[rule[0]], delta[rule[1]]);
+        }
+        for (const auto& rule : grammar_.getRule3())
+        {
+            uint A = rule[0], B = rule[1], C = rule[2];
+            // ΔB·C covers ΔB·C_old and ΔB·ΔC in one product
+            if (delta[B] != BddManager::FALSE)
+            {
+                GraphBdd::Node fullC = manager.disjoin(old[C], delta[C]);
+                next[A] = manager.disjoin(next[A], graph_->compose(delta[B], fullC));
+            }
+            if (old[B] != BddManager::FALSE && delta[C] != BddManager::FALSE)
+            {
+                next[A] = manager.disjoin(next[A], graph_->compose(old[B], delta[C]));
+            }
+            graph_->collectGarbage(next);
+        }
+
+        ull derived = 0;
+        for (uint label = 0; label < labelSize; label++)
+        {
+            GraphBdd::Node known = manager.disjoin(old[label], delta[label]);
+            next[label] = manager.subtract(next[label], known);
+            derived += graph_->countRelation(next[label]);
+        }
+        for (uint label = 0; label < labelSize; label++)
+        {
+            graph_->merge(label, next[label]);
+        }
+        graph_->collectGarbage({});
+        return derived;
+    }
+
+    ull SolverBdd::getEdgeCount()
+    {
+        return graph_->countEdge();
+    }
+}
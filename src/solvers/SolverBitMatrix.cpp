@@ -0,0 +1,369 @@
+#include <iostream>
+#include <algorithm>
+#include "solvers/SolverBitMatrix.hpp"
+
+namespace gracfl
+{
+    SolverBitMatrix::SolverBitMatrix(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool fourRussians)
+    : grammar_(grammar)
+    , graph_(new GraphBitMatrix(graphfilepath, grammar, numOfThreads))
+    , numOfThreads_(std::max(1u, numOfThreads))
+    , fourRussians_(fourRussians)
+    {
+        indexRules();
+    }
+
+    SolverBitMatrix::SolverBitMatrix(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool fourRussians)
+    : grammar_(grammar)
+    , graph_(new GraphBitMatrix(edges, grammar, numOfThreads))
+    , numOfThreads_(std::max(1u, numOfThreads))
+    , fourRussians_(fourRussians)
+    {
+        indexRules();
+    }
+
+    SolverBitMatrix::~SolverBitMatrix()
+    {
+        delete graph_;
+    }
+
+    void SolverBitMatrix::indexRules()
+    {
+        uint labelSize = grammar_.getLabelSize();
+        unary_.assign(labelSize, {});
+        binary_.assign(labelSize, {});
+        for (const auto& rule : grammar_.getRule2())
+        {
+            unary_[rule[0]].push_back(rule[1]);
+        }
+        for (const auto& rule : grammar_.getRule3())
+        {
+            binary_[rule[0]].emplace_back(rule[1], rule[2]);
+        }
+        next_.assign(labelSize, BitMatrix());
+        for (uint A = 0; A < labelSize; A++)
+        {
+            if (unary_[A].empty() && binary_[A].empty()) continue;
+            derived_.push_back(A);
+            next_[A].allocate(graph_->getNodeSize());
+        }
+        tables_.assign(numOfThreads_, std::vector<uint64_t>(fourRussians_ ? (1u << BLOCK_BITS) * TILE_WORDS : 0));
+    }
+
+    void SolverBitMatrix::runCFL()
+    {
+        uint itr = 0;
+        ull derived;
+
+        for (const auto& rule : grammar_.getRule1())
+        {
+            graph_->addSelfEdges(rule[0]); // add epsilon edges
+        }
+        ull bytes = graph_->memoryBytes();
+        for (const BitMatrix& matrix : next_)
+        {
+            bytes += matrix.bits.size() * sizeof(uint64_t) + matrix.active.size();
+        }
+        std::cout << "Bit matrices\t= " << bytes / (1024 * 1024) << " MiB ("
+                  << (fourRussians_ ? "four-russians" : "naive") << " kernel)" << std::endl;
+        do {
+            itr++;
+            derived = runSingleIteration();
+            std::cout << "Iteration " << itr << std::endl;
+        } while (derived > 0);
+    }
+
+    ull SolverBitMatrix::runSingleIteration()
+    {
+        auto& full = graph_->full_;
+        auto& delta = graph_->delta_;
+        uint nodeSize = graph_->getNodeSize();
+
+        for (uint A : derived_)
+        {
+            BitMatrix& next = next_[A];
+            std::fill(next.bits.begin(), next.bits.end(), 0);
+            std::fill(next.active.begin(), next.active.end(), 0);
+            next.any = false;
+            for (uint B : unary_[A])
+            {
+                if (!delta[B].any) continue;
+                #pragma omp parallel for schedule(dynamic, 64) num_threads(numOfThreads_)
+                for (uint i = 0; i < nodeSize; i++)
+                {
+                    if (!delta[B].active[i]) continue;
+                    const uint64_t* in = delta[B].row(i);
+                    uint64_t* out = next.row(i);
+                    for (uint w = 0; w < next.words; w++)
+                    {
+                        out[w] |= in[w];
+                    }
+                }
+            }
+            for (const auto& rule : binary_[A])
+            {
+                multiply(delta[rule.first], full[rule.second], next);
+                multiply(full[rule.first], delta[rule.second], next);
+            }
+        }
+
+        // mask with the known edges; the survivors are the new delta and join the full matrix
+        ull derived = 0;
+        for (uint A : derived_)
+        {
+            BitMatrix& next = next_[A];
+            BitMatrix& known = full[A];
+            #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(numOfThreads_) reduction(+:derived)
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                uint64_t* out = next.row(i);
+                uint64_t* all = known.row(i);
+                uint64_t bits = 0;
+                for (uint w = 0; w < next.words; w++)
+                {
+                    uint64_t fresh = out[w] & ~all[w];
+                    out[w] = fresh;
+                    all[w] |= fresh;
+                    bits |= fresh;
+                    derived += __builtin_popcountll(fresh);
+                }
+                next.active[i] = bits != 0;
+                known.active[i] |= next.active[i];
+            }
+        }
+        for (uint label = 0; label < grammar_.getLabelSize(); label++)
+        {
+            if (next_[label].allocated())
+            {
+                std::swap(delta[label], next_[label]);
+                delta[label].any = std::find(delta[label].active.begin(), delta[label].active.end(), 1) != delta[label].active.end();
+                full[label].any = full[label].any || delta[label].any;
+            }
+            else if (delta[label].allocated())
+            {
+                // labels without productions only have their input edges as delta
+                delta[label].release();
+            }
+        }
+        return derived;
+    }
+
+    void SolverBitMatrix::multiply(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P)
+    {
+        if (!X.any || !Y.any) return;
+        if (fourRussians_)
+        {
+            multiplyFourRussians(X, Y, P);
+        }
+        else
+        {
+            multiplyNaive(X, Y, P);
+        }
+    }
+
+    void SolverBitMatrix::multiplyFourRussians(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P)
+    {
+        const uint n = X.rows;
+        const uint words = X.words;
+        const uint rowTiles = (n + TILE_ROWS - 1) / TILE_ROWS;
+        const uint colTiles = (words + TILE_WORDS - 1) / TILE_WORDS;
+
+        // rows of Y with a bit, so bits of X that select an empty row are ignored
+        std::vector<uint64_t> live(words, 0);
+        for (uint k = 0; k < n; k++)
+        {
+            if (Y.active[k]) live[k >> 6] |= uint64_t(1) << (k & 63);
+        }
+
+        // a table row is as wide as the tile, wasted on rows of Y with few non-zero words
+        ull liveRows = 0, liveWords = 0;
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(numOfThreads_) reduction(+:liveRows, liveWords)
+        for (uint k = 0; k < n; k++)
+        {
+            if (!Y.active[k]) continue;
+            liveRows++;
+            const uint64_t* row = Y.row(k);
+            for (uint w = 0; w < words; w++)
+            {
+                liveWords += row[w] != 0;
+            }
+        }
+        if (liveWords * SPARSE_ROW_FRACTION < liveRows * words)
+        {
+            multiplySparseRows(X, Y, P);
+            return;
+        }
+
+        // per row tile, the rows of X that select a live row and the blocks they select from;
+        // bits counts the row ORs of the naive kernel, blocks those of the tabulated one
+        std::vector<uint64_t> used(static_cast<size_t>(rowTiles) * words, 0);
+        std::vector<std::vector<uint>> rowsOf(rowTiles);
+        ull bits = 0, blocks = 0;
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(numOfThreads_) reduction(+:bits, blocks)
+        for (uint rt = 0; rt < rowTiles; rt++)
+        {
+            uint64_t* acc = used.data() + static_cast<size_t>(rt) * words;
+            for (uint i = rt * TILE_ROWS; i < std::min(n, (rt + 1) * TILE_ROWS); i++)
+            {
+                if (!X.active[i]) continue;
+                const uint64_t* row = X.row(i);
+                bool hit = false;
+                for (uint w = 0; w < words; w++)
+                {
+                    uint64_t selected = row[w] & live[w];
+                    if (selected == 0) continue;
+                    hit = true;
+                    acc[w] |= selected;
+                    bits += __builtin_popcountll(selected);
+                    selected |= selected >> 4;
+                    selected |= selected >> 2;
+                    selected |= selected >> 1;
+                    blocks += __builtin_popcountll(selected & 0x0101010101010101ull);
+                }
+                if (hit) rowsOf[rt].push_back(i);
+            }
+        }
+        if (bits == 0) return;
+        if (bits < MIN_BITS_PER_BLOCK * blocks)
+        {
+            // too sparse for the tables to pay off
+            multiplyNaive(X, Y, P);
+            return;
+        }
+
+        #pragma omp parallel for collapse(2) schedule(dynamic, 1) num_threads(numOfThreads_)
+        for (uint rt = 0; rt < rowTiles; rt++)
+        {
+            for (uint ct = 0; ct < colTiles; ct++)
+            {
+                uint64_t* table = tables_[omp_get_thread_num()].data();
+                const uint w0 = ct * TILE_WORDS;
+                const uint W = std::min(TILE_WORDS, words - w0);
+                const std::vector<uint>& rows = rowsOf[rt];
+                const uint64_t* acc = used.data() + static_cast<size_t>(rt) * words;
+                for (uint wk = 0; wk < words; wk++)
+                {
+                    if (acc[wk] == 0) continue;
+                    for (uint b = 0; b < 64 / BLOCK_BITS; b++)
+                    {
+                        const uint shift = b * BLOCK_BITS;
+                        const uint mask = (acc[wk] >> shift) & 0xFF;
+                        if (mask == 0) continue;
+                        const uint k0 = wk * 64 + shift;
+
+                        // table[p] = OR of the rows k0 + j for the bits j of p, for the subsets
+                        // of mask in increasing order, so table[p without its lowest bit] is ready
+                        std::fill(table, table + W, 0);
+                        for (uint p = mask & -mask; p != 0; p = (p - mask) & mask)
+                        {
+                            const uint low = p & (~p + 1);
+                            const uint64_t* prev = table + (p ^ low) * TILE_WORDS;
+                            const uint64_t* row = Y.row(k0 + __builtin_ctz(p)) + w0;
+                            uint64_t* entry = table + p * TILE_WORDS;
+                            for (uint w = 0; w < W; w++)
+                            {
+                                entry[w] = prev[w] | row[w];
+                            }
+                        }
+
+                        for (uint i : rows)
+                        {
+                            const uint p = (X.row(i)[wk] >> shift) & mask;
+                            if (p == 0) continue;
+                            const uint64_t* entry = table + p * TILE_WORDS;
+                            uint64_t* out = P.row(i) + w0;
+                            for (uint w = 0; w < W; w++)
+                            {
+                                out[w] |= entry[w];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void SolverBitMatrix::multiplyNaive(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P)
+    {
+        #pragma omp parallel for schedule(dynamic, 64) num_threads(numOfThreads_)
+        for (uint i = 0; i < X.rows; i++)
+        {
+            if (!X.active[i]) continue;
+            const uint64_t* row = X.row(i);
+            uint64_t* out = P.row(i);
+            for (uint wk = 0; wk < X.words; wk++)
+            {
+                for (uint64_t bits = row[wk]; bits; bits &= bits - 1)
+                {
+                    const uint k = wk * 64 + __builtin_ctzll(bits);
+                    if (!Y.active[k]) continue;
+                    const uint64_t* in = Y.row(k);
+                    for (uint w = 0; w < P.words; w++)
+                    {
+                        out[w] |= in[w];
+                    }
+                }
+            }
+        }
+    }
+
+    void SolverBitMatrix::multiplySparseRows(const BitMatrix& X, const BitMatrix& Y, BitMatrix& P)
+    {
+        // the non-zero words of the rows of Y, in CSR form
+        const uint n = Y.rows;
+        std::vector<ull> offsets(n + 1, 0);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(numOfThreads_)
+        for (uint k = 0; k < n; k++)
+        {
+            if (!Y.active[k]) continue;
+            const uint64_t* row = Y.row(k);
+            for (uint w = 0; w < Y.words; w++)
+            {
+                offsets[k + 1] += row[w] != 0;
+            }
+        }
+        for (uint k = 0; k < n; k++)
+        {
+            offsets[k + 1] += offsets[k];
+        }
+        std::vector<uint> index(offsets[n]);
+        std::vector<uint64_t> value(offsets[n]);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(numOfThreads_)
+        for (uint k = 0; k < n; k++)
+        {
+            if (!Y.active[k]) continue;
+            const uint64_t* row = Y.row(k);
+            ull pos = offsets[k];
+            for (uint w = 0; w < Y.words; w++)
+            {
+                if (row[w] == 0) continue;
+                index[pos] = w;
+                value[pos++] = row[w];
+            }
+        }
+
+        #pragma omp parallel for schedule(dynamic, 64) num_threads(numOfThreads_)
+        for (uint i = 0; i < X.rows; i++)
+        {
+            if (!X.active[i]) continue;
+            const uint64_t* row = X.row(i);
+            uint64_t* out = P.row(i);
+            for (uint wk = 0; wk < X.words; wk++)
+            {
+                for (uint64_t bits = row[wk]; bits; bits &= bits - 1)
+                {
+                    const uint k = wk * 64 + __builtin_ctzll(bits);
+                    for (ull e = offsets[k]; e < offsets[k + 1]; e++)
+                    {
+                        out[index[e]] |= value[e];
+                    }
+                }
+            }
+        }
+    }
+
+    ull SolverBitMatrix::getEdgeCount()
+    {
+        return graph_->countEdge();
+    }
+}
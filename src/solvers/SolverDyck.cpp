@@ -0,0 +1,695 @@
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <tuple>
+#include <stdexcept>
+#include "solvers/SolverDyck.hpp"
+
+namespace gracfl
+{
+    namespace
+    {
+        using KindLists = std::unordered_map<uint, std::vector<uint>>;
+
+        /// Moves the per-kind vertex lists of src into dst, appending the shorter list to the longer one.
+        void mergeKindLists(KindLists& dst, KindLists& src)
+        {
+            if (dst.size() < src.size())
+            {
+                dst.swap(src);
+            }
+            for (auto& kv : src)
+            {
+                auto& list = dst[kv.first];
+                if (list.size() < kv.second.size())
+                {
+                    list.swap(kv.second);
+                }
+                list.insert(list.end(), kv.second.begin(), kv.second.end());
+            }
+            KindLists().swap(src);
+        }
+
+        /// Moves the elements of src into dst, inserting the smaller set into the larger one.
+        void mergeSets(std::unordered_set<uint>& dst, std::unordered_set<uint>& src)
+        {
+            if (dst.size() < src.size())
+            {
+                dst.swap(src);
+            }
+            dst.insert(src.begin(), src.end());
+            std::unordered_set<uint>().swap(src);
+        }
+    }
+
+    SolverDyck::SolverDyck(std::string graphfilepath, Grammar& grammar)
+    : grammar_(grammar)
+    , graph_(new Graph(graphfilepath, grammar))
+    {
+        init();
+    }
+
+    SolverDyck::SolverDyck(std::vector<Edge>& edges, Grammar& grammar)
+    : grammar_(grammar)
+    , graph_(new Graph(edges, grammar))
+    {
+        init();
+    }
+
+    SolverDyck::~SolverDyck()
+    {
+        delete graph_;
+    }
+
+    void SolverDyck::init()
+    {
+        if (!grammar_.isDyck())
+        {
+            delete graph_;
+            throw std::runtime_error("SolverDyck requires a Dyck-shaped grammar");
+        }
+
+        const auto& kinds = grammar_.dyckKinds_;
+        nodeSize_ = graph_->getNodeSize();
+        openKind_.assign(grammar_.getLabelSize(), -1);
+        closeKind_.assign(grammar_.getLabelSize(), -1);
+        for (uint k = 0; k < kinds.size(); k++)
+        {
+            openKind_[kinds[k].open] = k;
+            closeKind_[kinds[k].close] = k;
+        }
+        kindOf_.resize(kinds.size());
+        std::iota(kindOf_.begin(), kindOf_.end(), 0);
+        indexOf_.assign(kinds.size(), 0);
+
+        openIn_.resize(nodeSize_);
+        closeOut_.resize(nodeSize_);
+        hasOpenOut_.assign(nodeSize_, false);
+        std::vector<std::tuple<uint, uint, uint, uint>> distinct;
+        distinct.reserve(graph_->getEdges().size());
+        for (const Edge& edge : graph_->getEdges())
+        {
+            if (openKind_[edge.label] >= 0)
+            {
+                openIn_[edge.to].emplace_back(instance(openKind_[edge.label], edge.index), edge.from);
+                hasOpenOut_[edge.from] = true;
+            }
+            else if (closeKind_[edge.label] >= 0)
+            {
+                closeOut_[edge.from].emplace_back(instance(closeKind_[edge.label], edge.index), edge.to);
+            }
+            else
+            {
+                nonterminalInput_ = true;
+            }
+            distinct.emplace_back(edge.from, edge.label, grammar_.isIndexed(edge.label) ? edge.index : 0, edge.to);
+        }
+        std::sort(distinct.begin(), distinct.end());
+        initialEdges_ = std::unique(distinct.begin(), distinct.end()) - distinct.begin();
+
+        parent_.resize(nodeSize_);
+        std::iota(parent_.begin(), parent_.end(), 0);
+        classSize_.assign(nodeSize_, 1);
+    }
+
+    uint SolverDyck::instance(uint kind, uint index)
+    {
+        if (!grammar_.dyckKinds_[kind].indexed)
+        {
+            return kind;
+        }
+        auto it = instances_.emplace(((ull)kind << 32) | index, kindOf_.size());
+        if (it.second)
+        {
+            kindOf_.push_back(kind);
+            indexOf_.push_back(index);
+        }
+        return it.first->second;
+    }
+
+    int SolverDyck::findInstance(uint kind, uint index) const
+    {
+        if (!grammar_.dyckKinds_[kind].indexed)
+        {
+            return kind;
+        }
+        auto it = instances_.find(((ull)kind << 32) | index);
+        return it == instances_.end() ? -1 : (int)it->second;
+    }
+
+    uint SolverDyck::find(uint v)
+    {
+        while (parent_[v] != v)
+        {
+            parent_[v] = parent_[parent_[v]]; // path halving
+            v = parent_[v];
+        }
+        return v;
+    }
+
+    uint SolverDyck::unite(uint a, uint b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+        {
+            return a;
+        }
+        if (classSize_[a] < classSize_[b])
+        {
+            std::swap(a, b);
+        }
+        parent_[b] = a;
+        classSize_[a] += classSize_[b];
+        merges_++;
+        return a;
+    }
+
+    void SolverDyck::runCFL()
+    {
+        const auto& kinds = grammar_.dyckKinds_;
+        bool allNested = std::all_of(kinds.begin(), kinds.end(), [](const DyckKind& kind) { return kind.helper >= 0; });
+
+        // The union-find algorithm needs S ::= o S c for every kind and no precomputed S/helper edges
+        bidirected_ = allNested && !nonterminalInput_ && isBidirected();
+        if (bidirected_)
+        {
+            runBidirected();
+        }
+        else
+        {
+            runGeneral();
+        }
+        finalize();
+        solved_ = true;
+
+        ull classes = 0;
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            classes += (parent_[v] == v);
+        }
+        std::cout << "Dyck engine\t= " << (bidirected_ ? "union-find (bidirected)" : "worklist with cycle collapsing") << std::endl;
+        std::cout << "Classes\t\t= " << classes << std::endl;
+        std::cout << "Merges\t\t= " << merges_ << std::endl;
+        std::cout << "Derivations\t= " << derivations_ << std::endl;
+    }
+
+    bool SolverDyck::isBidirected()
+    {
+        std::vector<std::tuple<uint, uint, uint>> opens, closes;
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            for (auto& kindAndSrc : openIn_[v])
+            {
+                opens.emplace_back(kindAndSrc.first, kindAndSrc.second, v);
+            }
+            for (auto& kindAndDst : closeOut_[v])
+            {
+                closes.emplace_back(kindAndDst.first, kindAndDst.second, v); // mirrors o-edge dst->v
+            }
+        }
+        std::sort(opens.begin(), opens.end());
+        opens.erase(std::unique(opens.begin(), opens.end()), opens.end());
+        std::sort(closes.begin(), closes.end());
+        closes.erase(std::unique(closes.begin(), closes.end()), closes.end());
+        return opens == closes;
+    }
+
+    void SolverDyck::runBidirected()
+    {
+        // o-predecessors of every class per kind, all of them end up in one class
+        std::vector<KindLists> preds(nodeSize_);
+        std::vector<std::pair<uint, uint>> worklist; // (class, kind) with more than one predecessor
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            for (auto& kindAndSrc : openIn_[v])
+            {
+                preds[v][kindAndSrc.first].push_back(kindAndSrc.second);
+            }
+            for (auto& kv : preds[v])
+            {
+                if (kv.second.size() > 1)
+                {
+                    worklist.emplace_back(v, kv.first);
+                }
+            }
+        }
+
+        auto merge = [&](uint a, uint b) -> uint {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+            {
+                return a;
+            }
+            // only the kinds of the smaller side can gain predecessors
+            std::vector<uint> touched;
+            for (auto& kv : preds[preds[a].size() < preds[b].size() ? a : b])
+            {
+                touched.push_back(kv.first);
+            }
+            uint r = unite(a, b);
+            uint o = (r == a) ? b : a;
+            mergeKindLists(preds[r], preds[o]);
+            for (uint k : touched)
+            {
+                if (preds[r][k].size() > 1)
+                {
+                    worklist.emplace_back(r, k);
+                }
+            }
+            return r;
+        };
+
+        while (!worklist.empty())
+        {
+            auto item = worklist.back();
+            worklist.pop_back();
+            uint r = find(item.first);
+            uint k = item.second;
+            auto it = preds[r].find(k);
+            if (it == preds[r].end() || it->second.size() < 2)
+            {
+                continue;
+            }
+
+            std::vector<uint> list;
+            list.swap(it->second);
+            derivations_ += list.size();
+            uint target = find(list[0]);
+            for (uint j = 1; j < list.size(); j++)
+            {
+                target = merge(target, list[j]);
+            }
+
+            // The predecessors collapsed into one, keep it (merges may have added others meanwhile)
+            r = find(r);
+            auto& rest = preds[r][k];
+            rest.push_back(target);
+            if (rest.size() > 1)
+            {
+                worklist.emplace_back(r, k);
+            }
+        }
+
+        // S relates all vertices of a class; S(u, u) holds by epsilon, by S ::= o c, or through a partner
+        sOut_.assign(nodeSize_, {});
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            uint r = find(v);
+            if (grammar_.dyckEpsilon_ || classSize_[r] > 1 || hasOpenOut_[v])
+            {
+                sOut_[r].insert(r);
+            }
+        }
+    }
+
+    void SolverDyck::runGeneral()
+    {
+        const auto& kinds = grammar_.dyckKinds_;
+        sOut_.assign(nodeSize_, {});
+        sIn_.assign(nodeSize_, {});
+
+        // Parentheses of the kinds with S ::= o S c, per class
+        std::vector<KindLists> opensIn(nodeSize_), closesOut(nodeSize_);
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            for (auto& kindAndSrc : openIn_[v])
+            {
+                if (kinds[kindOf_[kindAndSrc.first]].helper >= 0)
+                {
+                    opensIn[v][kindAndSrc.first].push_back(kindAndSrc.second);
+                }
+            }
+            for (auto& kindAndDst : closeOut_[v])
+            {
+                if (kinds[kindOf_[kindAndDst.first]].helper >= 0)
+                {
+                    closesOut[v][kindAndDst.first].push_back(kindAndDst.second);
+                }
+            }
+        }
+
+        std::vector<std::pair<uint, uint>> worklist;
+
+        // Collapses two mutually S-reachable classes. Facts of the merged class meet lists of the
+        // other half they were never joined with, so they are processed again.
+        auto collapse = [&](uint a, uint b) {
+            uint r = unite(a, b);
+            uint o = (r == a) ? b : a;
+            mergeKindLists(opensIn[r], opensIn[o]);
+            mergeKindLists(closesOut[r], closesOut[o]);
+            mergeSets(sOut_[r], sOut_[o]);
+            mergeSets(sIn_[r], sIn_[o]);
+            for (uint y : sOut_[r])
+            {
+                worklist.emplace_back(r, y);
+            }
+            for (uint x : sIn_[r])
+            {
+                worklist.emplace_back(x, r);
+            }
+        };
+
+        auto addFact = [&](uint a, uint b) {
+            derivations_++;
+            a = find(a);
+            b = find(b);
+            if (!sOut_[a].insert(b).second)
+            {
+                return;
+            }
+            sIn_[b].insert(a);
+            worklist.emplace_back(a, b);
+            if (a != b && sOut_[b].count(a))
+            {
+                collapse(a, b);
+            }
+        };
+
+        // Initial facts: epsilon, S ::= o c, and precomputed S/helper edges of the input
+        if (grammar_.dyckEpsilon_)
+        {
+            for (uint v = 0; v < nodeSize_; v++)
+            {
+                addFact(v, v);
+            }
+        }
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            for (auto& kindAndSrc : openIn_[v])
+            {
+                if (!kinds[kindOf_[kindAndSrc.first]].direct)
+                {
+                    continue;
+                }
+                for (auto& kindAndDst : closeOut_[v])
+                {
+                    if (kindAndDst.first == kindAndSrc.first)
+                    {
+                        addFact(kindAndSrc.second, kindAndDst.second);
+                    }
+                }
+            }
+        }
+        if (nonterminalInput_)
+        {
+            uint S = grammar_.dyckStart_;
+            for (const Edge& edge : graph_->getEdges())
+            {
+                if (edge.label == S)
+                {
+                    addFact(edge.from, edge.to);
+                    continue;
+                }
+                for (uint k = 0; k < kinds.size(); k++)
+                {
+                    if (kinds[k].helper != (int)edge.label)
+                    {
+                        continue;
+                    }
+                    int inst = findInstance(k, edge.index);
+                    if (inst < 0)
+                    {
+                        continue; // no parenthesis of this index
+                    }
+                    if (kinds[k].helperHoldsOpen)
+                    {
+                        // S ::= T c
+                        for (auto& kindAndDst : closeOut_[edge.to])
+                        {
+                            if (kindAndDst.first == (uint)inst)
+                            {
+                                addFact(edge.from, kindAndDst.second);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        // S ::= o T
+                        for (auto& kindAndSrc : openIn_[edge.from])
+                        {
+                            if (kindAndSrc.first == (uint)inst)
+                            {
+                                addFact(kindAndSrc.second, edge.to);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<std::pair<uint, uint>> derived;
+        while (!worklist.empty())
+        {
+            auto fact = worklist.back();
+            worklist.pop_back();
+            uint a = find(fact.first);
+            uint b = find(fact.second);
+
+            derived.clear();
+            // ------- S = o S c -------
+            for (auto& kv : opensIn[a])
+            {
+                auto it = closesOut[b].find(kv.first);
+                if (it == closesOut[b].end())
+                {
+                    continue;
+                }
+                for (uint u : kv.second)
+                {
+                    for (uint w : it->second)
+                    {
+                        derived.emplace_back(u, w);
+                    }
+                }
+            }
+            // ------- S = S S -------
+            for (uint z : sOut_[b])
+            {
+                derived.emplace_back(a, z);
+            }
+            for (uint x : sIn_[a])
+            {
+                derived.emplace_back(x, b);
+            }
+
+            for (auto& d : derived)
+            {
+                addFact(d.first, d.second);
+            }
+        }
+    }
+
+    void SolverDyck::finalize()
+    {
+        // Express S over representatives only
+        std::vector<std::unordered_set<uint>> sOut(nodeSize_), sIn(nodeSize_);
+        members_.assign(nodeSize_, {});
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            uint r = find(v);
+            members_[r].push_back(v);
+            for (uint y : sOut_[v])
+            {
+                sOut[r].insert(find(y));
+            }
+        }
+        for (uint r = 0; r < nodeSize_; r++)
+        {
+            for (uint y : sOut[r])
+            {
+                sIn[y].insert(r);
+            }
+        }
+        sOut_.swap(sOut);
+        sIn_.swap(sIn);
+    }
+
+    std::unordered_set<uint> SolverDyck::helperEnds(uint rep, uint k)
+    {
+        std::unordered_set<uint> ends;
+        if (!grammar_.dyckKinds_[kindOf_[k]].helperHoldsOpen)
+        {
+            // T = S c: T(u, w) for u in rep, S(u, v), v -c-> w
+            for (uint Y : sOut_[rep])
+            {
+                for (uint v : members_[Y])
+                {
+                    for (auto& kindAndDst : closeOut_[v])
+                    {
+                        if (kindAndDst.first == k)
+                        {
+                            ends.insert(kindAndDst.second);
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            // T = o S: T(u, w) for w in rep, u -o-> v, S(v, w)
+            for (uint Y : sIn_[rep])
+            {
+                for (uint v : members_[Y])
+                {
+                    for (auto& kindAndSrc : openIn_[v])
+                    {
+                        if (kindAndSrc.first == k)
+                        {
+                            ends.insert(kindAndSrc.second);
+                        }
+                    }
+                }
+            }
+        }
+        return ends;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> SolverDyck::getGraph()
+    {
+        std::vector<std::vector<std::unordered_set<ull>>> result(
+            nodeSize_, std::vector<std::unordered_set<ull>>(grammar_.getLabelSize()));
+        for (const Edge& edge : graph_->getEdges())
+        {
+            result[edge.from][edge.label].insert(edge.to);
+        }
+        if (!solved_)
+        {
+            return result;
+        }
+
+        const auto& kinds = grammar_.dyckKinds_;
+        uint S = grammar_.dyckStart_;
+        for (uint r = 0; r < nodeSize_; r++)
+        {
+            if (members_[r].empty())
+            {
+                continue;
+            }
+            for (uint Y : sOut_[r])
+            {
+                for (uint u : members_[r])
+                {
+                    result[u][S].insert(members_[Y].begin(), members_[Y].end());
+                }
+            }
+            for (uint k = 0; k < kindOf_.size(); k++)
+            {
+                const DyckKind& kind = kinds[kindOf_[k]];
+                if (kind.helper < 0)
+                {
+                    continue;
+                }
+                uint T = kind.helper;
+                std::unordered_set<uint> ends = helperEnds(r, k);
+                for (uint v : members_[r])
+                {
+                    if (!kind.helperHoldsOpen)
+                    {
+                        result[v][T].insert(ends.begin(), ends.end());
+                    }
+                    else
+                    {
+                        for (uint u : ends)
+                        {
+                            result[u][T].insert(v);
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    ull SolverDyck::getEdgeCount()
+    {
+        if (!solved_)
+        {
+            return initialEdges_;
+        }
+        if (nonterminalInput_ && grammar_.hasIndexedLabels())
+        {
+            // as below, but getGraph() drops the indices, so the distinct edges are collected here
+            const auto& kinds = grammar_.dyckKinds_;
+            uint S = grammar_.dyckStart_;
+            std::set<std::tuple<uint, uint, uint, uint>> closure;
+            for (const Edge& edge : graph_->getEdges())
+            {
+                closure.emplace(edge.from, edge.label, grammar_.isIndexed(edge.label) ? edge.index : 0, edge.to);
+            }
+            for (uint r = 0; r < nodeSize_; r++)
+            {
+                for (uint Y : sOut_[r])
+                {
+                    for (uint u : members_[r])
+                    {
+                        for (uint w : members_[Y])
+                        {
+                            closure.emplace(u, S, 0, w);
+                        }
+                    }
+                }
+                for (uint k = 0; k < kindOf_.size() && !members_[r].empty(); k++)
+                {
+                    const DyckKind& kind = kinds[kindOf_[k]];
+                    if (kind.helper < 0)
+                    {
+                        continue;
+                    }
+                    for (uint end : helperEnds(r, k))
+                    {
+                        for (uint v : members_[r])
+                        {
+                            if (kind.helperHoldsOpen)
+                            {
+                                closure.emplace(end, kind.helper, indexOf_[k], v);
+                            }
+                            else
+                            {
+                                closure.emplace(v, kind.helper, indexOf_[k], end);
+                            }
+                        }
+                    }
+                }
+            }
+            return closure.size();
+        }
+        if (nonterminalInput_)
+        {
+            // derived S/helper edges may coincide with input edges, count the expanded closure
+            ull count = 0;
+            for (auto& node : getGraph())
+            {
+                for (auto& set : node)
+                {
+                    count += set.size();
+                }
+            }
+            return count;
+        }
+
+        const auto& kinds = grammar_.dyckKinds_;
+        ull count = initialEdges_;
+        for (uint r = 0; r < nodeSize_; r++)
+        {
+            if (members_[r].empty())
+            {
+                continue;
+            }
+            for (uint Y : sOut_[r])
+            {
+                count += (ull)members_[r].size() * members_[Y].size();
+            }
+            for (uint k = 0; k < kindOf_.size(); k++)
+            {
+                if (kinds[kindOf_[k]].helper >= 0)
+                {
+                    count += (ull)helperEnds(r, k).size() * members_[r].size();
+                }
+            }
+        }
+        return count;
+    }
+}
@@ -3,21 +3,42 @@
 
 namespace gracfl 
 {   
-    SolverFWGram::SolverFWGram(std::string graphfilepath, Grammar& grammar)
+    SolverFWGram::SolverFWGram(std::string graphfilepath, Grammar& grammar, uint prefetchDistance, bool cycleCollapsing,
+                               bool labelMajor, uint numOfThreads)
     : grammar_(grammar)
-    , graph_(new Graph3DOut(graphfilepath, grammar))
+    , graph_(new Graph3DOut(graphfilepath, grammar, numOfThreads))
+    , prefetchDistance_(prefetchDistance)
+    , labelMajor_(labelMajor)
     {
+        if (cycleCollapsing) initCycleCollapsing();
     }
 
-    SolverFWGram::SolverFWGram(std::vector<Edge>& edges, Grammar& grammar)
+    SolverFWGram::SolverFWGram(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance, bool cycleCollapsing,
+                               bool labelMajor, uint numOfThreads)
     : grammar_(grammar)
-    , graph_(new Graph3DOut(edges, grammar))
+    , graph_(new Graph3DOut(edges, grammar, numOfThreads))
+    , prefetchDistance_(prefetchDistance)
+    , labelMajor_(labelMajor)
     {
+        if (cycleCollapsing) initCycleCollapsing();
     }
 
     SolverFWGram::~SolverFWGram()
     {
         delete graph_;
+        delete cycles_;
+    }
+
+    void SolverFWGram::initCycleCollapsing()
+    {
+        cycles_ = new CycleCollapsing(graph_->getEdges(), grammar_, graph_->getNodeSize());
+        if (!cycles_->active())
+        {
+            delete cycles_;
+            cycles_ = nullptr;
+            return;
+        }
+        graph_->redirectTargets(&cycles_->representatives());
     }
 
     void  SolverFWGram::runCFL()
@@ -45,70 +66,94 @@ namespace gracfl
                 terminate);
             std::cout << "Iteration " << itr << std::endl;
         } while(!terminate);
+        if (cycles_ != nullptr) cycles_->printStats();
     }
 
     void SolverFWGram::runSingleIteration(
         std::vector<std::vector<TemporalVector>>& outEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+        std::vector<std::vector<FlatHashset>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
     {
-        for (uint i = 0; i < nodeSize; i++)
+        // rows are read through the representative of their vertex once cycles are merged
+        if (cycles_ != nullptr) collapseCycles(1);
+        const uint* rep = cycles_ != nullptr ? cycles_->representatives().data() : nullptr;
+
+        // joins the edges of label g at vertex i with the rows they reach
+        auto joinRow = [&](uint i, uint g)
         {
-            for (uint g = 0; g < labelSize; g++)
+            uint nbr;
+            uint START_NEW = outEdges[i][g].OLD_END;
+            uint END_NEW = outEdges[i][g].NEW_END;
+
+            for (uint j = START_NEW; j < END_NEW; j++)
             {
-                uint nbr;
-                uint START_NEW = outEdges[i][g].OLD_END;
-                uint END_NEW = outEdges[i][g].NEW_END;
+                prefetch::joinLists(outEdges, outEdges[i][g].vertexList.data(), j, END_NEW,
+                                    grammar3indexLeft[g], prefetchDistance_, false);
+                nbr = outEdges[i][g].vertexList[j];
+                for (uint m = 0; m < grammar2index[g].size(); m++)
+                {
+                    uint A = grammar2index[g][m];
+                    Edge newEdge(i, nbr, A);
+                    graph_->checkAndAddEdge(newEdge, terminate);
+                }
 
-                for (uint j = START_NEW; j < END_NEW; j++)
+                for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
                 {
-                    nbr = outEdges[i][g].vertexList[j];
-                    for (uint m = 0; m < grammar2index[g].size(); m++)
-                    {
-                        uint A = grammar2index[g][m];
-                        Edge newEdge(i, nbr, A);
-                        graph_->checkAndAddEdge(newEdge, terminate);
-                    }
+                    uint C = grammar3indexLeft[g][m].first;
+                    uint A = grammar3indexLeft[g][m].second;
 
-                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
-                    {
-                        uint C = grammar3indexLeft[g][m].first;
-                        uint A = grammar3indexLeft[g][m].second;
-
-                        uint START_OLD_OUT = 0;
-                        uint END_NEW_OUT = outEdges[nbr][C].NEW_END;
-                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint outNbr = outEdges[nbr][C].vertexList[h];
-                            Edge newEdge(i, outNbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    uint row = rep ? rep[nbr] : nbr;
+                    uint START_OLD_OUT = 0;
+                    uint END_NEW_OUT = outEdges[row][C].NEW_END;
+                    graph_->checkAndAddEdges(i, A, outEdges[row][C].vertexList.data() + START_OLD_OUT,
+                                             END_NEW_OUT - START_OLD_OUT, terminate);
                 }
+            }
 
-                uint START_OLD = 0;
-                uint END_OLD = outEdges[i][g].OLD_END;
-                for (uint j = START_OLD; j < END_OLD; j++)
+            uint START_OLD = 0;
+            uint END_OLD = outEdges[i][g].OLD_END;
+            for (uint j = START_OLD; j < END_OLD; j++)
+            {
+                prefetch::joinLists(outEdges, outEdges[i][g].vertexList.data(), j, END_OLD,
+                                    grammar3indexLeft[g], prefetchDistance_, true);
+                nbr = outEdges[i][g].vertexList[j];
+                for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
                 {
-                    nbr = outEdges[i][g].vertexList[j];
-                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
-                    {
-                        uint C = grammar3indexLeft[g][m].first;
-                        uint A = grammar3indexLeft[g][m].second;
-
-                        uint START_NEW_OUT = outEdges[nbr][C].OLD_END;
-                        uint END_NEW_OUT = outEdges[nbr][C].NEW_END;
-                        for (uint h = START_NEW_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint outNbr = outEdges[nbr][C].vertexList[h];
-                            Edge newEdge(i, outNbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    uint C = grammar3indexLeft[g][m].first;
+                    uint A = grammar3indexLeft[g][m].second;
+
+                    uint row = rep ? rep[nbr] : nbr;
+                    uint START_NEW_OUT = outEdges[row][C].OLD_END;
+                    uint END_NEW_OUT = outEdges[row][C].NEW_END;
+                    graph_->checkAndAddEdges(i, A, outEdges[row][C].vertexList.data() + START_NEW_OUT,
+                                             END_NEW_OUT - START_NEW_OUT, terminate);
+                }
+            }
+        };
+
+        if (labelMajor_)
+        {
+            // one label at a time: its productions and the rows they reach stay in cache
+            for (uint g = 0; g < labelSize; g++)
+            {
+                if (grammar2index[g].empty() && grammar3indexLeft[g].empty()) continue;
+                for (uint i = 0; i < nodeSize; i++)
+                {
+                    joinRow(i, g);
+                }
+            }
+        }
+        else
+        {
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
+                {
+                    joinRow(i, g);
                 }
             }
         }
@@ -136,8 +181,56 @@ namespace gracfl
         }
     }
 
+    void SolverFWGram::collapseCycles(uint numThreads)
+    {
+        auto& outEdges = graph_->outEdges_;
+        auto& hashset = graph_->hashset_;
+        const std::vector<uint>& transitive = cycles_->transitiveLabels();
+        uint nodeSize = graph_->getNodeSize();
+
+        // A is transitive, so a delta edge (u, v) closes a cycle iff (v, u) is known by now
+        std::vector<std::vector<std::pair<uint, uint>>> found(numThreads);
+        #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(numThreads)
+        for (uint u = 0; u < nodeSize; u++)
+        {
+            if (cycles_->rep(u) != u) continue;
+            for (uint A : transitive)
+            {
+                if (!cycles_->eligible(u, A)) continue;
+                const TemporalVector& list = outEdges[u][A];
+                for (uint j = list.OLD_END; j < list.NEW_END; j++)
+                {
+                    uint v = cycles_->rep(list.vertexList[j]);
+                    if (v != u && cycles_->eligible(v, A) && hashset[v][A].count(u))
+                    {
+                        found[omp_get_thread_num()].emplace_back(u, v);
+                    }
+                }
+            }
+        }
+
+        for (const auto& pairs : found)
+        {
+            for (const auto& pair : pairs)
+            {
+                uint r = cycles_->rep(pair.first);
+                uint s = cycles_->rep(pair.second);
+                if (r == s) continue;
+                uint absorbed = cycles_->unite(r, s);
+                graph_->mergeRows(absorbed, absorbed == r ? s : r);
+            }
+        }
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> SolverFWGram::getGraph()
+    {
+        if (cycles_ != nullptr) return cycles_->expand(toStdHashset(graph_->getHashset()));
+        return toStdHashset(graph_->getHashset());
+    }
+
     ull SolverFWGram::getEdgeCount()  
     { 
+        if (cycles_ != nullptr) return cycles_->expandEdgeCount(graph_->getHashset());
         return graph_->countEdge();
     };
 }
\ No newline at end of file
@@ -3,16 +3,26 @@
 
 namespace gracfl 
 {
-    SolverFWGramParallel::SolverFWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
-    : SolverFWGram(graphfilepath, grammar)
+    SolverFWGramParallel::SolverFWGramParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance,
+                                               bool cycleCollapsing, bool labelMajor)
+    : SolverFWGram(graphfilepath, grammar, prefetchDistance, cycleCollapsing, labelMajor, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
-    SolverFWGramParallel::SolverFWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
-    : SolverFWGram(edges, grammar)
+    SolverFWGramParallel::SolverFWGramParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance,
+                                               bool cycleCollapsing, bool labelMajor)
+    : SolverFWGram(edges, grammar, prefetchDistance, cycleCollapsing, labelMajor, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
     void  SolverFWGramParallel::runCFL()
@@ -41,77 +51,118 @@ namespace gracfl
                 terminate);
             std::cout << "Iteration " << itr << std::endl;
         } while(!terminate);
+        if (cycles_ != nullptr) cycles_->printStats();
     }
 
     void SolverFWGramParallel::runSingleIterationParallel(
         std::vector<std::vector<TemporalVector>>& outEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+        std::vector<std::vector<FlatHashset>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<std::pair<uint, uint>>>& grammar3indexLeft,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
     {
-        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
-        for (uint i = 0; i < nodeSize; i++)
+        // rows are read through the representative of their vertex once cycles are merged
+        if (cycles_ != nullptr) collapseCycles(numOfThreads_);
+        const uint* rep = cycles_ != nullptr ? cycles_->representatives().data() : nullptr;
+
+        // new edges are staged per thread and appended once all threads are done
+        graph_->beginStaging(numOfThreads_);
+        // joins the edges of label g at vertex i with the rows they reach, returns the edges staged
+        auto joinRow = [&](uint i, uint g) -> ull
         {
-            for (uint g = 0; g < labelSize; g++)
+            ull staged = 0;
+            uint nbr;
+            uint START_NEW = outEdges[i][g].OLD_END;
+            uint END_NEW = outEdges[i][g].NEW_END;
+
+            for (uint j = START_NEW; j < END_NEW; j++)
             {
-                uint nbr;
-                uint START_NEW = outEdges[i][g].OLD_END;
-                uint END_NEW = outEdges[i][g].NEW_END;
+                prefetch::joinLists(outEdges, outEdges[i][g].vertexList.data(), j, END_NEW,
+                                    grammar3indexLeft[g], prefetchDistance_, false);
+                nbr = outEdges[i][g].vertexList[j];
+                for (uint m = 0; m < grammar2index[g].size(); m++)
+                {
+                    uint A = grammar2index[g][m];
+                    Edge newEdge(i, nbr, A);
+                    staged += graph_->stageEdge(newEdge);
+                }
+
+                for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                {
+                    uint C = grammar3indexLeft[g][m].first;
+                    uint A = grammar3indexLeft[g][m].second;
 
-                for (uint j = START_NEW; j < END_NEW; j++)
+                    uint row = rep ? rep[nbr] : nbr;
+                    uint START_OLD_OUT = 0;
+                    uint END_NEW_OUT = outEdges[row][C].NEW_END;
+                    staged += graph_->stageEdges(i, A, outEdges[row][C].vertexList.data() + START_OLD_OUT,
+                                                 END_NEW_OUT - START_OLD_OUT);
+                }
+            }
+
+            uint START_OLD = 0;
+            uint END_OLD = outEdges[i][g].OLD_END;
+            for (uint j = START_OLD; j < END_OLD; j++)
+            {
+                prefetch::joinLists(outEdges, outEdges[i][g].vertexList.data(), j, END_OLD,
+                                    grammar3indexLeft[g], prefetchDistance_, true);
+                nbr = outEdges[i][g].vertexList[j];
+                for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
                 {
-                    nbr = outEdges[i][g].vertexList[j];
-                    for (uint m = 0; m < grammar2index[g].size(); m++)
-                    {
-                        uint A = grammar2index[g][m];
-                        Edge newEdge(i, nbr, A);
-                        graph_->checkAndAddEdge(newEdge, terminate);
-                    }
-
-                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
-                    {
-                        uint C = grammar3indexLeft[g][m].first;
-                        uint A = grammar3indexLeft[g][m].second;
-
-                        uint START_OLD_OUT = 0;
-                        uint END_NEW_OUT = outEdges[nbr][C].NEW_END;
-                        for (uint h = START_OLD_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint outNbr = outEdges[nbr][C].vertexList[h];
-                            Edge newEdge(i, outNbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    uint C = grammar3indexLeft[g][m].first;
+                    uint A = grammar3indexLeft[g][m].second;
+
+                    uint row = rep ? rep[nbr] : nbr;
+                    uint START_NEW_OUT = outEdges[row][C].OLD_END;
+                    uint END_NEW_OUT = outEdges[row][C].NEW_END;
+                    staged += graph_->stageEdges(i, A, outEdges[row][C].vertexList.data() + START_NEW_OUT,
+                                                 END_NEW_OUT - START_NEW_OUT);
                 }
+            }
+            return staged;
+        };
 
-                uint START_OLD = 0;
-                uint END_OLD = outEdges[i][g].OLD_END;
-                for (uint j = START_OLD; j < END_OLD; j++)
+        ull added = 0;
+        if (labelMajor_)
+        {
+            // one label at a time, split across the threads: its productions and the rows they reach stay in cache
+            for (uint g = 0; g < labelSize; g++)
+            {
+                if (grammar2index[g].empty() && grammar3indexLeft[g].empty()) continue;
+                #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
+                for (uint i = 0; i < nodeSize; i++)
                 {
-                    nbr = outEdges[i][g].vertexList[j];
-                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
-                    {
-                        uint C = grammar3indexLeft[g][m].first;
-                        uint A = grammar3indexLeft[g][m].second;
-
-                        uint START_NEW_OUT = outEdges[nbr][C].OLD_END;
-                        uint END_NEW_OUT = outEdges[nbr][C].NEW_END;
-                        for (uint h = START_NEW_OUT; h < END_NEW_OUT; h++)
-                        {
-                            uint outNbr = outEdges[nbr][C].vertexList[h];
-                            Edge newEdge(i, outNbr, A);
-                            graph_->checkAndAddEdge(newEdge, terminate);
-                        }
-                    }
+                    added += joinRow(i, g);
                 }
             }
         }
+        else
+        {
+            #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint g = 0; g < labelSize; g++)
+                {
+                    added += joinRow(i, g);
+                }
+            }
+        }
+
+        // ----------------- Commit Staged Edges -----------------
+        #pragma omp parallel for schedule(static, 1) num_threads(numOfThreads_)
+        for (uint t = 0; t < numOfThreads_; t++)
+        {
+            graph_->commitStaged(t);
+        }
+        if (added > 0)
+        {
+            terminate = false;
+        }
 
         // ----------------- Update Sliding Pointers -----------------
-        #pragma omp parallel for schedule(static) num_threads(numOfThreads_)
+        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
         for (uint i = 0; i < nodeSize; i++)
         {
             for (uint g = 0; g < labelSize; g++)
@@ -0,0 +1,248 @@
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include "solvers/SolverFWHybrid.hpp"
+
+namespace gracfl
+{
+    namespace
+    {
+        /// Cost of opening a neighbor's list, a random access, in units of one scanned edge.
+        constexpr double LIST_OPEN = 4.0;
+    }
+
+    SolverFWHybrid::SolverFWHybrid(std::string graphfilepath, Grammar& grammar, uint numOfThreads, uint prefetchDistance)
+    : grammar_(grammar)
+    , graph_(new GraphHybridOut(graphfilepath, grammar, numOfThreads))
+    , numOfThreads_(numOfThreads)
+    , prefetchDistance_(prefetchDistance)
+    {
+    }
+
+    SolverFWHybrid::SolverFWHybrid(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, uint prefetchDistance)
+    : grammar_(grammar)
+    , graph_(new GraphHybridOut(edges, grammar, numOfThreads))
+    , numOfThreads_(numOfThreads)
+    , prefetchDistance_(prefetchDistance)
+    {
+    }
+
+    SolverFWHybrid::~SolverFWHybrid()
+    {
+        delete graph_;
+    }
+
+    void SolverFWHybrid::runCFL()
+    {
+        uint itr = 0;
+        ull derived;
+
+        addSelfEdges(); // add epsilon edges
+        graph_->initView(delta_, total_);
+        schedule_.clear();
+        do {
+            itr++;
+            bool topoDriven = preferTopoDriven();
+            derived = runSingleIteration(topoDriven);
+            schedule_.push_back(topoDriven);
+            std::cout << "Iteration " << itr << " (" << (topoDriven ? "topo-driven" : "gram-driven") << ")" << std::endl;
+        } while (derived > 0);
+
+        size_t topo = std::count(schedule_.begin(), schedule_.end(), true);
+        std::cout << "Hybrid iterations\t= " << schedule_.size() - topo << " gram-driven, "
+                  << topo << " topo-driven" << std::endl;
+    }
+
+    bool SolverFWHybrid::preferTopoDriven() const
+    {
+        // expected work of both sweeps, with the edges of a label spread evenly over the vertices;
+        // the hash probes of matching edges are the same in both and left out
+        const auto& grammar3indexLeft = grammar_.grammar3indexLeft_;
+        uint labelSize = grammar_.getLabelSize();
+        double n = std::max<uint>(1, graph_->getNodeSize());
+        double deltaAll = std::accumulate(delta_.begin(), delta_.end(), 0.0);
+        double totalAll = std::accumulate(total_.begin(), total_.end(), 0.0);
+
+        double gram = n * labelSize;    // every (vertex, label) row is visited
+        double topo = n;                // every vertex list is visited
+        for (uint B = 0; B < labelSize; B++)
+        {
+            double newB = delta_[B];
+            double oldB = total_[B] - delta_[B];
+            if (newB == 0 && oldB == 0) continue;
+
+            // topo: a new edge scans all edges of its neighbor, an old edge the neighbor's delta
+            topo += newB * (LIST_OPEN + totalAll / n) + oldB * (LIST_OPEN + deltaAll / n);
+
+            // gram: the same per rule B C, on the C-edges of the neighbor only
+            for (const auto& rule : grammar3indexLeft[B])
+            {
+                uint C = rule.first;
+                gram += newB * (LIST_OPEN + total_[C] / n) + oldB * (LIST_OPEN + delta_[C] / n);
+            }
+        }
+        return topo < gram;
+    }
+
+    ull SolverFWHybrid::runSingleIteration(bool topoDriven)
+    {
+        // new edges are staged per thread and appended once all threads are done
+        graph_->beginStaging(numOfThreads_);
+        ull added = topoDriven ? runTopoDriven() : runGramDriven();
+
+        // ----------------- Commit Staged Edges -----------------
+        #pragma omp parallel for schedule(static, 1) num_threads(numOfThreads_)
+        for (uint t = 0; t < numOfThreads_; t++)
+        {
+            graph_->commitStaged(t);
+        }
+
+        // ----------------- Update Sliding Pointers -----------------
+        graph_->slidePointers(numOfThreads_, delta_, total_);
+        return added;
+    }
+
+    ull SolverFWHybrid::runGramDriven()
+    {
+        auto& outEdges = graph_->outEdges_;
+        auto& grammar2index = grammar_.grammar2index_;
+        auto& grammar3indexLeft = grammar_.grammar3indexLeft_;
+        uint labelSize = grammar_.getLabelSize();
+        uint nodeSize = graph_->getNodeSize();
+
+        ull added = 0;
+        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
+        for (uint i = 0; i < nodeSize; i++)
+        {
+            for (uint g = 0; g < labelSize; g++)
+            {
+                uint nbr;
+                uint START_NEW = outEdges[i][g].OLD_END;
+                uint END_NEW = outEdges[i][g].NEW_END;
+
+                for (uint j = START_NEW; j < END_NEW; j++)
+                {
+                    prefetch::joinLists(outEdges, outEdges[i][g].vertexList.data(), j, END_NEW,
+                                        grammar3indexLeft[g], prefetchDistance_, false);
+                    nbr = outEdges[i][g].vertexList[j];
+                    for (uint m = 0; m < grammar2index[g].size(); m++)
+                    {
+                        uint A = grammar2index[g][m];
+                        Edge newEdge(i, nbr, A);
+                        added += graph_->stageEdge(newEdge);
+                    }
+
+                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                    {
+                        uint C = grammar3indexLeft[g][m].first;
+                        uint A = grammar3indexLeft[g][m].second;
+
+                        uint START_OLD_OUT = 0;
+                        uint END_NEW_OUT = outEdges[nbr][C].NEW_END;
+                        added += graph_->stageEdges(i, A, outEdges[nbr][C].vertexList.data() + START_OLD_OUT,
+                                                    END_NEW_OUT - START_OLD_OUT);
+                    }
+                }
+
+                uint START_OLD = 0;
+                uint END_OLD = outEdges[i][g].OLD_END;
+                for (uint j = START_OLD; j < END_OLD; j++)
+                {
+                    prefetch::joinLists(outEdges, outEdges[i][g].vertexList.data(), j, END_OLD,
+                                        grammar3indexLeft[g], prefetchDistance_, true);
+                    nbr = outEdges[i][g].vertexList[j];
+                    for (uint m = 0; m < grammar3indexLeft[g].size(); m++)
+                    {
+                        uint C = grammar3indexLeft[g][m].first;
+                        uint A = grammar3indexLeft[g][m].second;
+
+                        uint START_NEW_OUT = outEdges[nbr][C].OLD_END;
+                        uint END_NEW_OUT = outEdges[nbr][C].NEW_END;
+                        added += graph_->stageEdges(i, A, outEdges[nbr][C].vertexList.data() + START_NEW_OUT,
+                                                    END_NEW_OUT - START_NEW_OUT);
+                    }
+                }
+            }
+        }
+        return added;
+    }
+
+    ull SolverFWHybrid::runTopoDriven()
+    {
+        auto& outEdges = graph_->lbldEdges_;
+        auto& grammar2index = grammar_.grammar2index_;
+        auto& grammar3index = grammar_.grammar3index_;
+        uint labelSize = grammar_.getLabelSize();
+        uint nodeSize = graph_->getNodeSize();
+
+        ull added = 0;
+        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
+        for (uint i = 0; i < nodeSize; i++)
+        {
+            uint START_NEW_OUT = outEdges[i].OLD_END;
+            uint END_NEW_OUT = outEdges[i].NEW_END;
+
+            // For each new edge
+            for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++)
+            {
+                prefetch::topoLists(outEdges, outEdges[i].vertexList.data(), j, END_NEW_OUT, prefetchDistance_, false);
+                LbldVtx nbr = outEdges[i].vertexList[j];
+                for (uint A : grammar2index[nbr.label])
+                {
+                    Edge newEdge(i, nbr.vtx, A);
+                    added += graph_->stageEdge(newEdge);
+                }
+
+                uint START_OLD = 0;
+                uint END_NEW = outEdges[nbr.vtx].NEW_END;
+                for (uint h = START_OLD; h < END_NEW; h++)
+                {
+                    LbldVtx outNbr = outEdges[nbr.vtx].vertexList[h];
+                    for (uint A : grammar3index[nbr.label * labelSize + outNbr.label])
+                    {
+                        Edge newEdge(i, outNbr.vtx, A);
+                        added += graph_->stageEdge(newEdge);
+                    }
+                }
+            }
+
+            uint OLD_START_OUT = 0;
+            uint OLD_END_OUT = outEdges[i].OLD_END;
+            for (uint j = OLD_START_OUT; j < OLD_END_OUT; j++)
+            {
+                prefetch::topoLists(outEdges, outEdges[i].vertexList.data(), j, OLD_END_OUT, prefetchDistance_, true);
+                LbldVtx nbr = outEdges[i].vertexList[j];
+
+                uint NEW_START_OUT = outEdges[nbr.vtx].OLD_END;
+                uint NEW_END_OUT = outEdges[nbr.vtx].NEW_END;
+                for (uint h = NEW_START_OUT; h < NEW_END_OUT; h++)
+                {
+                    LbldVtx outNbr = outEdges[nbr.vtx].vertexList[h];
+                    for (uint A : grammar3index[nbr.label * labelSize + outNbr.label])
+                    {
+                        Edge newEdge(i, outNbr.vtx, A);
+                        added += graph_->stageEdge(newEdge);
+                    }
+                }
+            }
+        }
+        return added;
+    }
+
+    void SolverFWHybrid::addSelfEdges()
+    {
+        for (uint i = 0; i < graph_->getNodeSize(); i++)
+        {
+            for (uint l = 0; l < grammar_.getRule1().size(); l++)
+            {
+                Edge edge(i, i, grammar_.getRule1()[l][0]);
+                graph_->addSelfEdge(edge);
+            }
+        }
+    }
+
+    ull SolverFWHybrid::getEdgeCount()
+    {
+        return graph_->countEdge();
+    }
+}
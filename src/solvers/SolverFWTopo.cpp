@@ -4,15 +4,17 @@
 
 namespace gracfl 
 {
-    SolverFWTopo::SolverFWTopo(std::string graphfilepath, Grammar& grammar)
+    SolverFWTopo::SolverFWTopo(std::string graphfilepath, Grammar& grammar, uint prefetchDistance, uint numOfThreads)
         : grammar_(grammar)
-        , graph_(new Graph2DOut(graphfilepath, grammar))
+        , graph_(new Graph2DOut(graphfilepath, grammar, numOfThreads))
+        , prefetchDistance_(prefetchDistance)
     {
     }
 
-    SolverFWTopo::SolverFWTopo(std::vector<Edge>& edges, Grammar& grammar)
+    SolverFWTopo::SolverFWTopo(std::vector<Edge>& edges, Grammar& grammar, uint prefetchDistance, uint numOfThreads)
         : grammar_(grammar)
-        , graph_(new Graph2DOut(edges, grammar))
+        , graph_(new Graph2DOut(edges, grammar, numOfThreads))
+        , prefetchDistance_(prefetchDistance)
     {
     }
 
@@ -51,7 +53,7 @@ namespace gracfl
 
     void SolverFWTopo::runSingleIteration(
         std::vector<TemporalVectorWithLbldVtx>& outEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+        std::vector<std::vector<FlatHashset>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<uint>>& grammar3index,
         uint labelSize,
@@ -67,9 +69,10 @@ namespace gracfl
 
             // For each new edge
             for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++) {
+                prefetch::topoLists(outEdges, outEdges[i].vertexList.data(), j, END_NEW_OUT, prefetchDistance_, false);
                 nbr = outEdges[i].vertexList[j];
                 // If the edge to the neighbor is labeled with B
-                std::vector<uint> leftLabels = grammar2index[nbr.label];
+                const std::vector<uint>& leftLabels = grammar2index[nbr.label];
 
                 for (uint g = 0; g < leftLabels.size(); g++) {
                     Edge newEdge(i, nbr.vtx, leftLabels[g]);
@@ -81,7 +84,7 @@ namespace gracfl
                 uint END_NEW = outEdges[nbr.vtx].NEW_END;
                 for (uint h = START_OLD; h < END_NEW; h++) {
                     LbldVtx outNbr = outEdges[nbr.vtx].vertexList[h];
-                    std::vector<uint> leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
+                    const std::vector<uint>& leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
 
                     for (uint g = 0; g < leftLabels.size(); g++) {
                         Edge newEdge(i, outNbr.vtx, leftLabels[g]);
@@ -94,13 +97,14 @@ namespace gracfl
             uint OLD_START_OUT = 0;
             uint OLD_END_OUT = outEdges[i].OLD_END;
             for (uint j = OLD_START_OUT; j < OLD_END_OUT; j++) {
+                prefetch::topoLists(outEdges, outEdges[i].vertexList.data(), j, OLD_END_OUT, prefetchDistance_, true);
                 LbldVtx nbr = outEdges[i].vertexList[j];
 
                 uint NEW_START_OUT = outEdges[nbr.vtx].OLD_END;
                 uint NEW_END_OUT = outEdges[nbr.vtx].NEW_END;
                 for (uint h = NEW_START_OUT; h < NEW_END_OUT; h++) {
                     LbldVtx outNbr = outEdges[nbr.vtx].vertexList[h];
-                    std::vector<uint> leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
+                    const std::vector<uint>& leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
 
                     for (uint g = 0; g < leftLabels.size(); g++) {
                         Edge newEdge(i, outNbr.vtx, leftLabels[g]);
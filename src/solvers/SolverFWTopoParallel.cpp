@@ -4,16 +4,24 @@
 
 namespace gracfl 
 {
-    SolverFWTopoParallel::SolverFWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
-    : SolverFWTopo(graphfilepath, grammar)
+    SolverFWTopoParallel::SolverFWTopoParallel(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance)
+    : SolverFWTopo(graphfilepath, grammar, prefetchDistance, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
-    SolverFWTopoParallel::SolverFWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
-    : SolverFWTopo(edges, grammar)
+    SolverFWTopoParallel::SolverFWTopoParallel(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool numaAware, uint prefetchDistance)
+    : SolverFWTopo(edges, grammar, prefetchDistance, numOfThreads)
     {
         numOfThreads_ = numOfThreads;
+        if (numaAware)
+        {
+            numa::placeGraph(graph_, numOfThreads_);
+        }
     }
 
     void SolverFWTopoParallel::runCFL()
@@ -46,14 +54,17 @@ namespace gracfl
 
     void SolverFWTopoParallel::runSingleIterationParallel(
         std::vector<TemporalVectorWithLbldVtx>& outEdges,
-        std::vector<std::vector<std::unordered_set<ull>>>& hashset,
+        std::vector<std::vector<FlatHashset>>& hashset,
         std::vector<std::vector<uint>>& grammar2index,
         std::vector<std::vector<uint>>& grammar3index,
         uint labelSize,
         uint nodeSize,
         bool& terminate)
     {
-        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
+        // new edges are staged per thread and appended once all threads are done
+        graph_->beginStaging(numOfThreads_);
+        ull added = 0;
+        #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_) reduction(+:added)
         for (uint i = 0; i < nodeSize; i++) {
             LbldVtx nbr;
             // The valid index range is [START_NEW, END_NEW-1]
@@ -62,26 +73,27 @@ namespace gracfl
 
             // For each new edge
             for (uint j = START_NEW_OUT; j < END_NEW_OUT; j++) {
+                prefetch::topoLists(outEdges, outEdges[i].vertexList.data(), j, END_NEW_OUT, prefetchDistance_, false);
                 nbr = outEdges[i].vertexList[j];
                 // If the edge to the neighbor is labeled with B
-                std::vector<uint> leftLabels = grammar2index[nbr.label];
+                const std::vector<uint>& leftLabels = grammar2index[nbr.label];
 
                 for (uint g = 0; g < leftLabels.size(); g++) {
                     Edge newEdge(i, nbr.vtx, leftLabels[g]);
                     // Check if the edge already exists and add to graph
-                    graph_->checkAndAddEdge(newEdge, terminate);
+                    added += graph_->stageEdge(newEdge);
                 }
 
                 uint START_OLD = 0;
                 uint END_NEW = outEdges[nbr.vtx].NEW_END;
                 for (uint h = START_OLD; h < END_NEW; h++) {
                     LbldVtx outNbr = outEdges[nbr.vtx].vertexList[h];
-                    std::vector<uint> leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
+                    const std::vector<uint>& leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
 
                     for (uint g = 0; g < leftLabels.size(); g++) {
                         Edge newEdge(i, outNbr.vtx, leftLabels[g]);
                         // Check if the edge already exists and add to graph
-                        graph_->checkAndAddEdge(newEdge, terminate);
+                        added += graph_->stageEdge(newEdge);
                     }
                 }
             }
@@ -89,23 +101,35 @@ namespace gracfl
             uint OLD_START_OUT = 0;
             uint OLD_END_OUT = outEdges[i].OLD_END;
             for (uint j = OLD_START_OUT; j < OLD_END_OUT; j++) {
+                prefetch::topoLists(outEdges, outEdges[i].vertexList.data(), j, OLD_END_OUT, prefetchDistance_, true);
                 LbldVtx nbr = outEdges[i].vertexList[j];
 
                 uint NEW_START_OUT = outEdges[nbr.vtx].OLD_END;
                 uint NEW_END_OUT = outEdges[nbr.vtx].NEW_END;
                 for (uint h = NEW_START_OUT; h < NEW_END_OUT; h++) {
                     LbldVtx outNbr = outEdges[nbr.vtx].vertexList[h];
-                    std::vector<uint> leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
+                    const std::vector<uint>& leftLabels = grammar3index[nbr.label * labelSize + outNbr.label];
 
                     for (uint g = 0; g < leftLabels.size(); g++) {
                         Edge newEdge(i, outNbr.vtx, leftLabels[g]);
                         // Check if the edge already exists and add to graph
-                        graph_->checkAndAddEdge(newEdge, terminate);
+                        added += graph_->stageEdge(newEdge);
                     }
                 }
             }
         }
 
+        // ----------------- Commit Staged Edges -----------------
+        #pragma omp parallel for schedule(static, 1) num_threads(numOfThreads_)
+        for (uint t = 0; t < numOfThreads_; t++)
+        {
+            graph_->commitStaged(t);
+        }
+        if (added > 0)
+        {
+            terminate = false;
+        }
+
         // Update the pointers
         #pragma omp parallel for schedule(static, 512) num_threads(numOfThreads_)
         for (int i = 0; i < nodeSize; i++) {
@@ -0,0 +1,272 @@
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include "solvers/SolverSelector.hpp"
+
+namespace gracfl
+{
+    namespace
+    {
+        // Weights of the cost model, in units of one join of two list entries. The slot, rule and
+        // locality weights were fitted to serial runs of fw and bi, gram- and topo-driven, on five
+        // graphs of 300 to 30000 vertices (alias, Dyck, transitive and sparse): the fit picks the
+        // fastest of the four on four graphs and one within 1.4x on the fifth. The parallel weights
+        // are the geometric means of one-thread runs of the parallel solvers against the serial
+        // ones (fw 1.2x, bi 6.9x). Startup and edges per thread are estimates, the runs were on a
+        // single core; calibration = true times the candidates on the machine itself instead.
+        const double kTopoRuleLookup = 0.8;    ///< Per rule an edge triggers in topo-driven mode
+        const double kGramSlotScan = 0.2;      ///< Per (vertex, label) slot a gram-driven sweep visits
+        const double kConcurrency = 1.2;       ///< Concurrent containers and atomics in parallel mode
+        const double kParallelBi = 5.7;        ///< Parallel bi keeps both the in- and out-containers concurrent
+        const double kThreadStartup = 2000;    ///< Per thread and run
+        const ull kEdgesPerThread = 50000;     ///< Edges needed to keep one more thread busy
+
+        /// Locality factor of the joins: bi works on the lists of one vertex, fw/bw on those of neighbors.
+        double locality(const std::string& direction)
+        {
+            if (direction == "bi") return 1.0;
+            if (direction == "fw") return 1.4;
+            return 1.5;
+        }
+
+        std::string format(double value)
+        {
+            std::ostringstream os;
+            os.precision(3);
+            os << value;
+            return os.str();
+        }
+    }
+
+    SolverSelector::SolverSelector(const std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+    : edges_(edges)
+    , grammar_(grammar)
+    , numThreads_(numThreads > 0 ? numThreads : 1)
+    {
+        uint labelSize = grammar_.getLabelSize();
+        for (const Edge& edge : edges_)
+        {
+            nodeSize_ = std::max(nodeSize_, std::max(edge.from + 1, edge.to + 1));
+        }
+        labelHistogram_.assign(labelSize, 0);
+        for (const Edge& edge : edges_)
+        {
+            labelHistogram_[edge.label]++;
+        }
+
+        // rules an edge of every label triggers
+        std::vector<uint> rulesOf(labelSize, 0);
+        for (const auto& rule : grammar_.getRule2()) rulesOf[rule[1]]++;
+        for (const auto& rule : grammar_.getRule3())
+        {
+            rulesOf[rule[1]]++;
+            rulesOf[rule[2]]++;
+        }
+        double triggered = 0;
+        for (uint label = 0; label < labelSize; label++)
+        {
+            triggered += double(labelHistogram_[label]) * rulesOf[label];
+        }
+        rulesPerLabel_ = edges_.empty() ? 0 : triggered / edges_.size();
+
+        // labeled in- and out-degrees, grouped by vertex
+        std::vector<std::pair<uint, uint>> in, out;
+        in.reserve(edges_.size());
+        out.reserve(edges_.size());
+        for (const Edge& edge : edges_)
+        {
+            in.emplace_back(edge.to, edge.label);
+            out.emplace_back(edge.from, edge.label);
+        }
+        std::sort(in.begin(), in.end());
+        std::sort(out.begin(), out.end());
+
+        std::vector<bool> isEpsilon(labelSize, false);
+        for (const auto& rule : grammar_.getRule1()) isEpsilon[rule[0]] = true;
+
+        std::vector<ull> outCount(labelSize, 0);
+        std::vector<ull> inCount(labelSize, 0);
+        size_t i = 0, o = 0;
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            std::vector<uint> outLabels, inLabels;
+            uint outDegree = 0, inDegree = 0;
+            for (; o < out.size() && out[o].first == v; o++, outDegree++)
+            {
+                if (outCount[out[o].second]++ == 0) outLabels.push_back(out[o].second);
+            }
+            for (; i < in.size() && in[i].first == v; i++, inDegree++)
+            {
+                if (inCount[in[i].second]++ == 0) inLabels.push_back(in[i].second);
+            }
+            maxOutDegree_ = std::max(maxOutDegree_, outDegree);
+            maxInDegree_ = std::max(maxInDegree_, inDegree);
+            usedSlots_ += outLabels.size();
+
+            // epsilon self-loops exist at every vertex
+            for (uint label = 0; label < labelSize; label++)
+            {
+                if (!isEpsilon[label]) continue;
+                if (outCount[label]++ == 0) outLabels.push_back(label);
+                if (inCount[label]++ == 0) inLabels.push_back(label);
+            }
+            for (uint b : inLabels)
+            {
+                // entries are (C, A) for A ::= B C
+                for (const auto& ca : grammar_.rule3LeftIndex(b))
+                {
+                    joins_ += inCount[b] * outCount[ca.first];
+                }
+            }
+            for (uint label : outLabels) outCount[label] = 0;
+            for (uint label : inLabels) inCount[label] = 0;
+        }
+    }
+
+    std::vector<SolverChoice> SolverSelector::rank(const Config& config) const
+    {
+        std::vector<std::string> modes, directions, strategies;
+        auto pick = [](const std::string& value, std::vector<std::string> all) {
+            return value == "auto" ? all : std::vector<std::string>{value};
+        };
+        // distributed mode is only run on request, it needs mpirun
+        modes = pick(config.executionMode, {"serial", "parallel"});
+        // bw only on request, it does not agree with fw and bi on every input
+        directions = pick(config.traversalDirection, {"fw", "bi"});
+        strategies = pick(config.processingStrategy, {"gram-driven", "topo-driven"});
+        if (config.asynchronous || config.executionMode == "distributed")
+        {
+            directions = pick(config.traversalDirection, {"bi"});
+            strategies = pick(config.processingStrategy, {"gram-driven"});
+        }
+        if (config.stratified)
+        {
+            // only SolverBIGram solves the strata one after the other
+            modes = pick(config.executionMode, {"serial"});
+            directions = pick(config.traversalDirection, {"bi"});
+            strategies = pick(config.processingStrategy, {"gram-driven"});
+        }
+        if (config.cycleCollapsing)
+        {
+            directions = pick(config.traversalDirection, {"fw"});
+            strategies = pick(config.processingStrategy, {"gram-driven"});
+        }
+        if (config.processingStrategy == "spgemm" || config.processingStrategy == "bitmatrix" ||
+            config.processingStrategy == "stream")
+        {
+            // the matrix products and stream joins have no traversal direction, only the mode is ranked
+            directions = {"fw"};
+        }
+        if (config.processingStrategy == "hybrid")
+        {
+            // the hybrid solver switches between the fw sweeps
+            directions = pick(config.traversalDirection, {"fw"});
+        }
+        if (config.processingStrategy == "bdd")
+        {
+            // the BDD solver runs serially whatever the mode
+            modes = pick(config.executionMode, {"serial"});
+            directions = {"fw"};
+        }
+
+        double joins = double(joins_) + edges_.size();
+        ull busy = std::max<ull>(1, std::min<ull>(numThreads_, edges_.size() / kEdgesPerThread));
+
+        std::vector<SolverChoice> choices;
+        for (const std::string& mode : modes)
+        {
+            for (const std::string& direction : directions)
+            {
+                for (const std::string& strategy : strategies)
+                {
+                    SolverChoice choice{mode, direction, strategy};
+                    double work = joins * locality(direction);
+                    choice.reasons.push_back(
+                        direction + " joins at locality factor " + format(locality(direction)) +
+                        " on " + std::to_string(joins_) + " first-iteration joins");
+                    if (strategy == "gram-driven")
+                    {
+                        double slots = double(nodeSize_) * grammar_.getLabelSize() * (direction == "bi" ? 2 : 1);
+                        work += slots * kGramSlotScan;
+                        choice.reasons.push_back(
+                            "gram-driven scans " + format(slots) + " (vertex, label) slots per sweep");
+                    }
+                    else if (strategy == "topo-driven")
+                    {
+                        work *= 1 + kTopoRuleLookup * rulesPerLabel_;
+                        choice.reasons.push_back(
+                            "topo-driven looks up " + format(rulesPerLabel_) + " rules per edge");
+                    }
+                    if (mode == "parallel" || mode == "distributed")
+                    {
+                        work *= kConcurrency * (direction == "bi" ? kParallelBi : 1.0) / busy;
+                        work += kThreadStartup * numThreads_;
+                        choice.reasons.push_back(
+                            std::to_string(edges_.size()) + " edges keep " + std::to_string(busy) +
+                            " of " + std::to_string(numThreads_) + " threads busy");
+                    }
+                    choice.cost = work;
+                    choices.push_back(choice);
+                }
+            }
+        }
+        std::stable_sort(choices.begin(), choices.end(),
+            [](const SolverChoice& a, const SolverChoice& b) { return a.cost < b.cost; });
+        return choices;
+    }
+
+    std::vector<Edge> SolverSelector::sample(ull maxEdges) const
+    {
+        if (edges_.size() <= maxEdges)
+        {
+            return edges_;
+        }
+        // largest prefix of vertex ids whose induced subgraph has at most maxEdges edges
+        std::vector<uint> reach;
+        reach.reserve(edges_.size());
+        for (const Edge& edge : edges_)
+        {
+            reach.push_back(std::max(edge.from, edge.to));
+        }
+        std::nth_element(reach.begin(), reach.begin() + maxEdges, reach.end());
+        uint limit = reach[maxEdges];
+
+        std::vector<Edge> sampled;
+        for (const Edge& edge : edges_)
+        {
+            if (edge.from < limit && edge.to < limit)
+            {
+                sampled.push_back(edge);
+            }
+        }
+        return sampled;
+    }
+
+    void SolverSelector::printStats() const
+    {
+        double avgDegree = nodeSize_ ? double(edges_.size()) / nodeSize_ : 0;
+        std::cout << "Nodes\t\t= " << nodeSize_ << std::endl;
+        std::cout << "Edges\t\t= " << edges_.size() << std::endl;
+        std::cout << "Labels\t\t=";
+        const auto& idToSymbol = grammar_.getIDToSymbolMap();
+        for (uint label = 0; label < labelHistogram_.size(); label++)
+        {
+            if (labelHistogram_[label] == 0) continue;
+            auto it = idToSymbol.find(label);
+            std::cout << " " << (it != idToSymbol.end() ? it->second : std::to_string(label))
+                      << ":" << labelHistogram_[label];
+        }
+        std::cout << std::endl;
+        std::cout << "Avg degree\t= " << avgDegree << std::endl;
+        std::cout << "Max out/in\t= " << maxOutDegree_ << "/" << maxInDegree_
+                  << " (skew " << (avgDegree > 0 ? std::max(maxOutDegree_, maxInDegree_) / avgDegree : 0) << ")"
+                  << std::endl;
+        std::cout << "Used slots\t= " << usedSlots_ << std::endl;
+        std::cout << "Rules\t\t= " << grammar_.getRule1().size() << " epsilon, "
+                  << grammar_.getRule2().size() << " unary, "
+                  << grammar_.getRule3().size() << " binary" << std::endl;
+        std::cout << "Rules per edge\t= " << rulesPerLabel_ << std::endl;
+        std::cout << "Joins\t\t= " << joins_ << std::endl;
+        std::cout << "Threads\t\t= " << numThreads_ << std::endl;
+    }
+}
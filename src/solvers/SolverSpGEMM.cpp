@@ -0,0 +1,297 @@
+#include <iostream>
+#include <algorithm>
+#include "solvers/SolverSpGEMM.hpp"
+
+namespace gracfl
+{
+    SolverSpGEMM::SolverSpGEMM(std::string graphfilepath, Grammar& grammar, uint numOfThreads, bool sharedSets)
+    : grammar_(grammar)
+    , graph_(new GraphCSR(graphfilepath, grammar, sharedSets, numOfThreads))
+    , numOfThreads_(std::max(1u, numOfThreads))
+    {
+        indexRules();
+    }
+
+    SolverSpGEMM::SolverSpGEMM(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads, bool sharedSets)
+    : grammar_(grammar)
+    , graph_(new GraphCSR(edges, grammar, sharedSets, numOfThreads))
+    , numOfThreads_(std::max(1u, numOfThreads))
+    {
+        indexRules();
+    }
+
+    SolverSpGEMM::~SolverSpGEMM()
+    {
+        delete graph_;
+    }
+
+    void SolverSpGEMM::indexRules()
+    {
+        uint labelSize = grammar_.getLabelSize();
+        unary_.assign(labelSize, {});
+        binary_.assign(labelSize, {});
+        for (const auto& rule : grammar_.getRule2())
+        {
+            unary_[rule[0]].push_back(rule[1]);
+        }
+        for (const auto& rule : grammar_.getRule3())
+        {
+            binary_[rule[0]].emplace_back(rule[1], rule[2]);
+        }
+        for (uint A = 0; A < labelSize; A++)
+        {
+            if (!unary_[A].empty() || !binary_[A].empty()) derived_.push_back(A);
+        }
+        workspaces_.assign(numOfThreads_, Workspace());
+
+        if (!graph_->sharedSets()) return;
+        productOf_.assign(labelSize, {});
+        for (uint A = 0; A < labelSize; A++)
+        {
+            for (const auto& rule : binary_[A])
+            {
+                auto same = [&rule](const Product& product) { return product.B == rule.first && product.C == rule.second; };
+                auto it = std::find_if(products_.begin(), products_.end(), same);
+                productOf_[A].push_back(it - products_.begin());
+                if (it == products_.end()) products_.push_back({rule.first, rule.second, {}, {}, {}});
+            }
+        }
+    }
+
+    void SolverSpGEMM::runCFL()
+    {
+        uint itr = 0;
+        ull derived;
+
+        for (const auto& rule : grammar_.getRule1())
+        {
+            graph_->addSelfEdges(rule[0]); // add epsilon edges
+        }
+        do {
+            itr++;
+            derived = runSingleIteration();
+            std::cout << "Iteration " << itr << std::endl;
+        } while (derived > 0);
+
+        if (graph_->sharedSets())
+        {
+            std::cout << "Shared sets\t= " << graph_->pool().distinct() << " sets of " << graph_->pool().entries()
+                      << " entries for " << graph_->countOldRows() << " rows" << std::endl;
+        }
+    }
+
+    ull SolverSpGEMM::runSingleIteration()
+    {
+        uint nodeSize = graph_->getNodeSize();
+        uint labelSize = grammar_.getLabelSize();
+
+        for (Workspace& ws : workspaces_)
+        {
+            ws.runs.clear();
+            ws.entries.clear();
+        }
+        if (graph_->sharedSets()) prepareProducts();
+        #pragma omp parallel num_threads(numOfThreads_)
+        {
+            Workspace& ws = workspaces_[omp_get_thread_num()];
+            #pragma omp for schedule(dynamic, ROW_CHUNK)
+            for (uint i = 0; i < nodeSize; i++)
+            {
+                for (uint A : derived_)
+                {
+                    multiplyRow(i, A, ws);
+                }
+            }
+        }
+
+        // every (label, row) has at most one run, so the runs size the new deltas directly
+        std::vector<CSRMatrix> added(labelSize);
+        ull derived = 0;
+        for (const Workspace& ws : workspaces_)
+        {
+            for (const Run& run : ws.runs)
+            {
+                CSRMatrix& matrix = added[run.label];
+                if (matrix.rowPtr.empty()) matrix.rowPtr.assign(nodeSize + 1, 0);
+                matrix.rowPtr[run.row + 1] = run.count;
+            }
+            derived += ws.entries.size();
+        }
+        for (CSRMatrix& matrix : added)
+        {
+            if (matrix.rowPtr.empty()) continue;
+            for (uint v = 0; v < nodeSize; v++)
+            {
+                matrix.rowPtr[v + 1] += matrix.rowPtr[v];
+            }
+            matrix.colIdx.resize(matrix.rowPtr[nodeSize]);
+        }
+        #pragma omp parallel for schedule(static, 1) num_threads(numOfThreads_)
+        for (uint t = 0; t < workspaces_.size(); t++)
+        {
+            const Workspace& ws = workspaces_[t];
+            for (const Run& run : ws.runs)
+            {
+                CSRMatrix& matrix = added[run.label];
+                std::copy(ws.entries.begin() + run.offset, ws.entries.begin() + run.offset + run.count,
+                          matrix.colIdx.begin() + matrix.rowPtr[run.row]);
+            }
+        }
+
+        for (uint label = 0; label < labelSize; label++)
+        {
+            graph_->merge(label, std::move(added[label]));
+        }
+        return derived;
+    }
+
+    void SolverSpGEMM::prepareProducts()
+    {
+        uint nodeSize = graph_->getNodeSize();
+        uint capacity = graph_->pool().capacity();
+        for (Workspace& ws : workspaces_)
+        {
+            ws.setStamp.resize(capacity, 0);
+        }
+        for (Product& product : products_)
+        {
+            // only the entries of the last iteration are reset, the index is as large as the pool
+            for (uint id : product.ids)
+            {
+                product.index[id] = NONE;
+            }
+            product.index.resize(capacity, NONE);
+            product.ids.clear();
+            const CSRMatrix& deltaC = graph_->delta_[product.C];
+            if (deltaC.empty()) continue;
+
+            for (uint v = 0; v < nodeSize; v++)
+            {
+                uint id = graph_->oldSet(product.B, v);
+                if (id == SetPool::EMPTY || product.index[id] != NONE) continue;
+                product.index[id] = product.ids.size();
+                product.ids.push_back(id);
+            }
+            if (product.sets.size() < product.ids.size()) product.sets.resize(product.ids.size());
+            #pragma omp parallel for schedule(dynamic, ROW_CHUNK) num_threads(numOfThreads_)
+            for (size_t k = 0; k < product.ids.size(); k++)
+            {
+                std::vector<uint>& out = product.sets[k];
+                out.clear();
+                for (uint mid : graph_->pool().get(product.ids[k]))
+                {
+                    if (deltaC.rowSize(mid)) out.insert(out.end(), deltaC.row(mid), deltaC.row(mid) + deltaC.rowSize(mid));
+                }
+                std::sort(out.begin(), out.end());
+                out.erase(std::unique(out.begin(), out.end()), out.end());
+            }
+        }
+    }
+
+    void SolverSpGEMM::multiplyRow(uint i, uint A, Workspace& ws)
+    {
+        const std::vector<CSRMatrix>& delta = graph_->delta_;
+        const bool shared = graph_->sharedSets();
+        auto append = [&ws](const CSRMatrix& matrix, uint row) {
+            ull size = matrix.rowSize(row);
+            if (size) ws.candidates.insert(ws.candidates.end(), matrix.row(row), matrix.row(row) + size);
+        };
+        auto appendOld = [this, &ws, shared](uint label, uint row) {
+            ull size = graph_->oldRowSize(label, row);
+            if (size == 0) return;
+            if (shared)
+            {
+                // middle vertices sharing a set contribute it once
+                uint id = graph_->oldSet(label, row);
+                if (ws.setStamp[id] == ws.currentSet) return;
+                ws.setStamp[id] = ws.currentSet;
+            }
+            ws.candidates.insert(ws.candidates.end(), graph_->oldRow(label, row), graph_->oldRow(label, row) + size);
+        };
+        if (shared && ++ws.currentSet == 0)
+        {
+            std::fill(ws.setStamp.begin(), ws.setStamp.end(), 0);
+            ws.currentSet = 1;
+        }
+
+        // expand: ΔB for A ::= B, ΔB·(C_old ∪ ΔC) and B_old·ΔC for A ::= B C
+        ws.candidates.clear();
+        for (uint B : unary_[A])
+        {
+            append(delta[B], i);
+        }
+        for (size_t r = 0; r < binary_[A].size(); r++)
+        {
+            uint B = binary_[A][r].first;
+            uint C = binary_[A][r].second;
+            const CSRMatrix& deltaB = delta[B];
+            const CSRMatrix& deltaC = delta[C];
+            for (ull k = 0; k < deltaB.rowSize(i); k++)
+            {
+                uint mid = deltaB.row(i)[k];
+                appendOld(C, mid);
+                append(deltaC, mid);
+            }
+            if (deltaC.empty()) continue;
+            if (shared)
+            {
+                const Product& product = products_[productOf_[A][r]];
+                uint id = graph_->oldSet(B, i);
+                if (id == SetPool::EMPTY) continue;
+                const std::vector<uint>& set = product.sets[product.index[id]];
+                ws.candidates.insert(ws.candidates.end(), set.begin(), set.end());
+                continue;
+            }
+            for (ull k = 0; k < graph_->oldRowSize(B, i); k++)
+            {
+                append(deltaC, graph_->oldRow(B, i)[k]);
+            }
+        }
+        if (ws.candidates.empty()) return;
+
+        // compress against the mask, the known edges of A from i
+        const CSRMatrix& deltaA = delta[A];
+        const uint* oldRow = graph_->oldRowSize(A, i) ? graph_->oldRow(A, i) : nullptr;
+        const uint* oldEnd = oldRow ? oldRow + graph_->oldRowSize(A, i) : nullptr;
+        const uint* deltaRow = deltaA.rowSize(i) ? deltaA.row(i) : nullptr;
+        const uint* deltaEnd = deltaRow ? deltaRow + deltaA.rowSize(i) : nullptr;
+        size_t offset = ws.entries.size();
+        if (ws.candidates.size() <= SPARSE_ROW_LIMIT)
+        {
+            std::sort(ws.candidates.begin(), ws.candidates.end());
+            auto last = std::unique(ws.candidates.begin(), ws.candidates.end());
+            for (auto it = ws.candidates.begin(); it != last; ++it)
+            {
+                if (std::binary_search(oldRow, oldEnd, *it) || std::binary_search(deltaRow, deltaEnd, *it)) continue;
+                ws.entries.push_back(*it);
+            }
+        }
+        else
+        {
+            if (ws.stamp.empty()) ws.stamp.assign(graph_->getNodeSize(), 0);
+            if (++ws.current == 0)
+            {
+                std::fill(ws.stamp.begin(), ws.stamp.end(), 0);
+                ws.current = 1;
+            }
+            for (const uint* p = oldRow; p != oldEnd; p++) ws.stamp[*p] = ws.current;
+            for (const uint* p = deltaRow; p != deltaEnd; p++) ws.stamp[*p] = ws.current;
+            for (uint v : ws.candidates)
+            {
+                if (ws.stamp[v] == ws.current) continue;
+                ws.stamp[v] = ws.current;
+                ws.entries.push_back(v);
+            }
+            std::sort(ws.entries.begin() + offset, ws.entries.end());
+        }
+        if (ws.entries.size() > offset)
+        {
+            ws.runs.push_back({A, i, offset, ws.entries.size() - offset});
+        }
+    }
+
+    ull SolverSpGEMM::getEdgeCount()
+    {
+        return graph_->countEdge();
+    }
+}
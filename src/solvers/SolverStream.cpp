@@ -0,0 +1,227 @@
+#include <iostream>
+#include <algorithm>
+#include "solvers/SolverStream.hpp"
+
+namespace gracfl
+{
+    SolverStream::SolverStream(std::string graphfilepath, Grammar& grammar, uint numOfThreads)
+    : grammar_(grammar)
+    , graph_(new GraphStream(graphfilepath, grammar, numOfThreads))
+    , numOfThreads_(std::max(1u, numOfThreads))
+    {
+        indexRules();
+    }
+
+    SolverStream::SolverStream(std::vector<Edge>& edges, Grammar& grammar, uint numOfThreads)
+    : grammar_(grammar)
+    , graph_(new GraphStream(edges, grammar, numOfThreads))
+    , numOfThreads_(std::max(1u, numOfThreads))
+    {
+        indexRules();
+    }
+
+    SolverStream::~SolverStream()
+    {
+        delete graph_;
+    }
+
+    void SolverStream::indexRules()
+    {
+        uint labelSize = grammar_.getLabelSize();
+        unary_.assign(labelSize, {});
+        binary_.assign(labelSize, {});
+        for (const auto& rule : grammar_.getRule2())
+        {
+            unary_[rule[0]].push_back(rule[1]);
+        }
+        for (const auto& rule : grammar_.getRule3())
+        {
+            binary_[rule[0]].emplace_back(rule[1], rule[2]);
+        }
+        for (uint A = 0; A < labelSize; A++)
+        {
+            if (!unary_[A].empty() || !binary_[A].empty()) derived_.push_back(A);
+        }
+        size_t buffers = derived_.size() * graph_->numPartitions();
+        shuffle_.assign(numOfThreads_, std::vector<std::vector<ull>>(buffers));
+    }
+
+    void SolverStream::runCFL()
+    {
+        uint itr = 0;
+        ull derived;
+
+        for (const auto& rule : grammar_.getRule1())
+        {
+            graph_->addSelfEdges(rule[0]); // add epsilon edges
+        }
+        do {
+            itr++;
+            derived = runSingleIteration();
+            std::cout << "Iteration " << itr << std::endl;
+        } while (derived > 0);
+    }
+
+    ull SolverStream::runSingleIteration()
+    {
+        const std::vector<EdgeArrays>& old = graph_->old_;
+        const std::vector<EdgeArrays>& delta = graph_->delta_;
+        const uint parts = graph_->numPartitions();
+        const uint slots = derived_.size();
+
+        // the streams of this iteration: ΔB for A ::= B, ΔB·C_old, ΔB·ΔC and B_old·ΔC for A ::= B C
+        std::vector<Join> joins;
+        for (uint slot = 0; slot < slots; slot++)
+        {
+            uint A = derived_[slot];
+            for (uint B : unary_[A])
+            {
+                if (!delta[B].empty()) joins.push_back({slot, &delta[B].bySource, nullptr});
+            }
+            for (const auto& rule : binary_[A])
+            {
+                const EdgeArrays& deltaB = delta[rule.first];
+                const EdgeArrays& oldB = old[rule.first];
+                const EdgeArrays& oldC = old[rule.second];
+                const EdgeArrays& deltaC = delta[rule.second];
+                if (!deltaB.empty() && !oldC.empty()) joins.push_back({slot, &deltaB.byTarget, &oldC.bySource});
+                if (!deltaB.empty() && !deltaC.empty()) joins.push_back({slot, &deltaB.byTarget, &deltaC.bySource});
+                if (!oldB.empty() && !deltaC.empty()) joins.push_back({slot, &oldB.byTarget, &deltaC.bySource});
+            }
+        }
+
+        #pragma omp parallel num_threads(numOfThreads_)
+        {
+            std::vector<std::vector<ull>>& shuffle = shuffle_[omp_get_thread_num()];
+            #pragma omp for schedule(dynamic, 1)
+            for (ull unit = 0; unit < joins.size() * parts; unit++)
+            {
+                streamPartition(joins[unit / parts], unit % parts, shuffle);
+            }
+        }
+
+        // gather every (label, source partition) from the threads, sort it, and drop duplicates
+        // and known edges in one merge scan against the partition of the label's arrays
+        std::vector<std::vector<ull>> added(static_cast<size_t>(slots) * parts);
+        ull derived = 0;
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(numOfThreads_) reduction(+:derived)
+        for (ull unit = 0; unit < added.size(); unit++)
+        {
+            std::vector<ull>& keys = added[unit];
+            size_t total = 0;
+            for (const auto& shuffle : shuffle_)
+            {
+                total += shuffle[unit].size();
+            }
+            if (total == 0) continue;
+            keys.reserve(total);
+            for (auto& shuffle : shuffle_)
+            {
+                keys.insert(keys.end(), shuffle[unit].begin(), shuffle[unit].end());
+                shuffle[unit].clear();
+            }
+            std::sort(keys.begin(), keys.end());
+
+            uint A = derived_[unit / parts];
+            uint p = unit % parts;
+            std::pair<ull, ull> oldRange = graph_->partitionRange(old[A].bySource, p);
+            std::pair<ull, ull> deltaRange = graph_->partitionRange(delta[A].bySource, p);
+            const ull* o = old[A].bySource.data() + oldRange.first;
+            const ull* oEnd = old[A].bySource.data() + oldRange.second;
+            const ull* d = delta[A].bySource.data() + deltaRange.first;
+            const ull* dEnd = delta[A].bySource.data() + deltaRange.second;
+            size_t kept = 0;
+            for (size_t k = 0; k < keys.size(); k++)
+            {
+                ull key = keys[k];
+                if (kept > 0 && keys[kept - 1] == key) continue;
+                while (o != oEnd && *o < key) o++;
+                while (d != dEnd && *d < key) d++;
+                if ((o != oEnd && *o == key) || (d != dEnd && *d == key)) continue;
+                keys[kept++] = key;
+            }
+            keys.resize(kept);
+            derived += kept;
+        }
+
+        // the partitions of a label are consecutive source ranges, so concatenated they are sorted
+        std::vector<std::vector<ull>> next(grammar_.getLabelSize());
+        for (uint slot = 0; slot < slots; slot++)
+        {
+            std::vector<ull> offsets(parts + 1, 0);
+            for (uint p = 0; p < parts; p++)
+            {
+                offsets[p + 1] = offsets[p] + added[static_cast<size_t>(slot) * parts + p].size();
+            }
+            std::vector<ull>& keys = next[derived_[slot]];
+            keys.resize(offsets[parts]);
+            #pragma omp parallel for schedule(dynamic, 1) num_threads(numOfThreads_)
+            for (uint p = 0; p < parts; p++)
+            {
+                std::vector<ull>& part = added[static_cast<size_t>(slot) * parts + p];
+                std::copy(part.begin(), part.end(), keys.begin() + offsets[p]);
+                std::vector<ull>().swap(part);
+            }
+        }
+        for (uint label = 0; label < grammar_.getLabelSize(); label++)
+        {
+            graph_->merge(label, std::move(next[label]));
+        }
+        return derived;
+    }
+
+    void SolverStream::streamPartition(const Join& join, uint p, std::vector<std::vector<ull>>& shuffle)
+    {
+        const uint parts = graph_->numPartitions();
+        std::vector<ull>* buffers = shuffle.data() + static_cast<size_t>(join.slot) * parts;
+        const std::vector<ull>& left = *join.left;
+        std::pair<ull, ull> l = graph_->partitionRange(left, p);
+        if (l.first == l.second) return;
+        if (join.right == nullptr)
+        {
+            // a unary stream is sorted by source already, its partition is a single buffer
+            buffers[p].insert(buffers[p].end(), left.begin() + l.first, left.begin() + l.second);
+            return;
+        }
+
+        // merge join on the middle vertex, the high half of both keys
+        const std::vector<ull>& right = *join.right;
+        std::pair<ull, ull> r = graph_->partitionRange(right, p);
+        ull i = l.first;
+        ull j = r.first;
+        while (i < l.second && j < r.second)
+        {
+            uint midLeft = uint(left[i] >> 32);
+            uint midRight = uint(right[j] >> 32);
+            if (midLeft < midRight)
+            {
+                i = std::lower_bound(left.begin() + i, left.begin() + l.second, ull(midRight) << 32) - left.begin();
+                continue;
+            }
+            if (midRight < midLeft)
+            {
+                j = std::lower_bound(right.begin() + j, right.begin() + r.second, ull(midLeft) << 32) - right.begin();
+                continue;
+            }
+            ull iEnd = i;
+            while (iEnd < l.second && uint(left[iEnd] >> 32) == midLeft) iEnd++;
+            ull jEnd = j;
+            while (jEnd < r.second && uint(right[jEnd] >> 32) == midRight) jEnd++;
+            for (; i < iEnd; i++)
+            {
+                uint source = uint(left[i]);
+                std::vector<ull>& buffer = buffers[graph_->partitionOf(source)];
+                for (ull k = j; k < jEnd; k++)
+                {
+                    buffer.push_back(COMBINE(source, uint(right[k])));
+                }
+            }
+            j = jEnd;
+        }
+    }
+
+    ull SolverStream::getEdgeCount()
+    {
+        return graph_->countEdge();
+    }
+}
@@ -0,0 +1,269 @@
+#include <cstdlib>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <omp.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#include "utils/Arena.hpp"
+
+namespace gracfl {
+    // chunk backing of all arenas, set by the driver before the graphs are built
+    static std::atomic<HugePages> hugePages(HugePages::Off);
+
+    void Arena::setHugePages(HugePages mode)
+    {
+        hugePages.store(mode, std::memory_order_relaxed);
+    }
+
+    HugePages Arena::getHugePages()
+    {
+        return hugePages.load(std::memory_order_relaxed);
+    }
+
+    // size class of a block: smallest c with 2^c >= bytes
+    static inline uint sizeClass(size_t bytes)
+    {
+        if (bytes <= Arena::MIN_BLOCK)
+        {
+            return 4;
+        }
+        return 64 - __builtin_clzll((unsigned long long)(bytes - 1));
+    }
+
+    Arena::~Arena()
+    {
+        release();
+    }
+
+    void* Arena::mapChunk(size_t bytes, bool explicitPages)
+    {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+        if (explicitPages)
+        {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED)
+            {
+                return p;
+            }
+            // no reserved huge pages left, fall back to transparent ones
+        }
+        // over-map by a huge page and trim, so the chunk starts on a huge page boundary
+        size_t span = bytes + HUGE_PAGE;
+        void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1);
+        if (aligned > start)
+        {
+            munmap(raw, aligned - start);
+        }
+        if (start + span > aligned + bytes)
+        {
+            munmap(reinterpret_cast<void*>(aligned + bytes), start + span - aligned - bytes);
+        }
+        madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+        return reinterpret_cast<void*>(aligned);
+#else
+        return nullptr;
+#endif
+    }
+
+    void* Arena::newChunk(size_t bytes)
+    {
+        HugePages mode = getHugePages();
+        void* chunk = nullptr;
+        bool mapped = false;
+        if (mode != HugePages::Off)
+        {
+            bytes = (bytes + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+            chunk = mapChunk(bytes, mode == HugePages::Explicit);
+            mapped = chunk != nullptr;
+        }
+        if (chunk == nullptr)
+        {
+            chunk = std::aligned_alloc(MIN_BLOCK, bytes);
+        }
+        if (chunk == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        chunks_.push_back({chunk, bytes, mapped});
+        reserved_ += bytes;
+        return chunk;
+    }
+
+    void* Arena::allocate(size_t bytes)
+    {
+        uint c = sizeClass(bytes);
+        if (freeLists_[c] != nullptr)
+        {
+            void* p = freeLists_[c];
+            freeLists_[c] = *static_cast<void**>(p);
+            return p;
+        }
+
+        size_t block = (size_t)1 << c;
+        size_t chunkSize = getHugePages() == HugePages::Off ? CHUNK_SIZE : HUGE_CHUNK_SIZE;
+        // blocks larger than a quarter chunk get a chunk of their own
+        if (block > chunkSize / 4)
+        {
+            return newChunk(block);
+        }
+        if (cur_ == nullptr || (size_t)(end_ - cur_) < block)
+        {
+            cur_ = static_cast<char*>(newChunk(chunkSize));
+            end_ = cur_ + chunkSize;
+        }
+        void* p = cur_;
+        cur_ += block;
+        return p;
+    }
+
+    void Arena::deallocate(void* p, size_t bytes)
+    {
+        uint c = sizeClass(bytes);
+        *static_cast<void**>(p) = freeLists_[c];
+        freeLists_[c] = p;
+    }
+
+    void Arena::release()
+    {
+        for (const Chunk& chunk : chunks_)
+        {
+#if defined(__linux__)
+            if (chunk.mapped)
+            {
+                munmap(chunk.p, chunk.bytes);
+                continue;
+            }
+#endif
+            std::free(chunk.p);
+        }
+        std::vector<Chunk>().swap(chunks_);
+        cur_ = end_ = nullptr;
+        for (uint c = 0; c < NUM_CLASSES; c++)
+        {
+            freeLists_[c] = nullptr;
+        }
+        reserved_ = 0;
+    }
+
+    ArenaPool::ArenaPool()
+    {
+        int threads = omp_get_max_threads();
+        slots_.resize(threads > 0 ? threads : 1);
+        for (auto& slot : slots_)
+        {
+            slot = new Slot();
+        }
+    }
+
+    ArenaPool::~ArenaPool()
+    {
+        for (auto slot : slots_)
+        {
+            delete slot;
+        }
+    }
+
+    Arena& ArenaPool::local()
+    {
+        return slots_[(uint)omp_get_thread_num() % slots_.size()]->arena;
+    }
+
+    void* ArenaPool::allocate(size_t bytes)
+    {
+        Arena& arena = local();
+        while (arena.lock_.test_and_set(std::memory_order_acquire)) {}
+        void* p = nullptr;
+        try {
+            p = arena.allocate(bytes);
+        } catch (...) {
+            arena.lock_.clear(std::memory_order_release);
+            throw;
+        }
+        arena.lock_.clear(std::memory_order_release);
+        return p;
+    }
+
+    void ArenaPool::deallocate(void* p, size_t bytes)
+    {
+        if (teardown_)
+        {
+            return;
+        }
+        // a block may be recycled by any arena, all of them are released together
+        Arena& arena = local();
+        while (arena.lock_.test_and_set(std::memory_order_acquire)) {}
+        arena.deallocate(p, bytes);
+        arena.lock_.clear(std::memory_order_release);
+    }
+
+    void ArenaPool::release()
+    {
+        for (auto slot : slots_)
+        {
+            slot->arena.release();
+        }
+        teardown_ = false;
+    }
+
+    size_t ArenaPool::getReservedBytes() const
+    {
+        size_t bytes = 0;
+        for (auto slot : slots_)
+        {
+            bytes += slot->arena.getReservedBytes();
+        }
+        return bytes;
+    }
+
+    HugePageUsage getHugePageUsage()
+    {
+        HugePageUsage usage;
+        std::ifstream smaps("/proc/self/smaps");
+        std::string line;
+        size_t rss = 0, anonHuge = 0, hugetlb = 0;
+        while (std::getline(smaps, line))
+        {
+            std::istringstream fields(line);
+            std::string key;
+            fields >> key;
+            if (key == "VmFlags:")
+            {
+                // the last line of a mapping: hg = advised for THP, ht = hugetlb
+                std::string flag;
+                bool advised = false, pool = false;
+                while (fields >> flag)
+                {
+                    advised |= flag == "hg";
+                    pool |= flag == "ht";
+                }
+                if (pool)
+                {
+                    usage.residentBytes += hugetlb;
+                    usage.hugeBytes += hugetlb;
+                }
+                else if (advised)
+                {
+                    usage.residentBytes += rss;
+                    usage.hugeBytes += anonHuge;
+                }
+                rss = anonHuge = hugetlb = 0;
+                continue;
+            }
+            size_t kb = 0;
+            fields >> kb;
+            if (key == "Rss:") rss = kb << 10;
+            else if (key == "AnonHugePages:") anonHuge = kb << 10;
+            else if (key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") hugetlb += kb << 10;
+        }
+        return usage;
+    }
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include "utils/Bdd.hpp"
+
+namespace gracfl
+{
+    BddManager::BddManager(uint numLevels, uint initialNodes)
+    : numLevels_(numLevels)
+    {
+        uint size = 1024;
+        while (size < initialNodes) size *= 2;
+        nodes_.resize(size);
+        nodes_[FALSE] = {numLevels_, FALSE, FALSE, NIL};
+        nodes_[TRUE] = {numLevels_, TRUE, TRUE, NIL};
+        live_ = 2;
+        for (Node n = size - 1; n >= 2; n--)
+        {
+            nodes_[n] = {DEAD, FALSE, FALSE, free_};
+            free_ = n;
+        }
+        buckets_.assign(size, NIL);
+        cache_.assign(size / 2, CacheEntry{OP_NONE, 0, 0, 0, 0});
+    }
+
+    BddManager::Node BddManager::literal(uint level, bool positive)
+    {
+        return positive ? mk(level, FALSE, TRUE) : mk(level, TRUE, FALSE);
+    }
+
+    BddManager::Node BddManager::mk(uint level, Node low, Node high)
+    {
+        if (low == high) return low;
+        ull bucket = hashOf(level, low, high);
+        for (Node n = buckets_[bucket]; n != NIL; n = nodes_[n].next)
+        {
+            if (nodes_[n].level == level && nodes_[n].low == low && nodes_[n].high == high) return n;
+        }
+        if (free_ == NIL)
+        {
+            grow();
+            bucket = hashOf(level, low, high);
+        }
+        Node n = free_;
+        free_ = nodes_[n].next;
+        nodes_[n] = {level, low, high, buckets_[bucket]};
+        buckets_[bucket] = n;
+        live_++;
+        return n;
+    }
+
+    void BddManager::grow()
+    {
+        // new nodes join the free list, the indices of the old ones stay valid
+        uint size = nodes_.size();
+        nodes_.resize(static_cast<size_t>(size) * 2);
+        for (Node n = size * 2 - 1; n >= size; n--)
+        {
+            nodes_[n] = {DEAD, FALSE, FALSE, free_};
+            free_ = n;
+        }
+        buckets_.assign(nodes_.size(), NIL);
+        rehash();
+        cache_.assign(nodes_.size() / 2, CacheEntry{OP_NONE, 0, 0, 0, 0});
+    }
+
+    void BddManager::rehash()
+    {
+        std::fill(buckets_.begin(), buckets_.end(), NIL);
+        for (Node n = 2; n < nodes_.size(); n++)
+        {
+            if (nodes_[n].level == DEAD) continue;
+            ull bucket = hashOf(nodes_[n].level, nodes_[n].low, nodes_[n].high);
+            nodes_[n].next = buckets_[bucket];
+            buckets_[bucket] = n;
+        }
+    }
+
+    BddManager::Node BddManager::conjoin(Node a, Node b)
+    {
+        return apply(OP_AND, a, b);
+    }
+
+    BddManager::Node BddManager::disjoin(Node a, Node b)
+    {
+        return apply(OP_OR, a, b);
+    }
+
+    BddManager::Node BddManager::subtract(Node a, Node b)
+    {
+        return apply(OP_DIFF, a, b);
+    }
+
+    BddManager::Node BddManager::apply(uint op, Node a, Node b)
+    {
+        switch (op)
+        {
+        case OP_AND:
+            if (a == FALSE || b == FALSE) return FALSE;
+            if (a == TRUE || a == b) return b;
+            if (b == TRUE) return a;
+            if (a > b) std::swap(a, b);
+            break;
+        case OP_OR:
+            if (a == TRUE || b == TRUE) return TRUE;
+            if (a == FALSE || a == b) return b;
+            if (b == FALSE) return a;
+            if (a > b) std::swap(a, b);
+            break;
+        case OP_DIFF:
+            if (a == FALSE || b == TRUE || a == b) return FALSE;
+            if (b == FALSE) return a;
+            break;
+        }
+        const CacheEntry& entry = cacheSlot(op, a, b, 0);
+        if (entry.op == op && entry.a == a && entry.b == b && entry.c == 0) return entry.result;
+
+        uint top = std::min(level(a), level(b));
+        Node a0 = level(a) == top ? low(a) : a;
+        Node a1 = level(a) == top ? high(a) : a;
+        Node b0 = level(b) == top ? low(b) : b;
+        Node b1 = level(b) == top ? high(b) : b;
+        Node r0 = apply(op, a0, b0);
+        Node r1 = apply(op, a1, b1);
+        Node result = mk(top, r0, r1);
+        cacheSlot(op, a, b, 0) = {op, a, b, 0, result};
+        return result;
+    }
+
+    BddManager::Node BddManager::ite(Node f, Node g, Node h)
+    {
+        if (f == TRUE || g == h) return g;
+        if (f == FALSE) return h;
+        if (g == TRUE && h == FALSE) return f;
+        const CacheEntry& entry = cacheSlot(OP_ITE, f, g, h);
+        if (entry.op == OP_ITE && entry.a == f && entry.b == g && entry.c == h) return entry.result;
+
+        uint top = std::min({level(f), level(g), level(h)});
+        auto cofactor = [this, top](Node n, bool positive) {
+            return level(n) != top ? n : positive ? high(n) : low(n);
+        };
+        Node f0 = cofactor(f, false), f1 = cofactor(f, true);
+        Node g0 = cofactor(g, false), g1 = cofactor(g, true);
+        Node h0 = cofactor(h, false), h1 = cofactor(h, true);
+        Node r0 = ite(f0, g0, h0);
+        Node r1 = ite(f1, g1, h1);
+        Node result = mk(top, r0, r1);
+        cacheSlot(OP_ITE, f, g, h) = {OP_ITE, f, g, h, result};
+        return result;
+    }
+
+    BddManager::Node BddManager::cube(std::vector<uint> levels)
+    {
+        std::sort(levels.begin(), levels.end());
+        Node result = TRUE;
+        for (auto it = levels.rbegin(); it != levels.rend(); ++it)
+        {
+            result = mk(*it, FALSE, result);
+        }
+        return result;
+    }
+
+    BddManager::Node BddManager::relprod(Node a, Node b, Node cube)
+    {
+        if (a == FALSE || b == FALSE) return FALSE;
+        if (a == TRUE && b == TRUE) return TRUE;
+        uint top = std::min(level(a), level(b));
+        // levels of the cube above both operands have nothing to quantify
+        while (level(cube) < top) cube = high(cube);
+        if (cube == TRUE) return conjoin(a, b);
+        if (a > b) std::swap(a, b);
+        const CacheEntry& entry = cacheSlot(OP_RELPROD, a, b, cube);
+        if (entry.op == OP_RELPROD && entry.a == a && entry.b == b && entry.c == cube) return entry.result;
+
+        Node a0 = level(a) == top ? low(a) : a;
+        Node a1 = level(a) == top ? high(a) : a;
+        Node b0 = level(b) == top ? low(b) : b;
+        Node b1 = level(b) == top ? high(b) : b;
+        Node result;
+        if (level(cube) == top)
+        {
+            Node rest = high(cube);
+            Node r0 = relprod(a0, b0, rest);
+            result = r0 == TRUE ? TRUE : disjoin(r0, relprod(a1, b1, rest));
+        }
+        else
+        {
+            Node r0 = relprod(a0, b0, cube);
+            Node r1 = relprod(a1, b1, cube);
+            result = mk(top, r0, r1);
+        }
+        cacheSlot(OP_RELPROD, a, b, cube) = {OP_RELPROD, a, b, cube, result};
+        return result;
+    }
+
+    uint BddManager::addRenaming(const std::vector<uint>& map)
+    {
+        renamings_.push_back(map);
+        return renamings_.size() - 1;
+    }
+
+    BddManager::Node BddManager::replace(Node f, uint renaming)
+    {
+        if (f == FALSE || f == TRUE) return f;
+        const CacheEntry& entry = cacheSlot(OP_REPLACE, f, renaming, 0);
+        if (entry.op == OP_REPLACE && entry.a == f && entry.b == renaming) return entry.result;
+
+        uint target = renamings_[renaming][level(f)];
+        Node f0 = low(f);
+        Node f1 = high(f);
+        Node r0 = replace(f0, renaming);
+        Node r1 = replace(f1, renaming);
+        // a renaming that keeps the order below this node just relabels it, otherwise the
+        // variable moves past others and the node is rebuilt with ite
+        Node result = target < level(r0) && target < level(r1) ? mk(target, r0, r1)
+                                                                : ite(literal(target), r1, r0);
+        cacheSlot(OP_REPLACE, f, renaming, 0) = {OP_REPLACE, f, renaming, 0, result};
+        return result;
+    }
+
+    double BddManager::satCount(Node f)
+    {
+        // count(n) is over the levels from level(n) down
+        std::unordered_map<Node, double> memo;
+        std::function<double(Node)> count = [&](Node n) -> double {
+            if (n == FALSE) return 0.0;
+            if (n == TRUE) return 1.0;
+            auto it = memo.find(n);
+            if (it != memo.end()) return it->second;
+            Node n0 = low(n), n1 = high(n);
+            double c = std::ldexp(count(n0), level(n0) - level(n) - 1) + std::ldexp(count(n1), level(n1) - level(n) - 1);
+            memo.emplace(n, c);
+            return c;
+        };
+        return std::ldexp(count(f), level(f));
+    }
+
+    void BddManager::forEachPath(Node f, const std::function<void(const std::vector<int8_t>&)>& visit)
+    {
+        std::vector<int8_t> values(numLevels_, -1);
+        std::function<void(Node)> walk = [&](Node n) {
+            if (n == FALSE) return;
+            if (n == TRUE)
+            {
+                visit(values);
+                return;
+            }
+            uint l = level(n);
+            values[l] = 0;
+            walk(low(n));
+            values[l] = 1;
+            walk(high(n));
+            values[l] = -1;
+        };
+        walk(f);
+    }
+
+    void BddManager::collect(const std::vector<Node>& roots)
+    {
+        std::vector<bool> marked(nodes_.size(), false);
+        std::vector<Node> stack(roots.begin(), roots.end());
+        while (!stack.empty())
+        {
+            Node n = stack.back();
+            stack.pop_back();
+            if (n < 2 || marked[n]) continue;
+            marked[n] = true;
+            stack.push_back(nodes_[n].low);
+            stack.push_back(nodes_[n].high);
+        }
+        for (Node n = nodes_.size() - 1; n >= 2; n--)
+        {
+            if (marked[n] || nodes_[n].level == DEAD) continue;
+            nodes_[n] = {DEAD, FALSE, FALSE, free_};
+            free_ = n;
+            live_--;
+        }
+        rehash();
+        std::fill(cache_.begin(), cache_.end(), CacheEntry{OP_NONE, 0, 0, 0, 0});
+    }
+}
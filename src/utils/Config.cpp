@@ -14,14 +14,48 @@
 // grammarFilePath  = /home/user/data/grammar.cfg
 
 // # Optional settings (defaults shown):
-// executionMode     = parallel          # serial or parallel
-// traversalDirection   = fw                # fw, bw, or bi
-// processingStrategy = topo-driven       # gram-driven or topo-driven
+// executionMode     = parallel          # serial, parallel, distributed or auto
+// traversalDirection   = fw                # fw, bw, bi or auto
+// processingStrategy = topo-driven       # gram-driven, topo-driven, spgemm, bitmatrix, stream, bdd, hybrid or auto
 // numThreads  = 8                 # positive integer, only used in parallel mode
+// numaAware   = false             # true or false, only used in parallel mode
+// asynchronous = false            # true or false, bi + gram-driven in serial or parallel mode
+// dyckSolver  = auto              # auto, on or off
+// sccContraction = false          # true or false
+// cycleCollapsing = false         # true or false, fw + gram-driven in serial or parallel mode
+// nodeMerging = false             # true or false
+// vertexOrder = none              # none, degree, rcm or community
+// calibration = false             # true or false, only used with auto settings
+// prefetchDistance = 8            # 0 to 256, 0 disables, only used by fw and bw
+// sweepOrder  = vertex            # vertex or label, fw + gram-driven or bw + gram-driven only
+// hugePages   = off               # off, transparent or explicit
+// stratified  = false             # true or false, serial bi gram-driven (or auto) only
+// outputLabels =                  # comma-separated labels, only used if stratified (default: all)
+// bitKernel   = four-russians     # four-russians or naive, only used by bitmatrix
+// sharedSets  = false             # true or false, only used by spgemm
+// bddOrder    = interleaved       # interleaved or sequential, only used by bdd
 
 
 namespace gracfl {
 
+// helper to parse a boolean setting
+static bool parseBool(const std::string& key, const std::string& val) {
+    if (val == "true" || val == "1" || val == "on")
+        return true;
+    if (val == "false" || val == "0" || val == "off")
+        return false;
+    throw std::runtime_error("Invalid " + key + " value: " + val + " (expected true or false)");
+}
+
+// helper to check that stratified evaluation is possible: only SolverBIGram solves strata, "auto"
+// settings are narrowed to it by the solver selection
+static bool stratifiable(const Config& config) {
+    return (config.executionMode == "serial" || config.executionMode == "auto") &&
+           (config.traversalDirection == "bi" || config.traversalDirection == "auto") &&
+           (config.processingStrategy == "gram-driven" || config.processingStrategy == "auto") &&
+           !config.asynchronous && config.dyckSolver != "on";
+}
+
 // helper to trim both ends in-place
 static void trim(std::string& s) {
     auto not_space = [](int ch){ return !std::isspace(ch); };
@@ -87,6 +121,58 @@ void Config::loadFromFile(const std::string& filename) {
                 throw std::runtime_error("Invalid numThreads value: " + val);
             }
         }
+        else if (key == "numaAware") {
+            numaAware = parseBool(key, val);
+        }
+        else if (key == "asynchronous") {
+            asynchronous = parseBool(key, val);
+        }
+        else if (key == "dyckSolver") {
+            dyckSolver = val;
+        }
+        else if (key == "sccContraction") {
+            sccContraction = parseBool(key, val);
+        }
+        else if (key == "cycleCollapsing") {
+            cycleCollapsing = parseBool(key, val);
+        }
+        else if (key == "nodeMerging") {
+            nodeMerging = parseBool(key, val);
+        }
+        else if (key == "vertexOrder") {
+            vertexOrder = val;
+        }
+        else if (key == "calibration") {
+            calibration = parseBool(key, val);
+        }
+        else if (key == "prefetchDistance") {
+            try {
+                prefetchDistance = static_cast<unsigned>(std::stoul(val));
+            } catch (...) {
+                throw std::runtime_error("Invalid prefetchDistance value: " + val);
+            }
+        }
+        else if (key == "sweepOrder") {
+            sweepOrder = val;
+        }
+        else if (key == "hugePages") {
+            hugePages = val;
+        }
+        else if (key == "stratified") {
+            stratified = parseBool(key, val);
+        }
+        else if (key == "outputLabels") {
+            outputLabels = val;
+        }
+        else if (key == "bitKernel") {
+            bitKernel = val;
+        }
+        else if (key == "sharedSets") {
+            sharedSets = parseBool(key, val);
+        }
+        else if (key == "bddOrder") {
+            bddOrder = val;
+        }
         else {
             throw std::runtime_error("Unknown config key: " + key);
         }
@@ -101,29 +187,68 @@ void Config::loadFromFile(const std::string& filename) {
     // apply defaults & validate
     if (executionMode.empty())
         executionMode = "serial";
-    else if (executionMode != "serial" && executionMode != "parallel")
-        throw std::runtime_error("executionMode must be 'serial' or 'parallel'");
+    else if (executionMode != "serial" && executionMode != "parallel" &&
+             executionMode != "distributed" && executionMode != "auto")
+        throw std::runtime_error("executionMode must be 'serial', 'parallel', 'distributed' or 'auto'");
 
     if (traversalDirection.empty())
-        traversalDirection = (executionMode == "parallel" ? "fw" : "bi");
+        traversalDirection = (executionMode == "parallel" ? "fw" : executionMode == "auto" ? "auto" : "bi");
     else if (traversalDirection != "fw" &&
              traversalDirection != "bw" &&
-             traversalDirection != "bi")
+             traversalDirection != "bi" &&
+             traversalDirection != "auto")
     {
-        throw std::runtime_error("traversalDirection must be 'fw', 'bw', or 'bi'");
+        throw std::runtime_error("traversalDirection must be 'fw', 'bw', 'bi' or 'auto'");
     }
 
     if (processingStrategy.empty())
-        processingStrategy = "gram-driven";
+        processingStrategy = (executionMode == "auto" ? "auto" : "gram-driven");
     else if (processingStrategy != "gram-driven" &&
-             processingStrategy != "topo-driven")
+             processingStrategy != "topo-driven" &&
+             processingStrategy != "spgemm" &&
+             processingStrategy != "bitmatrix" &&
+             processingStrategy != "stream" &&
+             processingStrategy != "bdd" &&
+             processingStrategy != "hybrid" &&
+             processingStrategy != "auto")
     {
-        throw std::runtime_error("processingStrategy must be 'gram-driven' or 'topo-driven'");
+        throw std::runtime_error("processingStrategy must be 'gram-driven', 'topo-driven', 'spgemm', 'bitmatrix', 'stream', 'bdd', 'hybrid' or 'auto'");
     }
 
-    if (executionMode == "parallel" && numThreads <= 0) {
+    if ((executionMode == "parallel" || executionMode == "auto") && numThreads <= 0) {
         throw std::runtime_error("numThreads must be a positive integer");
     }
+
+    if (dyckSolver != "auto" && dyckSolver != "on" && dyckSolver != "off")
+        throw std::runtime_error("dyckSolver must be 'auto', 'on' or 'off'");
+
+    if (vertexOrder != "none" && vertexOrder != "degree" && vertexOrder != "rcm" && vertexOrder != "community")
+        throw std::runtime_error("vertexOrder must be 'none', 'degree', 'rcm' or 'community'");
+
+    if (prefetchDistance > 256)
+        throw std::runtime_error("prefetchDistance must be at most 256");
+
+    if (sweepOrder != "vertex" && sweepOrder != "label")
+        throw std::runtime_error("sweepOrder must be 'vertex' or 'label'");
+
+    if (hugePages != "off" && hugePages != "transparent" && hugePages != "explicit")
+        throw std::runtime_error("hugePages must be 'off', 'transparent' or 'explicit'");
+
+    if (bitKernel != "four-russians" && bitKernel != "naive")
+        throw std::runtime_error("bitKernel must be 'four-russians' or 'naive'");
+
+    if (bddOrder != "interleaved" && bddOrder != "sequential")
+        throw std::runtime_error("bddOrder must be 'interleaved' or 'sequential'");
+
+    if (!outputLabels.empty() && !stratified)
+        throw std::runtime_error("outputLabels requires stratified = true");
+
+    if (stratified && !stratifiable(*this))
+        throw std::runtime_error("stratified requires executionMode = serial, traversalDirection = bi and "
+                                 "processingStrategy = gram-driven (or auto), without asynchronous or dyckSolver = on");
+
+    if (sharedSets && processingStrategy != "spgemm")
+        throw std::runtime_error("sharedSets requires processingStrategy = spgemm");
 }
 
 void Config::parseArgs(int argc, char* argv[]) {
@@ -162,9 +287,10 @@ void Config::parseArgs(int argc, char* argv[]) {
         auto v = get("--executionMode");
         if (!v.empty()) executionMode = v;
         if (executionMode.empty()) executionMode = "serial";
-        else if (executionMode!="serial" && executionMode!="parallel")
+        else if (executionMode!="serial" && executionMode!="parallel" &&
+                 executionMode!="distributed" && executionMode!="auto")
             throw std::runtime_error(
-              "Invalid --executionMode '" + executionMode + "'. Allowed: serial, parallel");
+              "Invalid --executionMode '" + executionMode + "'. Allowed: serial, parallel, distributed, auto");
     }
 
     // traversal direction
@@ -172,14 +298,15 @@ void Config::parseArgs(int argc, char* argv[]) {
         auto v = get("--traversalDirection");
         if (!v.empty()) traversalDirection = v;
         if (traversalDirection.empty())
-            traversalDirection = (executionMode=="parallel" ? "fw" : "bi");
+            traversalDirection = (executionMode=="parallel" ? "fw" : executionMode=="auto" ? "auto" : "bi");
         if (traversalDirection!="fw" &&
             traversalDirection!="bw" &&
-            traversalDirection!="bi")
+            traversalDirection!="bi" &&
+            traversalDirection!="auto")
         {
             throw std::runtime_error(
               "Invalid --traversalDirection '" + traversalDirection + 
-              "'. Allowed: fw, bw, bi");
+              "'. Allowed: fw, bw, bi, auto");
         }
     }
 
@@ -187,18 +314,25 @@ void Config::parseArgs(int argc, char* argv[]) {
     {
         auto v = get("--processingStrategy");
         if (!v.empty()) processingStrategy = v;
-        if (processingStrategy.empty()) processingStrategy = "gram-driven";
+        if (processingStrategy.empty())
+            processingStrategy = (executionMode=="auto" ? "auto" : "gram-driven");
         else if (processingStrategy!="gram-driven" &&
-                 processingStrategy!="topo-driven")
+                 processingStrategy!="topo-driven" &&
+                 processingStrategy!="spgemm" &&
+                 processingStrategy!="bitmatrix" &&
+                 processingStrategy!="stream" &&
+                 processingStrategy!="bdd" &&
+                 processingStrategy!="hybrid" &&
+                 processingStrategy!="auto")
         {
             throw std::runtime_error(
               "Invalid --processingStrategy '" + processingStrategy +
-              "'. Allowed: gram-driven, topo-driven");
+              "'. Allowed: gram-driven, topo-driven, spgemm, bitmatrix, stream, bdd, hybrid, auto");
         }
     }
 
-    // threads
-    if (executionMode == "parallel") {
+    // threads (auto mode may pick parallel)
+    if (executionMode == "parallel" || executionMode == "auto") {
         auto ts = get("--numThreads");
         if (!ts.empty()) {
             try {
@@ -214,6 +348,136 @@ void Config::parseArgs(int argc, char* argv[]) {
             numThreads = (omp_thr > 0 ? omp_thr : 1);
         }
     }
+
+    // NUMA placement (a bare flag enables it)
+    if (kv.count("--numaAware")) {
+        auto v = get("--numaAware");
+        numaAware = v.empty() ? true : parseBool("--numaAware", v);
+    }
+
+    // asynchronous (Gauss-Seidel) iteration (a bare flag enables it)
+    if (kv.count("--asynchronous")) {
+        auto v = get("--asynchronous");
+        asynchronous = v.empty() ? true : parseBool("--asynchronous", v);
+    }
+
+    // dedicated Dyck-reachability solver
+    {
+        auto v = get("--dyckSolver");
+        if (!v.empty()) dyckSolver = v;
+        if (dyckSolver!="auto" && dyckSolver!="on" && dyckSolver!="off")
+            throw std::runtime_error(
+              "Invalid --dyckSolver '" + dyckSolver + "'. Allowed: auto, on, off");
+    }
+
+    // contraction of transitive-label cycles (a bare flag enables it)
+    if (kv.count("--sccContraction")) {
+        auto v = get("--sccContraction");
+        sccContraction = v.empty() ? true : parseBool("--sccContraction", v);
+    }
+
+    // online collapsing of derived cycles (a bare flag enables it)
+    if (kv.count("--cycleCollapsing")) {
+        auto v = get("--cycleCollapsing");
+        cycleCollapsing = v.empty() ? true : parseBool("--cycleCollapsing", v);
+    }
+
+    // merging of equivalent vertices (a bare flag enables it)
+    if (kv.count("--nodeMerging")) {
+        auto v = get("--nodeMerging");
+        nodeMerging = v.empty() ? true : parseBool("--nodeMerging", v);
+    }
+
+    // vertex renumbering before solving
+    {
+        auto v = get("--vertexOrder");
+        if (!v.empty()) vertexOrder = v;
+        if (vertexOrder!="none" && vertexOrder!="degree" && vertexOrder!="rcm" && vertexOrder!="community")
+            throw std::runtime_error(
+              "Invalid --vertexOrder '" + vertexOrder + "'. Allowed: none, degree, rcm, community");
+    }
+
+    // probe runs for auto settings (a bare flag enables it)
+    if (kv.count("--calibration")) {
+        auto v = get("--calibration");
+        calibration = v.empty() ? true : parseBool("--calibration", v);
+    }
+
+    // software prefetch distance of the fw/bw join loops
+    {
+        auto v = get("--prefetchDistance");
+        if (!v.empty()) {
+            try {
+                int x = std::stoi(v);
+                if (x < 0 || x > 256) throw 0;
+                prefetchDistance = static_cast<unsigned>(x);
+            } catch (...) {
+                throw std::runtime_error(
+                  "Invalid --prefetchDistance '" + v + "'. Must be in [0, 256]");
+            }
+        }
+    }
+
+    // sweep order of the fw/bw gram-driven join loops
+    {
+        auto v = get("--sweepOrder");
+        if (!v.empty()) sweepOrder = v;
+        if (sweepOrder!="vertex" && sweepOrder!="label")
+            throw std::runtime_error(
+              "Invalid --sweepOrder '" + sweepOrder + "'. Allowed: vertex, label");
+    }
+
+    // huge page backing of the graph containers
+    {
+        auto v = get("--hugePages");
+        if (!v.empty()) hugePages = v;
+        if (hugePages!="off" && hugePages!="transparent" && hugePages!="explicit")
+            throw std::runtime_error(
+              "Invalid --hugePages '" + hugePages + "'. Allowed: off, transparent, explicit");
+    }
+
+    // stratum-by-stratum evaluation (a bare flag enables it)
+    if (kv.count("--stratified")) {
+        auto v = get("--stratified");
+        stratified = v.empty() ? true : parseBool("--stratified", v);
+        if (stratified && !stratifiable(*this))
+            throw std::runtime_error("--stratified requires --executionMode serial, --traversalDirection bi and "
+                                     "--processingStrategy gram-driven (or auto), without --asynchronous or --dyckSolver on");
+    }
+
+    // labels kept by the stratified evaluation
+    {
+        auto v = get("--outputLabels");
+        if (!v.empty()) outputLabels = v;
+        if (!outputLabels.empty() && !stratified)
+            throw std::runtime_error("--outputLabels requires --stratified");
+    }
+
+    // product kernel of the bit-matrix solver
+    {
+        auto v = get("--bitKernel");
+        if (!v.empty()) bitKernel = v;
+        if (bitKernel!="four-russians" && bitKernel!="naive")
+            throw std::runtime_error(
+              "Invalid --bitKernel '" + bitKernel + "'. Allowed: four-russians, naive");
+    }
+
+    // hash-consed neighbor sets of the SpGEMM solver (a bare flag enables them)
+    if (kv.count("--sharedSets")) {
+        auto v = get("--sharedSets");
+        sharedSets = v.empty() ? true : parseBool("--sharedSets", v);
+        if (sharedSets && processingStrategy != "spgemm")
+            throw std::runtime_error("--sharedSets requires --processingStrategy spgemm");
+    }
+
+    // variable order of the BDD solver
+    {
+        auto v = get("--bddOrder");
+        if (!v.empty()) bddOrder = v;
+        if (bddOrder!="interleaved" && bddOrder!="sequential")
+            throw std::runtime_error(
+              "Invalid --bddOrder '" + bddOrder + "'. Allowed: interleaved, sequential");
+    }
 }
 
 void Config::printUsage(const char* prog) {
@@ -222,10 +486,26 @@ void Config::printUsage(const char* prog) {
       << "The file must contain one key = value per line. Supported keys (must match Config class fields):\n"
       << "  graphFilepath      = <path to graph file>            (required)\n"
       << "  grammarFilepath    = <path to grammar file>          (required)\n"
-      << "  executionMode      = serial | parallel               (default: serial)\n"
-      << "  traversalDirection = fw | bw | bi                    (default: bi, or fw if executionMode=parallel)\n"
-      << "  processingStrategy = gram-driven | topo-driven       (default: gram-driven)\n"
-      << "  numThreads         = <positive integer>              (default: 1, or max threads if parallel)\n\n"
+      << "  executionMode      = serial | parallel | distributed | auto (default: serial; distributed runs under mpirun)\n"
+      << "  traversalDirection = fw | bw | bi | auto             (default: bi, fw if executionMode=parallel, auto if executionMode=auto)\n"
+      << "  processingStrategy = gram-driven | topo-driven | spgemm | bitmatrix | stream | bdd | hybrid | auto (default: gram-driven, auto if executionMode=auto)\n"
+      << "  numThreads         = <positive integer>              (default: 1, or max threads if parallel)\n"
+      << "  numaAware          = true | false                    (default: false; parallel mode, no-op on single-node machines)\n"
+      << "  asynchronous       = true | false                    (default: false; bi + gram-driven, serial or parallel)\n"
+      << "  dyckSolver         = auto | on | off                 (default: auto; auto picks it for Dyck-shaped grammars)\n"
+      << "  sccContraction     = true | false                    (default: false; contract cycles of A ::= A A labels)\n"
+      << "  cycleCollapsing    = true | false                    (default: false; fw + gram-driven, merge derived cycles)\n"
+      << "  nodeMerging        = true | false                    (default: false; merge vertices with identical neighbors)\n"
+      << "  vertexOrder        = none | degree | rcm | community (default: none; renumber vertices for locality)\n"
+      << "  calibration        = true | false                    (default: false; time probe runs to resolve auto settings)\n"
+      << "  prefetchDistance   = <integer in [0, 256]>           (default: 8; 0 disables prefetching in fw/bw joins)\n"
+      << "  sweepOrder         = vertex | label                  (default: vertex; fw/bw gram-driven, label-major joins)\n"
+      << "  hugePages          = off | transparent | explicit    (default: off; 2 MiB pages for the graph containers)\n"
+      << "  stratified         = true | false                    (default: false; serial bi gram-driven or auto, solve strata in order)\n"
+      << "  outputLabels       = <label>,<label>,...             (default: all; labels to compute when stratified)\n"
+      << "  bitKernel          = four-russians | naive           (default: four-russians; product kernel of bitmatrix)\n"
+      << "  sharedSets         = true | false                    (default: false; spgemm, share identical neighbor sets)\n"
+      << "  bddOrder           = interleaved | sequential        (default: interleaved; bdd, order of the vertex bits)\n\n"
       << "\n"
       << "----------------------------------------------\n"
       << "Example 'Config' file:\n"
@@ -247,9 +527,34 @@ void Config::printConfigs() const {
               << "  grammarFilepath     = " << grammarFilepath    << "\n"
               << "  executionMode       = " << executionMode      << "\n"
               << "  traversalDirection  = " << traversalDirection << "\n"
-              << "  processingStrategy  = " << processingStrategy << "\n";
-    if (executionMode == "parallel")
-        std::cout << "  numThreads          = " << numThreads << "\n";
+              << "  processingStrategy  = " << processingStrategy << "\n"
+              << "  asynchronous        = " << (asynchronous ? "true" : "false") << "\n"
+              << "  dyckSolver          = " << dyckSolver << "\n"
+              << "  sccContraction      = " << (sccContraction ? "true" : "false") << "\n"
+              << "  cycleCollapsing     = " << (cycleCollapsing ? "true" : "false") << "\n"
+              << "  nodeMerging         = " << (nodeMerging ? "true" : "false") << "\n"
+              << "  vertexOrder         = " << vertexOrder << "\n"
+              << "  calibration         = " << (calibration ? "true" : "false") << "\n"
+              << "  prefetchDistance    = " << prefetchDistance << "\n"
+              << "  sweepOrder          = " << sweepOrder << "\n"
+              << "  hugePages           = " << hugePages << "\n"
+              << "  stratified          = " << (stratified ? "true" : "false") << "\n";
+    if (stratified) {
+        std::cout << "  outputLabels        = " << (outputLabels.empty() ? "(all)" : outputLabels) << "\n";
+    }
+    if (processingStrategy == "bitmatrix") {
+        std::cout << "  bitKernel           = " << bitKernel << "\n";
+    }
+    if (processingStrategy == "spgemm") {
+        std::cout << "  sharedSets          = " << (sharedSets ? "true" : "false") << "\n";
+    }
+    if (processingStrategy == "bdd") {
+        std::cout << "  bddOrder            = " << bddOrder << "\n";
+    }
+    if (executionMode == "parallel" || executionMode == "auto") {
+        std::cout << "  numThreads          = " << numThreads << "\n"
+                  << "  numaAware           = " << (numaAware ? "true" : "false") << "\n";
+    }
     std::cout << std::endl;
 }
 
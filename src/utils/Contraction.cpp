@@ -0,0 +1,534 @@
+#include <iostream>
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+#include "utils/Contraction.hpp"
+
+namespace gracfl
+{
+    namespace
+    {
+        /// Number of distinct edges of a list.
+        ull countDistinct(const std::vector<Edge>& edges)
+        {
+            std::vector<std::tuple<uint, uint, uint>> keys;
+            keys.reserve(edges.size());
+            for (const Edge& edge : edges)
+            {
+                keys.emplace_back(edge.from, edge.label, edge.to);
+            }
+            std::sort(keys.begin(), keys.end());
+            return std::unique(keys.begin(), keys.end()) - keys.begin();
+        }
+
+        /// Labels that derive the empty string.
+        std::vector<bool> nullableLabels(const Grammar& grammar)
+        {
+            std::vector<bool> nullable(grammar.getLabelSize(), false);
+            for (const auto& rule : grammar.getRule1()) nullable[rule[0]] = true;
+            for (bool changed = true; changed; )
+            {
+                changed = false;
+                for (const auto& rule : grammar.getRule2())
+                {
+                    if (!nullable[rule[0]] && nullable[rule[1]]) nullable[rule[0]] = changed = true;
+                }
+                for (const auto& rule : grammar.getRule3())
+                {
+                    if (!nullable[rule[0]] && nullable[rule[1]] && nullable[rule[2]]) nullable[rule[0]] = changed = true;
+                }
+            }
+            return nullable;
+        }
+
+        /**
+         * @brief Family of every label: A if its edges are A-edges of a contractible transitive label A, else -1.
+         *
+         * A label A with A ::= A A is contractible if every nullable label Y other than A has
+         * Y ::= Y A or Y ::= A Y. Its family holds A and the labels whose only use is A ::= B,
+         * except nonterminals with input edges: the contracted graph keeps only class-to-class
+         * edges of those, which would expand their input edges to every member of a class.
+         */
+        std::vector<int> transitiveFamilies(const Grammar& grammar, const std::vector<Edge>& edges)
+        {
+            uint labelSize = grammar.getLabelSize();
+            const auto& rules2 = grammar.getRule2();
+            const auto& rules3 = grammar.getRule3();
+
+            std::vector<bool> nullable = nullableLabels(grammar);
+
+            // Nonterminals that also label input edges
+            std::vector<bool> derivedInput(labelSize, false);
+            for (const auto& rule : grammar.getRule1()) derivedInput[rule[0]] = true;
+            for (const auto& rule : rules2) derivedInput[rule[0]] = true;
+            for (const auto& rule : rules3) derivedInput[rule[0]] = true;
+            std::vector<bool> hasInput(labelSize, false);
+            for (const Edge& edge : edges) hasInput[edge.label] = true;
+            for (uint l = 0; l < labelSize; l++) derivedInput[l] = derivedInput[l] && hasInput[l];
+
+            // Right-hand side uses of every label; a label used only in A ::= B feeds A
+            std::vector<int> rhsUses(labelSize, 0);
+            std::vector<int> unaryParent(labelSize, -1);
+            for (const auto& rule : rules2)
+            {
+                rhsUses[rule[1]]++;
+                unaryParent[rule[1]] = rule[0];
+            }
+            for (const auto& rule : rules3)
+            {
+                rhsUses[rule[1]]++;
+                rhsUses[rule[2]]++;
+            }
+            auto hasRule3 = [&](uint A, uint B, uint C) {
+                return std::any_of(rules3.begin(), rules3.end(), [&](const std::vector<uint>& rule) {
+                    return rule[0] == A && rule[1] == B && rule[2] == C;
+                });
+            };
+
+            std::vector<int> family(labelSize, -1);
+            for (const auto& rule : rules3)
+            {
+                uint A = rule[0];
+                if (rule[1] != A || rule[2] != A || family[A] >= 0)
+                {
+                    continue;
+                }
+                bool uniform = true;
+                for (uint Y = 0; Y < labelSize; Y++)
+                {
+                    if (nullable[Y] && Y != A && !hasRule3(Y, Y, A) && !hasRule3(Y, A, Y))
+                    {
+                        uniform = false;
+                    }
+                }
+                if (!uniform)
+                {
+                    continue;
+                }
+                family[A] = A;
+                for (uint B = 0; B < labelSize; B++)
+                {
+                    if (B != A && rhsUses[B] == 1 && unaryParent[B] == (int)A && !derivedInput[B])
+                    {
+                        family[B] = A;
+                    }
+                }
+            }
+            return family;
+        }
+
+        /**
+         * @brief The family of the input edges of every vertex: A if all of them are A-edges,
+         *        -1 without edges, -2 if mixed. A vertex is eligible for A if it is A.
+         */
+        std::vector<int> incidentFamilies(const std::vector<Edge>& edges, const std::vector<int>& family, uint nodeSize)
+        {
+            const int NONE = -1, MIXED = -2;
+            std::vector<int> incident(nodeSize, NONE);
+            auto touch = [&](uint v, int fam) {
+                if (incident[v] == NONE) incident[v] = fam;
+                else if (incident[v] != fam) incident[v] = MIXED;
+            };
+            for (const Edge& edge : edges)
+            {
+                int fam = family[edge.label] >= 0 ? family[edge.label] : MIXED;
+                touch(edge.from, fam);
+                touch(edge.to, fam);
+            }
+            return incident;
+        }
+    }
+
+    VertexContraction::VertexContraction(const std::vector<Edge>& edges, const Grammar& grammar)
+    : grammar_(grammar)
+    , edges_(edges)
+    {
+        for (const Edge& edge : edges_)
+        {
+            nodeSize_ = std::max(nodeSize_, std::max(edge.from + 1, edge.to + 1));
+        }
+        inputEdgeCount_ = countDistinct(edges_);
+
+        isNonterminal_.assign(grammar_.getLabelSize(), false);
+        for (const auto& rule : grammar_.getRule1()) isNonterminal_[rule[0]] = true;
+        for (const auto& rule : grammar_.getRule2()) isNonterminal_[rule[0]] = true;
+        for (const auto& rule : grammar_.getRule3()) isNonterminal_[rule[0]] = true;
+
+        std::vector<uint> rep(nodeSize_);
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            rep[v] = v;
+        }
+        contract(rep);
+    }
+
+    void VertexContraction::contract(const std::vector<uint>& rep, bool witnesses)
+    {
+        // Number the classes by their largest member
+        std::vector<uint> maxMember(nodeSize_, 0);
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            maxMember[rep[v]] = std::max(maxMember[rep[v]], v);
+        }
+        std::vector<uint> classId(nodeSize_, 0);
+        members_.clear();
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            if (maxMember[rep[v]] == v)
+            {
+                classId[rep[v]] = members_.size();
+                members_.emplace_back();
+            }
+        }
+        classOf_.assign(nodeSize_, 0);
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            classOf_[v] = classId[rep[v]];
+            members_[classOf_[v]].push_back(v);
+        }
+
+        // Contracted vertex of every input vertex, witnesses numbered after the classes
+        uint classCount = members_.size();
+        std::vector<uint> vertexId(classOf_);
+        witness_.assign(classCount, -1);
+        witnessOf_.clear();
+        for (uint c = 0; witnesses && c < classCount; c++)
+        {
+            if (members_[c].size() > 1)
+            {
+                witness_[c] = classCount + witnessOf_.size();
+                witnessOf_.push_back(c);
+                vertexId[members_[c][1]] = witness_[c];
+            }
+        }
+
+        std::vector<std::tuple<uint, uint, uint>> keys;
+        keys.reserve(edges_.size());
+        for (const Edge& edge : edges_)
+        {
+            keys.emplace_back(vertexId[edge.from], edge.label, vertexId[edge.to]);
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        contractedEdges_.clear();
+        contractedEdges_.reserve(keys.size());
+        for (const auto& key : keys)
+        {
+            contractedEdges_.emplace_back(std::get<0>(key), std::get<2>(key), std::get<1>(key));
+        }
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> VertexContraction::expand(
+        const std::vector<std::vector<std::unordered_set<ull>>>& graph) const
+    {
+        uint labelSize = grammar_.getLabelSize();
+        std::vector<std::vector<std::unordered_set<ull>>> result(
+            nodeSize_, std::vector<std::unordered_set<ull>>(labelSize));
+
+        for (const Edge& edge : edges_)
+        {
+            if (!isNonterminal_[edge.label])
+            {
+                result[edge.from][edge.label].insert(edge.to);
+            }
+        }
+        uint classCount = members_.size();
+        for (uint c = 0; c < graph.size() && c < classCount; c++)
+        {
+            for (uint l = 0; l < graph[c].size(); l++)
+            {
+                if (!isNonterminal_[l])
+                {
+                    continue;
+                }
+                for (ull d : graph[c][l])
+                {
+                    if (d < classCount && (d != c || witness_[c] < 0))
+                    {
+                        for (uint u : members_[c])
+                        {
+                            result[u][l].insert(members_[d].begin(), members_[d].end());
+                        }
+                    }
+                    else if (d == c)
+                    {
+                        // diagonal pairs of a class with a witness
+                        for (uint u : members_[c])
+                        {
+                            result[u][l].insert(u);
+                        }
+                    }
+                    else if (d >= classCount && witnessOf_[d - classCount] == (int)c)
+                    {
+                        // pairs of distinct members; edges to other witnesses repeat the ones to their classes
+                        for (uint u : members_[c])
+                        {
+                            for (uint w : members_[c])
+                            {
+                                if (w != u) result[u][l].insert(w);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    ull VertexContraction::expandEdgeCount(const std::vector<std::vector<std::unordered_set<ull>>>& graph) const
+    {
+        std::vector<Edge> terminalEdges;
+        for (const Edge& edge : edges_)
+        {
+            if (!isNonterminal_[edge.label])
+            {
+                terminalEdges.push_back(edge);
+            }
+        }
+        ull count = countDistinct(terminalEdges);
+
+        uint classCount = members_.size();
+        for (uint c = 0; c < graph.size() && c < classCount; c++)
+        {
+            ull size = members_[c].size();
+            for (uint l = 0; l < graph[c].size(); l++)
+            {
+                if (!isNonterminal_[l])
+                {
+                    continue;
+                }
+                for (ull d : graph[c][l])
+                {
+                    if (d < classCount && (d != c || witness_[c] < 0))
+                    {
+                        count += size * members_[d].size();
+                    }
+                    else if (d == c)
+                    {
+                        count += size;
+                    }
+                    else if (d >= classCount && witnessOf_[d - classCount] == (int)c)
+                    {
+                        count += size * (size - 1);
+                    }
+                }
+            }
+        }
+        return count;
+    }
+
+    void VertexContraction::printStats() const
+    {
+        uint vertices = members_.size() + witnessOf_.size();
+        std::cout << name() << ": " << nodeSize_ << " -> " << vertices << " vertices (removed "
+                  << nodeSize_ - vertices << "), " << inputEdgeCount_ << " -> " << contractedEdges_.size()
+                  << " edges (removed " << inputEdgeCount_ - contractedEdges_.size() << ")" << std::endl;
+    }
+
+    SCCContraction::SCCContraction(const std::vector<Edge>& edges, const Grammar& grammar)
+    : VertexContraction(edges, grammar)
+    {
+        std::vector<int> family = transitiveFamilies(grammar_, edges_);
+        std::vector<int> incident = incidentFamilies(edges_, family, nodeSize_);
+
+        // Tarjan's SCC algorithm (iterative) over the A-edges between eligible vertices; the
+        // families are disjoint, so all transitive labels are handled in one pass
+        std::vector<std::vector<uint>> adj(nodeSize_);
+        for (const Edge& edge : edges_)
+        {
+            int fam = family[edge.label];
+            if (fam >= 0 && incident[edge.from] == fam && incident[edge.to] == fam)
+            {
+                adj[edge.from].push_back(edge.to);
+            }
+        }
+
+        std::vector<uint> rep(nodeSize_);
+        const uint UNVISITED = (uint)-1;
+        std::vector<uint> index(nodeSize_, UNVISITED), low(nodeSize_, 0);
+        std::vector<bool> onStack(nodeSize_, false);
+        std::vector<uint> stack;
+        std::vector<std::pair<uint, uint>> callStack; // (vertex, next neighbor position)
+        uint counter = 0;
+        for (uint s = 0; s < nodeSize_; s++)
+        {
+            if (index[s] != UNVISITED)
+            {
+                continue;
+            }
+            callStack.emplace_back(s, 0);
+            index[s] = low[s] = counter++;
+            stack.push_back(s);
+            onStack[s] = true;
+            while (!callStack.empty())
+            {
+                uint v = callStack.back().first;
+                uint& pos = callStack.back().second;
+                if (pos < adj[v].size())
+                {
+                    uint w = adj[v][pos++];
+                    if (index[w] == UNVISITED)
+                    {
+                        index[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        onStack[w] = true;
+                        callStack.emplace_back(w, 0);
+                    }
+                    else if (onStack[w])
+                    {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+                callStack.pop_back();
+                if (!callStack.empty())
+                {
+                    uint parent = callStack.back().first;
+                    low[parent] = std::min(low[parent], low[v]);
+                }
+                if (low[v] == index[v])
+                {
+                    uint w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        onStack[w] = false;
+                        rep[w] = v;
+                    } while (w != v);
+                }
+            }
+        }
+
+        contract(rep);
+    }
+
+    EquivalenceMerging::EquivalenceMerging(const std::vector<Edge>& edges, const Grammar& grammar)
+    : VertexContraction(edges, grammar)
+    {
+        // Labeled neighbor lists of every vertex
+        std::vector<std::vector<ull>> preds(nodeSize_), succs(nodeSize_);
+        for (const Edge& edge : edges_)
+        {
+            succs[edge.from].push_back(COMBINE(edge.label, edge.to));
+            preds[edge.to].push_back(COMBINE(edge.label, edge.from));
+        }
+
+        // Value numbering: vertices with equal hashes are compared, the first of a kind represents it
+        std::unordered_map<ull, std::vector<uint>> numbers;
+        std::vector<uint> rep(nodeSize_);
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            rep[v] = v;
+            if (preds[v].empty() && succs[v].empty())
+            {
+                continue;
+            }
+            std::sort(preds[v].begin(), preds[v].end());
+            preds[v].erase(std::unique(preds[v].begin(), preds[v].end()), preds[v].end());
+            std::sort(succs[v].begin(), succs[v].end());
+            succs[v].erase(std::unique(succs[v].begin(), succs[v].end()), succs[v].end());
+
+            ull hash = 14695981039346656037ULL;
+            for (ull key : preds[v]) hash = (hash ^ key) * 1099511628211ULL;
+            hash = (hash ^ 0xFFFFFFFFFFFFFFFFULL) * 1099511628211ULL; // separates the two lists
+            for (ull key : succs[v]) hash = (hash ^ key) * 1099511628211ULL;
+
+            auto& candidates = numbers[hash];
+            for (uint r : candidates)
+            {
+                if (preds[r] == preds[v] && succs[r] == succs[v])
+                {
+                    rep[v] = r;
+                    break;
+                }
+            }
+            if (rep[v] == v)
+            {
+                candidates.push_back(v);
+            }
+        }
+
+        // Without nullable labels every X(u, u) of a class member comes from a nonempty path,
+        // which also leads to every other member, so no witness is needed
+        std::vector<bool> nullable = nullableLabels(grammar_);
+        contract(rep, std::find(nullable.begin(), nullable.end(), true) != nullable.end());
+    }
+
+    CycleCollapsing::CycleCollapsing(const std::vector<Edge>& edges, const Grammar& grammar, uint nodeSize)
+    {
+        std::vector<int> family = transitiveFamilies(grammar, edges);
+        for (uint A = 0; A < family.size(); A++)
+        {
+            if (family[A] == (int)A) transitive_.push_back(A);
+        }
+        incident_ = incidentFamilies(edges, family, nodeSize);
+
+        isNonterminal_.assign(grammar.getLabelSize(), false);
+        for (const auto& rule : grammar.getRule1()) isNonterminal_[rule[0]] = true;
+        for (const auto& rule : grammar.getRule2()) isNonterminal_[rule[0]] = true;
+        for (const auto& rule : grammar.getRule3()) isNonterminal_[rule[0]] = true;
+        for (const Edge& edge : edges)
+        {
+            if (!isNonterminal_[edge.label]) terminalEdges_.push_back(edge);
+        }
+        terminalEdgeCount_ = countDistinct(terminalEdges_);
+
+        rep_.resize(nodeSize);
+        members_.resize(nodeSize);
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            rep_[v] = v;
+            members_[v].push_back(v);
+        }
+    }
+
+    uint CycleCollapsing::unite(uint r, uint s)
+    {
+        // the smaller class is absorbed, so a vertex is relabeled O(log n) times
+        if (members_[r].size() < members_[s].size()) std::swap(r, s);
+        for (uint v : members_[s])
+        {
+            rep_[v] = r;
+        }
+        members_[r].insert(members_[r].end(), members_[s].begin(), members_[s].end());
+        std::vector<uint>().swap(members_[s]);
+        merged_++;
+        return s;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> CycleCollapsing::expand(
+        const std::vector<std::vector<std::unordered_set<ull>>>& graph) const
+    {
+        uint nodeSize = rep_.size();
+        uint labelSize = isNonterminal_.size();
+        std::vector<std::vector<std::unordered_set<ull>>> result(
+            nodeSize, std::vector<std::unordered_set<ull>>(labelSize));
+
+        for (const Edge& edge : terminalEdges_)
+        {
+            result[edge.from][edge.label].insert(edge.to);
+        }
+        for (uint r = 0; r < graph.size() && r < nodeSize; r++)
+        {
+            if (rep_[r] != r) continue;
+            for (uint l = 0; l < graph[r].size(); l++)
+            {
+                if (!isNonterminal_[l]) continue;
+                for (ull d : graph[r][l])
+                {
+                    const std::vector<uint>& targets = members_[rep_[d]];
+                    for (uint u : members_[r])
+                    {
+                        result[u][l].insert(targets.begin(), targets.end());
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    void CycleCollapsing::printStats() const
+    {
+        std::cout << "Cycle collapsing: " << merged_ << " of " << rep_.size() << " vertices merged" << std::endl;
+    }
+}
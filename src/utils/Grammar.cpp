@@ -3,6 +3,8 @@
 #include <iostream> 
 #include <stdexcept>
 #include <cstdlib> 
+#include <algorithm>
+#include <functional>
 #include "utils/Grammar.hpp"
 
 namespace gracfl 
@@ -34,6 +36,368 @@ namespace gracfl
             grammar3indexLeft_[grammar3_[i][1]].push_back(std::make_pair(grammar3_[i][2], grammar3_[i][0]));
             grammar3indexRight_[grammar3_[i][2]].push_back(std::make_pair(grammar3_[i][1], grammar3_[i][0]));
 		}
+
+        checkIndexedRules();
+        detectDyck();
+        computeStrata();
+    }
+
+    void Grammar::computeStrata()
+    {
+        // dependencies of every nonterminal, from its unary and binary rules
+        std::vector<std::vector<uint>> deps(labelSize_);
+        std::vector<bool> isLHS(labelSize_, false);
+        for (const auto& rule : grammar2_)
+        {
+            deps[rule[0]].push_back(rule[1]);
+            isLHS[rule[0]] = true;
+        }
+        for (const auto& rule : grammar3_)
+        {
+            deps[rule[0]].push_back(rule[1]);
+            deps[rule[0]].push_back(rule[2]);
+            isLHS[rule[0]] = true;
+        }
+
+        // Tarjan's algorithm emits an SCC after all SCCs it depends on
+        strata_.clear();
+        stratumOf_.assign(labelSize_, -1);
+        std::vector<int> order(labelSize_, -1), low(labelSize_, 0);
+        std::vector<bool> onStack(labelSize_, false);
+        std::vector<uint> stack;
+        int counter = 0;
+        std::function<void(uint)> visit = [&](uint A) {
+            order[A] = low[A] = counter++;
+            stack.push_back(A);
+            onStack[A] = true;
+            for (uint B : deps[A])
+            {
+                if (!isLHS[B])
+                {
+                    continue;
+                }
+                if (order[B] < 0)
+                {
+                    visit(B);
+                    low[A] = std::min(low[A], low[B]);
+                }
+                else if (onStack[B])
+                {
+                    low[A] = std::min(low[A], order[B]);
+                }
+            }
+            if (low[A] == order[A])
+            {
+                std::vector<uint> stratum;
+                uint B;
+                do {
+                    B = stack.back();
+                    stack.pop_back();
+                    onStack[B] = false;
+                    stratumOf_[B] = strata_.size();
+                    stratum.push_back(B);
+                } while (B != A);
+                std::sort(stratum.begin(), stratum.end());
+                strata_.push_back(stratum);
+            }
+        };
+        for (uint A = 0; A < labelSize_; A++)
+        {
+            if (isLHS[A] && order[A] < 0)
+            {
+                visit(A);
+            }
+        }
+    }
+
+    std::vector<bool> Grammar::requiredLabels(const std::vector<uint>& output) const
+    {
+        if (output.empty())
+        {
+            return std::vector<bool>(labelSize_, true);
+        }
+        std::vector<bool> required(labelSize_, false);
+        std::vector<uint> worklist;
+        for (uint A : output)
+        {
+            if (!required[A])
+            {
+                required[A] = true;
+                worklist.push_back(A);
+            }
+        }
+        while (!worklist.empty())
+        {
+            uint A = worklist.back();
+            worklist.pop_back();
+            auto require = [&](uint B) {
+                if (!required[B])
+                {
+                    required[B] = true;
+                    worklist.push_back(B);
+                }
+            };
+            for (const auto& rule : grammar2_)
+            {
+                if (rule[0] == A) require(rule[1]);
+            }
+            for (const auto& rule : grammar3_)
+            {
+                if (rule[0] == A)
+                {
+                    require(rule[1]);
+                    require(rule[2]);
+                }
+            }
+        }
+        return required;
+    }
+
+    void Grammar::checkIndexedRules() const
+    {
+        for (const auto& rule : grammar1_)
+        {
+            if (indexed_[rule[0]])
+            {
+                throw std::runtime_error("Indexed symbol " + hashSymRev_.at(rule[0]) + " cannot have an epsilon rule");
+            }
+        }
+        auto check = [&](const std::vector<uint>& rule) {
+            if (!indexed_[rule[0]])
+            {
+                return;
+            }
+            for (size_t i = 1; i < rule.size(); i++)
+            {
+                if (indexed_[rule[i]])
+                {
+                    return;
+                }
+            }
+            throw std::runtime_error("Index of " + hashSymRev_.at(rule[0]) + " is not bound by its right-hand side");
+        };
+        for (const auto& rule : grammar2_)
+        {
+            check(rule);
+        }
+        for (const auto& rule : grammar3_)
+        {
+            check(rule);
+        }
+    }
+
+    bool Grammar::parseLabel(const std::string& name, uint& label, uint& index) const
+    {
+        auto it = hashSym_.find(name);
+        if (it != hashSym_.end())
+        {
+            if (indexed_[it->second])
+            {
+                return false;
+            }
+            label = it->second;
+            index = 0;
+            return true;
+        }
+        if (!hasIndexed_)
+        {
+            return false;
+        }
+
+        // op_<n> of the family op_i
+        size_t sep = name.rfind('_');
+        if (sep == std::string::npos || sep + 1 == name.size() || name.size() - sep - 1 > 10 ||
+            name.find_first_not_of("0123456789", sep + 1) != std::string::npos)
+        {
+            return false;
+        }
+        it = hashSym_.find(name.substr(0, sep) + "_i");
+        if (it == hashSym_.end() || !indexed_[it->second])
+        {
+            return false;
+        }
+        unsigned long n = std::stoul(name.substr(sep + 1));
+        if (n > 0xFFFFFFFFul)
+        {
+            return false;
+        }
+        label = it->second;
+        index = static_cast<uint>(n);
+        return true;
+    }
+
+    void Grammar::detectDyck()
+    {
+        dyckStart_ = -1;
+        dyckEpsilon_ = false;
+        dyckKinds_.clear();
+
+        if (!grammar2_.empty() || grammar1_.size() > 1)
+        {
+            return;
+        }
+
+        // S is the symbol of S ::= S S
+        int S = -1;
+        for (const auto& rule : grammar3_)
+        {
+            if (rule[0] == rule[1] && rule[1] == rule[2])
+            {
+                if (S >= 0)
+                {
+                    return;
+                }
+                S = rule[0];
+            }
+        }
+        if (S < 0)
+        {
+            return;
+        }
+        if (indexed_[S])
+        {
+            return;
+        }
+        if (grammar1_.size() == 1)
+        {
+            if (grammar1_[0][0] != (uint)S)
+            {
+                return;
+            }
+            dyckEpsilon_ = true;
+        }
+
+        std::vector<bool> isLHS(labelSize_, false);
+        std::vector<int> lhsCount(labelSize_, 0);
+        for (const auto& rule : grammar3_)
+        {
+            isLHS[rule[0]] = true;
+            lhsCount[rule[0]]++;
+        }
+
+        // every nonterminal other than S must be the helper of exactly one kind
+        std::vector<int> openKind(labelSize_, -1);    // kind of an opening label
+        std::vector<int> closeKind(labelSize_, -1);   // kind of a closing label
+        std::vector<int> helperUses(labelSize_, 0);
+        std::vector<DyckKind> kinds;
+        auto kindOf = [&](uint open, uint close) -> int {
+            if (isLHS[open] || isLHS[close] || open == close || indexed_[open] != indexed_[close])
+            {
+                return -1;
+            }
+            if (openKind[open] >= 0 || closeKind[close] >= 0)
+            {
+                if (openKind[open] == closeKind[close])
+                {
+                    return openKind[open];
+                }
+                return -1;
+            }
+            if (openKind[close] >= 0 || closeKind[open] >= 0)
+            {
+                return -1;
+            }
+            DyckKind kind;
+            kind.open = open;
+            kind.close = close;
+            kind.indexed = indexed_[open];
+            kinds.push_back(kind);
+            openKind[open] = closeKind[close] = kinds.size() - 1;
+            return kinds.size() - 1;
+        };
+
+        for (const auto& rule : grammar3_)
+        {
+            uint A = rule[0], B = rule[1], C = rule[2];
+            if (A != (uint)S)
+            {
+                continue; // helper rules are checked from the S rule using them
+            }
+            if (B == (uint)S && C == (uint)S)
+            {
+                continue;
+            }
+
+            if (!isLHS[B] && !isLHS[C])
+            {
+                // S ::= o c
+                int k = kindOf(B, C);
+                if (k < 0)
+                {
+                    return;
+                }
+                kinds[k].direct = true;
+                continue;
+            }
+
+            // S ::= o T with T ::= S c, or S ::= T c with T ::= o S
+            bool holdsOpen = isLHS[B];
+            uint T = holdsOpen ? B : C;
+            if (T == (uint)S || lhsCount[T] != 1 || (holdsOpen ? isLHS[C] : isLHS[B]))
+            {
+                return;
+            }
+            const std::vector<uint>* helperRule = nullptr;
+            for (const auto& other : grammar3_)
+            {
+                if (other[0] == T)
+                {
+                    helperRule = &other;
+                }
+            }
+            uint open, close;
+            if (holdsOpen)
+            {
+                // S ::= T c, T ::= o S
+                if ((*helperRule)[2] != (uint)S)
+                {
+                    return;
+                }
+                open = (*helperRule)[1];
+                close = C;
+            }
+            else
+            {
+                // S ::= o T, T ::= S c
+                if ((*helperRule)[1] != (uint)S)
+                {
+                    return;
+                }
+                open = B;
+                close = (*helperRule)[2];
+            }
+            int k = kindOf(open, close);
+            if (k < 0 || kinds[k].helper >= 0 || indexed_[T] != kinds[k].indexed)
+            {
+                return;
+            }
+            kinds[k].helper = T;
+            kinds[k].helperHoldsOpen = holdsOpen;
+            helperUses[T]++;
+        }
+
+        // no stray rules: every non-S rule is the helper rule of a kind
+        for (const auto& rule : grammar3_)
+        {
+            if (rule[0] != (uint)S && helperUses[rule[0]] != 1)
+            {
+                return;
+            }
+        }
+        if (kinds.empty())
+        {
+            return;
+        }
+        for (uint k = 0; k < kinds.size(); k++)
+        {
+            if (!dyckEpsilon_ && !kinds[k].direct)
+            {
+                return;
+            }
+        }
+
+        dyckStart_ = S;
+        dyckKinds_ = kinds;
     }
 
     void Grammar::loadGrammarFile() 
@@ -49,9 +413,21 @@ namespace gracfl
 		std::vector<uint> symbols;
 
 		std::stringstream ss;
+		std::vector<std::string> families;
 		labelSize_ = 0;
 		while (getline(grammarFile, line))
 		{
+            std::istringstream head(line);
+            if (head >> symbol && symbol == "%indexed")
+            {
+                // declaration of indexed families, not a rule
+                while (head >> symbol)
+                {
+                    families.push_back(symbol);
+                }
+                continue;
+            }
+
 			ss.clear();
             symbols.clear();
 			ss << line;
@@ -91,5 +467,21 @@ namespace gracfl
 		}
 
         grammarFile.close();
+
+        indexed_.assign(labelSize_, false);
+        for (const std::string& family : families)
+        {
+            if (family.size() <= 2 || family.compare(family.size() - 2, 2, "_i") != 0)
+            {
+                throw std::runtime_error("Indexed family " + family + " must end in _i");
+            }
+            auto it = hashSym_.find(family);
+            if (it == hashSym_.end())
+            {
+                throw std::runtime_error("Indexed family " + family + " is not used by any rule");
+            }
+            indexed_[it->second] = true;
+            hasIndexed_ = true;
+        }
     }
 }
\ No newline at end of file
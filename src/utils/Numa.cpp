@@ -0,0 +1,75 @@
+#include <omp.h>
+#include <utility>
+#include "utils/Numa.hpp"
+#include "utils/Edges.hpp"
+#include "utils/FlatHashset.hpp"
+#include "tbb/concurrent_unordered_set.h"
+
+#ifdef GRACFL_USE_NUMA
+#include <numa.h>
+#endif
+
+namespace gracfl {
+namespace numa {
+    uint getNumNodes()
+    {
+#ifdef GRACFL_USE_NUMA
+        if (numa_available() < 0)
+        {
+            return 1;
+        }
+        int nodes = numa_num_configured_nodes();
+        return nodes > 1 ? (uint)nodes : 1;
+#else
+        return 1;
+#endif
+    }
+
+    uint nodeOfThread(uint tid, uint numThreads)
+    {
+        if (numThreads == 0)
+        {
+            return 0;
+        }
+        return (uint)((ull)tid * getNumNodes() / numThreads);
+    }
+
+    void bindThreads(uint numThreads)
+    {
+#ifdef GRACFL_USE_NUMA
+        if (!isMultiNode())
+        {
+            return;
+        }
+
+        #pragma omp parallel num_threads(numThreads)
+        {
+            int node = (int)nodeOfThread(omp_get_thread_num(), numThreads);
+            numa_run_on_node(node);
+            numa_set_preferred(node);
+        }
+#else
+        (void)numThreads;
+#endif
+    }
+
+    template <typename Row>
+    void placeRows(std::vector<Row>& rows, uint numThreads)
+    {
+        #pragma omp parallel for schedule(static, VERTEX_CHUNK) num_threads(numThreads)
+        for (uint i = 0; i < rows.size(); i++)
+        {
+            Row local(rows[i]);
+            std::swap(rows[i], local);
+        }
+    }
+
+    // row types of the graph containers
+    template void placeRows(std::vector<std::vector<TemporalVector>>&, uint);
+    template void placeRows(std::vector<std::vector<TemporalVectorConcurrent>>&, uint);
+    template void placeRows(std::vector<TemporalVectorWithLbldVtx>&, uint);
+    template void placeRows(std::vector<TemporalVectorConcurrentWithLbldVtx>&, uint);
+    template void placeRows(std::vector<std::vector<FlatHashset>>&, uint);
+    template void placeRows(std::vector<std::vector<tbb::concurrent_unordered_set<ull>>>&, uint);
+}
+}
@@ -0,0 +1,248 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <stdexcept>
+#include <unordered_map>
+#include "utils/Reordering.hpp"
+
+namespace gracfl
+{
+    namespace
+    {
+        /// Undirected adjacency in CSR form, one entry per edge end, only edges with keep[label].
+        void buildAdjacency(const std::vector<Edge>& edges, uint nodeSize, const std::vector<bool>& keep,
+                            std::vector<ull>& offsets, std::vector<uint>& neighbors)
+        {
+            offsets.assign(nodeSize + 1, 0);
+            for (const Edge& edge : edges)
+            {
+                if (!keep[edge.label] || edge.from == edge.to) continue;
+                offsets[edge.from + 1]++;
+                offsets[edge.to + 1]++;
+            }
+            for (uint v = 0; v < nodeSize; v++) offsets[v + 1] += offsets[v];
+            neighbors.resize(offsets[nodeSize]);
+            std::vector<ull> pos(offsets.begin(), offsets.end() - 1);
+            for (const Edge& edge : edges)
+            {
+                if (!keep[edge.label] || edge.from == edge.to) continue;
+                neighbors[pos[edge.from]++] = edge.to;
+                neighbors[pos[edge.to]++] = edge.from;
+            }
+        }
+
+        /// Mean log2 id distance of the edge endpoints and share of edges within 64 ids.
+        std::pair<double, double> locality(const std::vector<Edge>& edges)
+        {
+            double logGap = 0;
+            ull near = 0;
+            for (const Edge& edge : edges)
+            {
+                uint gap = edge.from > edge.to ? edge.from - edge.to : edge.to - edge.from;
+                logGap += std::log2(1.0 + gap);
+                if (gap <= 64) near++;
+            }
+            if (edges.empty()) return {0, 0};
+            return {logGap / edges.size(), 100.0 * near / edges.size()};
+        }
+    }
+
+    VertexReordering::VertexReordering(const std::vector<Edge>& edges, const Grammar& grammar, const std::string& order)
+    : grammar_(grammar)
+    , order_(order)
+    {
+        for (const Edge& edge : edges)
+        {
+            nodeSize_ = std::max(nodeSize_, std::max(edge.from + 1, edge.to + 1));
+        }
+
+        std::chrono::time_point<std::chrono::steady_clock> start = std::chrono::steady_clock::now();
+        if (order_ == "degree")
+        {
+            orderByDegree(edges);
+        }
+        else if (order_ == "rcm")
+        {
+            orderRCM(edges);
+        }
+        else if (order_ == "community")
+        {
+            orderCommunities(edges);
+        }
+        else
+        {
+            throw std::runtime_error("Unknown vertex order: " + order_);
+        }
+
+        // vertices without edges go first, so the largest new id has edges and the solvers see
+        // as many vertices (and epsilon self-loops) as for the input
+        std::vector<bool> hasEdges(nodeSize_, false);
+        for (const Edge& edge : edges)
+        {
+            hasEdges[edge.from] = hasEdges[edge.to] = true;
+        }
+        std::stable_partition(oldId_.begin(), oldId_.end(), [&](uint v) { return !hasEdges[v]; });
+
+        newId_.assign(nodeSize_, 0);
+        for (uint i = 0; i < nodeSize_; i++)
+        {
+            newId_[oldId_[i]] = i;
+        }
+        reorderedEdges_.reserve(edges.size());
+        for (const Edge& edge : edges)
+        {
+            reorderedEdges_.emplace_back(newId_[edge.from], newId_[edge.to], edge.label, edge.index);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        seconds_ = elapsed.count();
+        std::tie(inputLogGap_, inputNear_) = locality(edges);
+    }
+
+    void VertexReordering::orderByDegree(const std::vector<Edge>& edges)
+    {
+        std::vector<ull> degree(nodeSize_, 0);
+        for (const Edge& edge : edges)
+        {
+            degree[edge.from]++;
+            degree[edge.to]++;
+        }
+        oldId_.resize(nodeSize_);
+        std::iota(oldId_.begin(), oldId_.end(), 0);
+        std::stable_sort(oldId_.begin(), oldId_.end(),
+            [&](uint a, uint b) { return degree[a] > degree[b]; });
+    }
+
+    void VertexReordering::orderRCM(const std::vector<Edge>& edges)
+    {
+        std::vector<ull> offsets;
+        std::vector<uint> neighbors;
+        buildAdjacency(edges, nodeSize_, std::vector<bool>(grammar_.getLabelSize(), true), offsets, neighbors);
+        auto degree = [&](uint v) { return offsets[v + 1] - offsets[v]; };
+
+        // components are started from vertices of minimum degree
+        std::vector<uint> byDegree(nodeSize_);
+        std::iota(byDegree.begin(), byDegree.end(), 0);
+        std::stable_sort(byDegree.begin(), byDegree.end(),
+            [&](uint a, uint b) { return degree(a) < degree(b); });
+
+        std::vector<bool> visited(nodeSize_, false);
+        oldId_.clear();
+        oldId_.reserve(nodeSize_);
+        std::vector<uint> next;
+        for (uint root : byDegree)
+        {
+            if (visited[root]) continue;
+            visited[root] = true;
+            size_t head = oldId_.size();
+            oldId_.push_back(root);
+            for (; head < oldId_.size(); head++)
+            {
+                uint v = oldId_[head];
+                next.clear();
+                for (ull i = offsets[v]; i < offsets[v + 1]; i++)
+                {
+                    if (!visited[neighbors[i]])
+                    {
+                        visited[neighbors[i]] = true;
+                        next.push_back(neighbors[i]);
+                    }
+                }
+                std::stable_sort(next.begin(), next.end(),
+                    [&](uint a, uint b) { return degree(a) < degree(b); });
+                oldId_.insert(oldId_.end(), next.begin(), next.end());
+            }
+        }
+        std::reverse(oldId_.begin(), oldId_.end());
+    }
+
+    void VertexReordering::orderCommunities(const std::vector<Edge>& edges)
+    {
+        // only edges whose label is an operand of a binary rule are joined with other edges
+        std::vector<bool> joined(grammar_.getLabelSize(), false);
+        for (const auto& rule : grammar_.getRule3())
+        {
+            joined[rule[1]] = true;
+            joined[rule[2]] = true;
+        }
+        std::vector<ull> offsets;
+        std::vector<uint> neighbors;
+        buildAdjacency(edges, nodeSize_, joined, offsets, neighbors);
+
+        // label propagation in id order, ties broken towards the smaller community
+        const uint rounds = 10;
+        std::vector<uint> community(nodeSize_);
+        std::iota(community.begin(), community.end(), 0);
+        std::unordered_map<uint, uint> votes;
+        for (uint round = 0; round < rounds; round++)
+        {
+            bool changed = false;
+            for (uint v = 0; v < nodeSize_; v++)
+            {
+                if (offsets[v] == offsets[v + 1]) continue;
+                votes.clear();
+                for (ull i = offsets[v]; i < offsets[v + 1]; i++)
+                {
+                    votes[community[neighbors[i]]]++;
+                }
+                uint best = community[v];
+                uint bestVotes = votes.count(best) ? votes[best] : 0;
+                for (const auto& vote : votes)
+                {
+                    if (vote.second > bestVotes || (vote.second == bestVotes && vote.first < best))
+                    {
+                        best = vote.first;
+                        bestVotes = vote.second;
+                    }
+                }
+                if (best != community[v])
+                {
+                    community[v] = best;
+                    changed = true;
+                }
+            }
+            if (!changed) break;
+        }
+
+        // communities in the order of their first member, members in id order
+        std::vector<uint> rank(nodeSize_, nodeSize_);
+        uint communities = 0;
+        for (uint v = 0; v < nodeSize_; v++)
+        {
+            if (rank[community[v]] == nodeSize_) rank[community[v]] = communities++;
+        }
+        oldId_.resize(nodeSize_);
+        std::iota(oldId_.begin(), oldId_.end(), 0);
+        std::stable_sort(oldId_.begin(), oldId_.end(),
+            [&](uint a, uint b) { return rank[community[a]] < rank[community[b]]; });
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> VertexReordering::restore(
+        const std::vector<std::vector<std::unordered_set<ull>>>& graph) const
+    {
+        std::vector<std::vector<std::unordered_set<ull>>> result(graph.size());
+        for (uint v = 0; v < graph.size(); v++)
+        {
+            uint old = v < nodeSize_ ? oldId_[v] : v;
+            result[old].resize(graph[v].size());
+            for (uint label = 0; label < graph[v].size(); label++)
+            {
+                for (ull w : graph[v][label])
+                {
+                    result[old][label].insert(w < nodeSize_ ? oldId_[w] : w);
+                }
+            }
+        }
+        return result;
+    }
+
+    void VertexReordering::printStats() const
+    {
+        std::pair<double, double> after = locality(reorderedEdges_);
+        std::cout << "Vertex order (" << order_ << "): mean log2 id gap " << inputLogGap_ << " -> " << after.first
+                  << ", edges within 64 ids " << inputNear_ << "% -> " << after.second << "%, "
+                  << seconds_ << " seconds" << std::endl;
+    }
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include "utils/SetPool.hpp"
+
+namespace gracfl {
+    SetPool::SetPool()
+        : sets_(1)
+        , hashes_(1, 0)
+        , refs_(1, 0)
+        , table_(1024, FREE)
+    {
+    }
+
+    ull SetPool::hashOf(const uint* data, size_t size)
+    {
+        // FNV-1a over the vertices, mixed with the size
+        ull hash = 1469598103934665603ULL ^ size;
+        for (size_t k = 0; k < size; k++)
+        {
+            hash = (hash ^ data[k]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    uint SetPool::intern(std::vector<uint>&& set, ull hash)
+    {
+        if (set.empty()) return EMPTY;
+        const ull mask = table_.size() - 1;
+        for (ull slot = hash & mask; table_[slot] != FREE; slot = (slot + 1) & mask)
+        {
+            uint id = table_[slot];
+            if (id != TOMBSTONE && hashes_[id] == hash && sets_[id] == set)
+            {
+                refs_[id]++;
+                return id;
+            }
+        }
+
+        if ((occupied_ + 1) * 2 > table_.size()) grow();
+        uint id;
+        if (!free_.empty())
+        {
+            id = free_.back();
+            free_.pop_back();
+        }
+        else
+        {
+            id = sets_.size();
+            sets_.emplace_back();
+            hashes_.push_back(0);
+            refs_.push_back(0);
+        }
+        entries_ += set.size();
+        distinct_++;
+        sets_[id] = std::move(set);
+        hashes_[id] = hash;
+        refs_[id] = 1;
+
+        const ull slots = table_.size() - 1;
+        ull slot = hash & slots;
+        while (table_[slot] != FREE && table_[slot] != TOMBSTONE) slot = (slot + 1) & slots;
+        if (table_[slot] == FREE) occupied_++;
+        table_[slot] = id;
+        return id;
+    }
+
+    void SetPool::release(uint id)
+    {
+        if (id == EMPTY || --refs_[id] > 0) return;
+        const ull mask = table_.size() - 1;
+        ull slot = hashes_[id] & mask;
+        while (table_[slot] != id) slot = (slot + 1) & mask;
+        table_[slot] = TOMBSTONE;
+        entries_ -= sets_[id].size();
+        distinct_--;
+        std::vector<uint>().swap(sets_[id]);
+        free_.push_back(id);
+    }
+
+    void SetPool::grow()
+    {
+        ull size = table_.size();
+        while (distinct_ * 4 >= size) size *= 2;
+        table_.assign(size, FREE);
+        occupied_ = 0;
+        for (uint id = 1; id < sets_.size(); id++)
+        {
+            if (refs_[id] == 0) continue;
+            ull slot = hashes_[id] & (size - 1);
+            while (table_[slot] != FREE) slot = (slot + 1) & (size - 1);
+            table_[slot] = id;
+            occupied_++;
+        }
+    }
+}
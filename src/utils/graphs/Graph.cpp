@@ -1,16 +1,19 @@
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include "utils/Grammar.hpp"
 #include "utils/graphs/Graph.hpp"
 
 namespace gracfl {
-    Graph::Graph(std::string& graphfilepath, const Grammar& grammar)
+    Graph::Graph(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+    : numThreads_(std::max(1u, numThreads))
     {
         numLabels_ = grammar.getLabelSize();
         loadGraphFile(graphfilepath, grammar);
     }
 
-    Graph::Graph(std::vector<Edge>& edges, const Grammar& grammar)
+    Graph::Graph(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+    : numThreads_(std::max(1u, numThreads))
     {
         numLabels_ = grammar.getLabelSize();
         loadEdges(edges, grammar);
@@ -28,12 +31,11 @@ namespace gracfl {
             infile >> newEdge.to;
             infile >> label;
 
-            if (grammar.getSymbolToIDMap().find(label) == grammar.getSymbolToIDMap().end())
+            if (!grammar.parseLabel(label, newEdge.label, newEdge.index))
             {
                 continue;
             }
 
-            newEdge.label = grammar.getSymbolToIDMap().at(label);
             edges_.push_back(newEdge);
             numNodes_ = std::max(numNodes_, std::max(newEdge.from + 1, newEdge.to + 1));
             numEdges_++;
@@ -57,7 +59,7 @@ namespace gracfl {
         }
     }
 
-    ull Graph::countEdgeHelper(std::vector<std::vector<std::unordered_set<ull>>>& hashset)
+    ull Graph::countEdgeHelper(std::vector<std::vector<FlatHashset>>& hashset)
     {
         ull size = 0;
         for (uint i = 0; i < hashset.size(); i++)
@@ -82,4 +84,59 @@ namespace gracfl {
         }
         return size;
     }
+
+    template <typename Row>
+    void Graph::initRows(std::vector<Row>& rows, size_t n, const Row& prototype)
+    {
+        rows.clear();
+        rows.resize(n);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(numThreads_)
+        for (size_t v = 0; v < n; v++)
+        {
+            rows[v] = prototype;
+        }
+    }
+
+    // row types of the graph containers
+    template void Graph::initRows(std::vector<std::vector<TemporalVector>>&, size_t, const std::vector<TemporalVector>&);
+    template void Graph::initRows(std::vector<std::vector<TemporalVectorConcurrent>>&, size_t,
+                                  const std::vector<TemporalVectorConcurrent>&);
+    template void Graph::initRows(std::vector<TemporalVectorWithLbldVtx>&, size_t, const TemporalVectorWithLbldVtx&);
+    template void Graph::initRows(std::vector<TemporalVectorConcurrentWithLbldVtx>&, size_t,
+                                  const TemporalVectorConcurrentWithLbldVtx&);
+    template void Graph::initRows(std::vector<std::vector<FlatHashset>>&, size_t, const std::vector<FlatHashset>&);
+    template void Graph::initRows(std::vector<std::vector<tbb::concurrent_unordered_set<ull>>>&, size_t,
+                                  const std::vector<tbb::concurrent_unordered_set<ull>>&);
+
+    void Graph::groupEdges(uint Edge::* vertexOf, size_t nodeSize, std::vector<ull>& offsets, std::vector<uint>& order)
+    {
+        const std::vector<Edge>& edges = edges_;
+        offsets.assign(nodeSize + 1, 0);
+        #pragma omp parallel for schedule(static) num_threads(numThreads_)
+        for (size_t k = 0; k < edges.size(); k++)
+        {
+            #pragma omp atomic
+            offsets[edges[k].*vertexOf + 1]++;
+        }
+        for (size_t v = 0; v < nodeSize; v++)
+        {
+            offsets[v + 1] += offsets[v];
+        }
+
+        std::vector<ull> next(offsets.begin(), offsets.end() - 1);
+        order.resize(edges.size());
+        #pragma omp parallel for schedule(static) num_threads(numThreads_)
+        for (size_t k = 0; k < edges.size(); k++)
+        {
+            ull slot;
+            #pragma omp atomic capture
+            slot = next[edges[k].*vertexOf]++;
+            order[slot] = k;
+        }
+        #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(numThreads_)
+        for (size_t v = 0; v < nodeSize; v++)
+        {
+            std::sort(order.begin() + offsets[v], order.begin() + offsets[v + 1]);
+        }
+    }
 }
\ No newline at end of file
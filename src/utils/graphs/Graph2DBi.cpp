@@ -1,46 +1,84 @@
 #include "utils/graphs/Graph2DBi.hpp"
 
 namespace gracfl {
-    Graph2DBi::Graph2DBi(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph2DBi::Graph2DBi(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph2DBi::Graph2DBi(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph2DBi::Graph2DBi(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
+    Graph2DBi::~Graph2DBi()
+    {
+        clearContainers();
+    }
+
     void Graph2DBi::initContainers()
     {
-        outEdges_.assign(getNodeSize(), TemporalVectorWithLbldVtx());
-        inEdges_.assign(getNodeSize(), TemporalVectorWithLbldVtx());
-        hashset_.assign(getNodeSize(), std::vector<std::unordered_set<ull>>(getLabelSize(), std::unordered_set<ull>()));
+        initRows(outEdges_, getNodeSize(), TemporalVectorWithLbldVtx(&getArena()));
+        initRows(inEdges_, getNodeSize(), TemporalVectorWithLbldVtx(&getArena()));
+        initRows(hashset_, getNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
     }
 
     void Graph2DBi::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by source, then by destination, in parallel, and each vertex is
+        // filled by one thread; duplicates of an input edge are dropped, fresh marks first occurrences
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        std::vector<char> fresh(edges.size(), 0);
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            hashset_[edge.from][edge.label].insert(edge.to);
-            outEdges_[edge.from].vertexList.push_back(LbldVtx(edge.to, edge.label));
-            inEdges_[edge.to].vertexList.push_back(LbldVtx(edge.from, edge.label));
+            auto& list = outEdges_[v];
+            list.vertexList.reserve(offsets[v + 1] - offsets[v]);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (hashset_[v][edge.label].insert(edge.to).second)
+                {
+                    fresh[order[k]] = 1;
+                    list.vertexList.push_back(LbldVtx(edge.to, edge.label));
+                    list.NEW_END++;
+                }
+            }
+        }
 
-            // update the sliding pointers
-            outEdges_[edge.from].NEW_END++;
-            inEdges_[edge.to].NEW_END++;
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            auto& list = inEdges_[v];
+            list.vertexList.reserve(offsets[v + 1] - offsets[v]);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (fresh[order[k]])
+                {
+                    list.vertexList.push_back(LbldVtx(edge.from, edge.label));
+                    list.NEW_END++;
+                }
+            }
         }
     }
 
     void Graph2DBi::clearContainers()
     {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
         outEdges_.clear();
         inEdges_.clear();
         hashset_.clear();
+        getArena().release();
     }
 
 
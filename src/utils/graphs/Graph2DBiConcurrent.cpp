@@ -1,15 +1,15 @@
 #include "utils/graphs/Graph2DBiConcurrent.hpp"
 
 namespace gracfl {
-    Graph2DBiConcurrent::Graph2DBiConcurrent(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph2DBiConcurrent::Graph2DBiConcurrent(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph2DBiConcurrent::Graph2DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph2DBiConcurrent::Graph2DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
@@ -17,22 +17,52 @@ namespace gracfl {
 
     void Graph2DBiConcurrent::initContainers()
     {
-        outEdges_.assign(getNodeSize(), TemporalVectorConcurrentWithLbldVtx());
-        inEdges_.assign(getNodeSize(), TemporalVectorConcurrentWithLbldVtx());
-        hashset_.assign(getNodeSize(), std::vector<tbb::concurrent_unordered_set<ull>>(getLabelSize(), tbb::concurrent_unordered_set<ull>()));
+        initRows(outEdges_, getNodeSize(), TemporalVectorConcurrentWithLbldVtx());
+        initRows(inEdges_, getNodeSize(), TemporalVectorConcurrentWithLbldVtx());
+        initRows(hashset_, getNodeSize(), std::vector<tbb::concurrent_unordered_set<ull>>(getLabelSize(), tbb::concurrent_unordered_set<ull>()));
     }
 
     void Graph2DBiConcurrent::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by source, then by destination, in parallel, and each vertex is
+        // filled by one thread; duplicates of an input edge are dropped, fresh marks first occurrences
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        std::vector<char> fresh(edges.size(), 0);
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            hashset_[edge.from][edge.label].insert(edge.to);
-            outEdges_[edge.from].vertexList.push_back(LbldVtx(edge.to, edge.label));
-            inEdges_[edge.to].vertexList.push_back(LbldVtx(edge.from, edge.label));
+            auto& list = outEdges_[v];
+            list.vertexList.reserve(offsets[v + 1] - offsets[v]);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (hashset_[v][edge.label].insert(edge.to).second)
+                {
+                    fresh[order[k]] = 1;
+                    list.vertexList.push_back(LbldVtx(edge.to, edge.label));
+                    list.NEW_END++;
+                }
+            }
+        }
 
-            // update the sliding pointers
-            outEdges_[edge.from].NEW_END++;
-            inEdges_[edge.to].NEW_END++;
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            auto& list = inEdges_[v];
+            list.vertexList.reserve(offsets[v + 1] - offsets[v]);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (fresh[order[k]])
+                {
+                    list.vertexList.push_back(LbldVtx(edge.from, edge.label));
+                    list.NEW_END++;
+                }
+            }
         }
     }
 
@@ -70,4 +100,11 @@ namespace gracfl {
     {
         return countEdgeHelperConcurrent(hashset_);;
     }
+
+    void Graph2DBiConcurrent::placeContainers(uint numThreads)
+    {
+        numa::placeRows(outEdges_, numThreads);
+        numa::placeRows(inEdges_, numThreads);
+        numa::placeRows(hashset_, numThreads);
+    }
 }
\ No newline at end of file
@@ -1,42 +1,63 @@
 #include "utils/graphs/Graph2DIn.hpp"
 
 namespace gracfl {
-    Graph2DIn::Graph2DIn(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph2DIn::Graph2DIn(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph2DIn::Graph2DIn(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph2DIn::Graph2DIn(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
+    Graph2DIn::~Graph2DIn()
+    {
+        clearContainers();
+    }
+
     void Graph2DIn::initContainers()
     {
-        inEdges_.assign(getNodeSize(), TemporalVectorWithLbldVtx());
-        inHashset_.assign(getNodeSize(), std::vector<std::unordered_set<ull>>(getLabelSize(), std::unordered_set<ull>()));
+        initRows(inEdges_, getNodeSize(), TemporalVectorWithLbldVtx(&getArena()));
+        initRows(inHashset_, getNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
     }
 
     void Graph2DIn::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by destination in parallel, then each destination is filled by one thread;
+        // duplicates of an input edge are dropped
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            inHashset_[edge.to][edge.label].insert(edge.from);
-            inEdges_[edge.to].vertexList.push_back(LbldVtx(edge.from, edge.label));
-
-            // update the sliding pointers
-            inEdges_[edge.to].NEW_END++;
+            auto& list = inEdges_[v];
+            list.vertexList.reserve(offsets[v + 1] - offsets[v]);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (inHashset_[v][edge.label].insert(edge.from).second)
+                {
+                    list.vertexList.push_back(LbldVtx(edge.from, edge.label));
+                    list.NEW_END++;
+                }
+            }
         }
     }
 
     void Graph2DIn::clearContainers()
     {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
         inEdges_.clear();
         inHashset_.clear();
+        getArena().release();
     }
 
 
@@ -59,8 +80,35 @@ namespace gracfl {
         }
     }
 
+    bool Graph2DIn::stageEdge(Edge& edge)
+    {
+        if (!inHashset_[edge.to][edge.label].insert(edge.from).second) return false;
+        if (staging_.direct()) inEdges_[edge.to].vertexList.push_back(LbldVtx(edge.from, edge.label));
+        else staging_.add(edge.to, 0, LbldVtx(edge.from, edge.label));
+        return true;
+    }
+
+    void Graph2DIn::beginStaging(uint numThreads)
+    {
+        staging_.reset(numThreads, 1);
+    }
+
+    void Graph2DIn::commitStaged(uint thread)
+    {
+        staging_.commit(thread, [this](uint vertex, uint, const LbldVtx* entries, size_t count) {
+            auto& list = inEdges_[vertex].vertexList;
+            list.insert(list.end(), entries, entries + count);
+        });
+    }
+
     ull Graph2DIn::countEdge()
     {
         return countEdgeHelper(inHashset_);
     }
+
+    void Graph2DIn::placeContainers(uint numThreads)
+    {
+        numa::placeRows(inEdges_, numThreads);
+        numa::placeRows(inHashset_, numThreads);
+    }
 }
\ No newline at end of file
@@ -1,42 +1,63 @@
 #include "utils/graphs/Graph2DOut.hpp"
 
 namespace gracfl {
-    Graph2DOut::Graph2DOut(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph2DOut::Graph2DOut(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph2DOut::Graph2DOut(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph2DOut::Graph2DOut(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
+    Graph2DOut::~Graph2DOut()
+    {
+        clearContainers();
+    }
+
     void Graph2DOut::initContainers()
     {
-        outEdges_.assign(getNodeSize(), TemporalVectorWithLbldVtx());
-        hashset_.assign(getNodeSize(), std::vector<std::unordered_set<ull>>(getLabelSize(), std::unordered_set<ull>()));
+        initRows(outEdges_, getNodeSize(), TemporalVectorWithLbldVtx(&getArena()));
+        initRows(hashset_, getNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
     }
 
     void Graph2DOut::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by source in parallel, then each source is filled by one thread;
+        // duplicates of an input edge are dropped
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            hashset_[edge.from][edge.label].insert(edge.to);
-            outEdges_[edge.from].vertexList.push_back(LbldVtx(edge.to, edge.label));
-
-            // update the sliding pointers
-            outEdges_[edge.from].NEW_END++;
+            auto& list = outEdges_[v];
+            list.vertexList.reserve(offsets[v + 1] - offsets[v]);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (hashset_[v][edge.label].insert(edge.to).second)
+                {
+                    list.vertexList.push_back(LbldVtx(edge.to, edge.label));
+                    list.NEW_END++;
+                }
+            }
         }
     }
 
     void Graph2DOut::clearContainers()
     {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
         outEdges_.clear();
         hashset_.clear();
+        getArena().release();
     }
 
 
@@ -59,8 +80,35 @@ namespace gracfl {
         }
     }
 
+    bool Graph2DOut::stageEdge(Edge& edge)
+    {
+        if (!hashset_[edge.from][edge.label].insert(edge.to).second) return false;
+        if (staging_.direct()) outEdges_[edge.from].vertexList.push_back(LbldVtx(edge.to, edge.label));
+        else staging_.add(edge.from, 0, LbldVtx(edge.to, edge.label));
+        return true;
+    }
+
+    void Graph2DOut::beginStaging(uint numThreads)
+    {
+        staging_.reset(numThreads, 1);
+    }
+
+    void Graph2DOut::commitStaged(uint thread)
+    {
+        staging_.commit(thread, [this](uint vertex, uint, const LbldVtx* entries, size_t count) {
+            auto& list = outEdges_[vertex].vertexList;
+            list.insert(list.end(), entries, entries + count);
+        });
+    }
+
     ull Graph2DOut::countEdge()
     {
         return countEdgeHelper(hashset_);
     }
+
+    void Graph2DOut::placeContainers(uint numThreads)
+    {
+        numa::placeRows(outEdges_, numThreads);
+        numa::placeRows(hashset_, numThreads);
+    }
 }
\ No newline at end of file
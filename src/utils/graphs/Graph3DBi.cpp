@@ -1,46 +1,105 @@
 #include "utils/graphs/Graph3DBi.hpp"
 
 namespace gracfl {
-    Graph3DBi::Graph3DBi(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph3DBi::Graph3DBi(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph3DBi::Graph3DBi(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph3DBi::Graph3DBi(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
+    Graph3DBi::~Graph3DBi()
+    {
+        clearContainers();
+    }
+
     void Graph3DBi::initContainers()
     {
-        outEdges_.assign(getNodeSize(), std::vector<TemporalVector>(getLabelSize()));
-        inEdges_.assign(getNodeSize(), std::vector<TemporalVector>(getLabelSize()));
-        hashset_.assign(getNodeSize(), std::vector<std::unordered_set<ull>>(getLabelSize(), std::unordered_set<ull>()));
+        initRows(outEdges_, getNodeSize(), std::vector<TemporalVector>(getLabelSize(), TemporalVector(&getArena())));
+        initRows(inEdges_, getNodeSize(), std::vector<TemporalVector>(getLabelSize(), TemporalVector(&getArena())));
+        initRows(hashset_, getNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
     }
 
     void Graph3DBi::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by source, then by destination, in parallel, and each vertex is
+        // filled by one thread; duplicates of an input edge are dropped, fresh marks first occurrences
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        std::vector<char> fresh(edges.size(), 0);
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            hashset_[edge.from][edge.label].insert(edge.to);
-            outEdges_[edge.from][edge.label].vertexList.push_back(edge.to);
-            inEdges_[edge.to][edge.label].vertexList.push_back(edge.from);
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = outEdges_[v];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                hashset_[v][label].reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (hashset_[v][edge.label].insert(edge.to).second)
+                {
+                    fresh[order[k]] = 1;
+                    lists[edge.label].vertexList.push_back(edge.to);
+                    lists[edge.label].NEW_END++;
+                }
+            }
+        }
 
-            // update the sliding pointers
-            outEdges_[edge.from][edge.label].NEW_END++;
-            inEdges_[edge.to][edge.label].NEW_END++;
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = inEdges_[v];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (fresh[order[k]])
+                {
+                    lists[edge.label].vertexList.push_back(edge.from);
+                    lists[edge.label].NEW_END++;
+                }
+            }
         }
     }
 
     void Graph3DBi::clearContainers()
     {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
         outEdges_.clear();
         inEdges_.clear();
         hashset_.clear();
+        getArena().release();
     }
 
 
@@ -54,6 +113,22 @@ namespace gracfl {
         }
     }
 
+    void Graph3DBi::checkAndAddEdges(uint from, uint label, const uint* targets, size_t count, bool& terminate)
+    {
+        // survivors are staged, the targets may live in the list they are appended to
+        static thread_local std::vector<uint> added;
+        if (added.size() < count) added.resize(count);
+        size_t n = hashset_[from][label].insertBatch(targets, count, added.data());
+        if (n == 0) return;
+        auto& list = outEdges_[from][label].vertexList;
+        list.insert(list.end(), added.begin(), added.begin() + n);
+        for (size_t k = 0; k < n; k++)
+        {
+            inEdges_[added[k]][label].vertexList.push_back(from);
+        }
+        terminate = false;
+    }
+
     void Graph3DBi::addSelfEdge(Edge& edge)
     {
         if (hashset_[edge.from][edge.label].find(edge.to) == hashset_[edge.from][edge.label].end())
@@ -66,6 +141,17 @@ namespace gracfl {
         }
     }
 
+    void Graph3DBi::releaseLabel(uint label)
+    {
+        // the freed blocks go back to the arena's free lists and serve later allocations
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            outEdges_[v][label] = TemporalVector(&getArena());
+            inEdges_[v][label] = TemporalVector(&getArena());
+            hashset_[v][label] = FlatHashset(ArenaAllocator<ull>(&getArena()));
+        }
+    }
+
     ull Graph3DBi::countEdge()
     {
         return countEdgeHelper(hashset_);
@@ -1,15 +1,15 @@
 #include "utils/graphs/Graph3DBiConcurrent.hpp"
 
 namespace gracfl {
-    Graph3DBiConcurrent::Graph3DBiConcurrent(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph3DBiConcurrent::Graph3DBiConcurrent(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph3DBiConcurrent::Graph3DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph3DBiConcurrent::Graph3DBiConcurrent(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
@@ -17,22 +17,72 @@ namespace gracfl {
 
     void Graph3DBiConcurrent::initContainers()
     {
-        outEdges_.assign(getNodeSize(), std::vector<TemporalVectorConcurrent>(getLabelSize()));
-        inEdges_.assign(getNodeSize(), std::vector<TemporalVectorConcurrent>(getLabelSize()));
-        hashset_.assign(getNodeSize(), std::vector<tbb::concurrent_unordered_set<ull>>(getLabelSize(), tbb::concurrent_unordered_set<ull>()));
+        initRows(outEdges_, getNodeSize(), std::vector<TemporalVectorConcurrent>(getLabelSize()));
+        initRows(inEdges_, getNodeSize(), std::vector<TemporalVectorConcurrent>(getLabelSize()));
+        initRows(hashset_, getNodeSize(), std::vector<tbb::concurrent_unordered_set<ull>>(getLabelSize(), tbb::concurrent_unordered_set<ull>()));
     }
 
     void Graph3DBiConcurrent::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by source, then by destination, in parallel, and each vertex is
+        // filled by one thread; duplicates of an input edge are dropped, fresh marks first occurrences
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        std::vector<char> fresh(edges.size(), 0);
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            hashset_[edge.from][edge.label].insert(edge.to);
-            outEdges_[edge.from][edge.label].vertexList.push_back(edge.to);
-            inEdges_[edge.to][edge.label].vertexList.push_back(edge.from);
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = outEdges_[v];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (hashset_[v][edge.label].insert(edge.to).second)
+                {
+                    fresh[order[k]] = 1;
+                    lists[edge.label].vertexList.push_back(edge.to);
+                    lists[edge.label].NEW_END++;
+                }
+            }
+        }
 
-            // update the sliding pointers
-            outEdges_[edge.from][edge.label].NEW_END++;
-            inEdges_[edge.to][edge.label].NEW_END++;
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = inEdges_[v];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (fresh[order[k]])
+                {
+                    lists[edge.label].vertexList.push_back(edge.from);
+                    lists[edge.label].NEW_END++;
+                }
+            }
         }
     }
 
@@ -70,4 +120,11 @@ namespace gracfl {
     {
         return countEdgeHelperConcurrent(hashset_);
     }
+
+    void Graph3DBiConcurrent::placeContainers(uint numThreads)
+    {
+        numa::placeRows(outEdges_, numThreads);
+        numa::placeRows(inEdges_, numThreads);
+        numa::placeRows(hashset_, numThreads);
+    }
 }
\ No newline at end of file
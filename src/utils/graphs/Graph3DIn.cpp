@@ -1,42 +1,74 @@
 #include "utils/graphs/Graph3DIn.hpp"
 
 namespace gracfl {
-    Graph3DIn::Graph3DIn(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph3DIn::Graph3DIn(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph3DIn::Graph3DIn(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph3DIn::Graph3DIn(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
+    Graph3DIn::~Graph3DIn()
+    {
+        clearContainers();
+    }
+
     void Graph3DIn::initContainers()
     {
-        inEdges_.assign(getNodeSize(), std::vector<TemporalVector>(getLabelSize()));
-        inHashset_.assign(getNodeSize(), std::vector<std::unordered_set<ull>>(getLabelSize(), std::unordered_set<ull>()));
+        initRows(inEdges_, getNodeSize(), std::vector<TemporalVector>(getLabelSize(), TemporalVector(&getArena())));
+        initRows(inHashset_, getNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
     }
 
     void Graph3DIn::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by destination in parallel, then each destination is filled by one thread;
+        // duplicates of an input edge are dropped
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            inHashset_[edge.to][edge.label].insert(edge.from);
-            inEdges_[edge.to][edge.label].vertexList.push_back(edge.from);
-
-            // update the sliding pointers
-            inEdges_[edge.to][edge.label].NEW_END++;
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = inEdges_[v];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                inHashset_[v][label].reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (inHashset_[v][edge.label].insert(edge.from).second)
+                {
+                    lists[edge.label].vertexList.push_back(edge.from);
+                    lists[edge.label].NEW_END++;
+                }
+            }
         }
     }
 
     void Graph3DIn::clearContainers()
     {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
         inEdges_.clear();
         inHashset_.clear();
+        getArena().release();
     }
 
     void Graph3DIn::checkAndAddEdge(Edge& edge, bool& terminate)
@@ -48,6 +80,18 @@ namespace gracfl {
         }
     }
     
+    void Graph3DIn::checkAndAddEdges(uint to, uint label, const uint* sources, size_t count, bool& terminate)
+    {
+        // survivors are staged, the sources may live in the list they are appended to
+        static thread_local std::vector<uint> added;
+        if (added.size() < count) added.resize(count);
+        size_t n = inHashset_[to][label].insertBatch(sources, count, added.data());
+        if (n == 0) return;
+        auto& list = inEdges_[to][label].vertexList;
+        list.insert(list.end(), added.begin(), added.begin() + n);
+        terminate = false;
+    }
+
     void Graph3DIn::addSelfEdge(Edge& edge)
     {
         if (inHashset_[edge.to][edge.label].find(edge.from) == inHashset_[edge.to][edge.label].end())
@@ -58,8 +102,52 @@ namespace gracfl {
         }
     }
 
+    bool Graph3DIn::stageEdge(Edge& edge)
+    {
+        if (!inHashset_[edge.to][edge.label].insert(edge.from).second) return false;
+        if (staging_.direct()) inEdges_[edge.to][edge.label].vertexList.push_back(edge.from);
+        else staging_.add(edge.to, edge.label, edge.from);
+        return true;
+    }
+
+    size_t Graph3DIn::stageEdges(uint to, uint label, const uint* sources, size_t count)
+    {
+        static thread_local std::vector<uint> added;
+        if (added.size() < count) added.resize(count);
+        size_t n = inHashset_[to][label].insertBatch(sources, count, added.data());
+        if (staging_.direct())
+        {
+            auto& list = inEdges_[to][label].vertexList;
+            list.insert(list.end(), added.begin(), added.begin() + n);
+        }
+        else
+        {
+            staging_.add(to, label, added.data(), n);
+        }
+        return n;
+    }
+
+    void Graph3DIn::beginStaging(uint numThreads)
+    {
+        staging_.reset(numThreads, getLabelSize());
+    }
+
+    void Graph3DIn::commitStaged(uint thread)
+    {
+        staging_.commit(thread, [this](uint vertex, uint label, const uint* entries, size_t count) {
+            auto& list = inEdges_[vertex][label].vertexList;
+            list.insert(list.end(), entries, entries + count);
+        });
+    }
+
     ull Graph3DIn::countEdge()
     {
         return countEdgeHelper(inHashset_);
     }
+
+    void Graph3DIn::placeContainers(uint numThreads)
+    {
+        numa::placeRows(inEdges_, numThreads);
+        numa::placeRows(inHashset_, numThreads);
+    }
 }
\ No newline at end of file
@@ -1,46 +1,91 @@
 #include "utils/graphs/Graph3DOut.hpp"
 
 namespace gracfl {
-    Graph3DOut::Graph3DOut(std::string& graphfilepath, const Grammar& grammar)
-        : Graph(graphfilepath, grammar) 
+    Graph3DOut::Graph3DOut(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
 
-    Graph3DOut::Graph3DOut(std::vector<Edge>& edges, const Grammar& grammar)
-        : Graph(edges, grammar) 
+    Graph3DOut::Graph3DOut(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads) 
     {
         initContainers();
         addInitialEdges();
     }
     
+    Graph3DOut::~Graph3DOut()
+    {
+        clearContainers();
+    }
+
     void Graph3DOut::initContainers()
     {
-        outEdges_.assign(getNodeSize(), std::vector<TemporalVector>(getLabelSize()));
-        hashset_.assign(getNodeSize(), std::vector<std::unordered_set<ull>>(getLabelSize(), std::unordered_set<ull>()));
+        initRows(outEdges_, getNodeSize(), std::vector<TemporalVector>(getLabelSize(), TemporalVector(&getArena())));
+        initRows(hashset_, getNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
     }
 
     void Graph3DOut::addInitialEdges()
     {
-        for (Edge edge : getEdges())
+        // the edges are grouped by source in parallel, then each source is filled by one thread;
+        // duplicates of an input edge are dropped
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < getNodeSize(); v++)
         {
-            hashset_[edge.from][edge.label].insert(edge.to);
-            outEdges_[edge.from][edge.label].vertexList.push_back(edge.to);
-
-            // update the sliding pointers
-            outEdges_[edge.from][edge.label].NEW_END++;
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = outEdges_[v];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                hashset_[v][label].reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (hashset_[v][edge.label].insert(edge.to).second)
+                {
+                    lists[edge.label].vertexList.push_back(edge.to);
+                    lists[edge.label].NEW_END++;
+                }
+            }
         }
     }
 
     void Graph3DOut::clearContainers()
     {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
         outEdges_.clear();
         hashset_.clear();
+        getArena().release();
+    }
+
+    const uint* Graph3DOut::redirected(const uint* targets, size_t count)
+    {
+        if (redirect_ == nullptr) return targets;
+        static thread_local std::vector<uint> mapped;
+        if (mapped.size() < count) mapped.resize(count);
+        for (size_t k = 0; k < count; k++)
+        {
+            mapped[k] = redirect_[targets[k]];
+        }
+        return mapped.data();
     }
 
     void Graph3DOut::checkAndAddEdge(Edge& edge, bool& terminate)
     {
+        if (redirect_) edge.to = redirect_[edge.to];
         if (hashset_[edge.from][edge.label].find(edge.to) == hashset_[edge.from][edge.label].end()) {
             hashset_[edge.from][edge.label].insert(edge.to);
             outEdges_[edge.from][edge.label].vertexList.push_back(edge.to);
@@ -48,6 +93,19 @@ namespace gracfl {
         }
     }
 
+    void Graph3DOut::checkAndAddEdges(uint from, uint label, const uint* targets, size_t count, bool& terminate)
+    {
+        // survivors are staged, the targets may live in the list they are appended to
+        static thread_local std::vector<uint> added;
+        if (added.size() < count) added.resize(count);
+        targets = redirected(targets, count);
+        size_t n = hashset_[from][label].insertBatch(targets, count, added.data());
+        if (n == 0) return;
+        auto& list = outEdges_[from][label].vertexList;
+        list.insert(list.end(), added.begin(), added.begin() + n);
+        terminate = false;
+    }
+
     void Graph3DOut::addSelfEdge(Edge& edge)
     {
         if (hashset_[edge.from][edge.label].find(edge.to) == hashset_[edge.from][edge.label].end())
@@ -58,8 +116,75 @@ namespace gracfl {
         }
     }
 
+    bool Graph3DOut::stageEdge(Edge& edge)
+    {
+        if (redirect_) edge.to = redirect_[edge.to];
+        if (!hashset_[edge.from][edge.label].insert(edge.to).second) return false;
+        if (staging_.direct()) outEdges_[edge.from][edge.label].vertexList.push_back(edge.to);
+        else staging_.add(edge.from, edge.label, edge.to);
+        return true;
+    }
+
+    size_t Graph3DOut::stageEdges(uint from, uint label, const uint* targets, size_t count)
+    {
+        static thread_local std::vector<uint> added;
+        if (added.size() < count) added.resize(count);
+        targets = redirected(targets, count);
+        size_t n = hashset_[from][label].insertBatch(targets, count, added.data());
+        if (staging_.direct())
+        {
+            auto& list = outEdges_[from][label].vertexList;
+            list.insert(list.end(), added.begin(), added.begin() + n);
+        }
+        else
+        {
+            staging_.add(from, label, added.data(), n);
+        }
+        return n;
+    }
+
+    void Graph3DOut::beginStaging(uint numThreads)
+    {
+        staging_.reset(numThreads, getLabelSize());
+    }
+
+    void Graph3DOut::commitStaged(uint thread)
+    {
+        staging_.commit(thread, [this](uint vertex, uint label, const uint* entries, size_t count) {
+            auto& list = outEdges_[vertex][label].vertexList;
+            list.insert(list.end(), entries, entries + count);
+        });
+    }
+
+    void Graph3DOut::mergeRows(uint from, uint into)
+    {
+        for (uint label = 0; label < getLabelSize(); label++)
+        {
+            TemporalVector& source = outEdges_[from][label];
+            TemporalVector& target = outEdges_[into][label];
+            FlatHashset& seen = hashset_[into][label];
+            for (uint vertex : source.vertexList)
+            {
+                uint to = redirect_ ? redirect_[vertex] : vertex;
+                if (seen.insert(to).second) target.vertexList.push_back(to);
+            }
+            target.OLD_END = 0;
+            target.NEW_END = target.vertexList.size();
+
+            source.vertexList = ArenaVector<uint>(source.vertexList.get_allocator());
+            source.OLD_END = source.NEW_END = 0;
+            hashset_[from][label] = FlatHashset(ArenaAllocator<ull>(&getArena()));
+        }
+    }
+
     ull Graph3DOut::countEdge()
     {
         return countEdgeHelper(hashset_);
     }
+
+    void Graph3DOut::placeContainers(uint numThreads)
+    {
+        numa::placeRows(outEdges_, numThreads);
+        numa::placeRows(hashset_, numThreads);
+    }
 }
\ No newline at end of file
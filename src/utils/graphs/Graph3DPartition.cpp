@@ -0,0 +1,161 @@
+#include <algorithm>
+#include "utils/graphs/Graph3DPartition.hpp"
+
+namespace gracfl {
+    Graph3DPartition::Graph3DPartition(std::string& graphfilepath, const Grammar& grammar, uint rank, uint numRanks)
+        : Graph(graphfilepath, grammar)
+        , rank_(rank)
+        , numRanks_(numRanks)
+    {
+        computeRange();
+        initContainers();
+        addInitialEdges();
+    }
+
+    Graph3DPartition::Graph3DPartition(std::vector<Edge>& edges, const Grammar& grammar, uint rank, uint numRanks)
+        : Graph(edges, grammar)
+        , rank_(rank)
+        , numRanks_(numRanks)
+    {
+        computeRange();
+        initContainers();
+        addInitialEdges();
+    }
+
+    void Graph3DPartition::computeRange()
+    {
+        uint nodeSize = getNodeSize();
+        chunk_ = std::max<uint>(1, (nodeSize + numRanks_ - 1) / numRanks_);
+        begin_ = std::min<ull>((ull)rank_ * chunk_, nodeSize);
+        end_ = std::min<ull>((ull)begin_ + chunk_, nodeSize);
+    }
+
+    Graph3DPartition::~Graph3DPartition()
+    {
+        clearContainers();
+    }
+
+    void Graph3DPartition::initContainers()
+    {
+        initRows(outEdges_, getLocalNodeSize(), std::vector<TemporalVector>(getLabelSize(), TemporalVector(&getArena())));
+        initRows(inEdges_, getLocalNodeSize(), std::vector<TemporalVector>(getLabelSize(), TemporalVector(&getArena())));
+        initRows(outHashset_, getLocalNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
+        initRows(inHashset_, getLocalNodeSize(), std::vector<FlatHashset>(getLabelSize(), FlatHashset(ArenaAllocator<ull>(&getArena()))));
+    }
+
+    void Graph3DPartition::addInitialEdges()
+    {
+        // the edges are grouped by source, then by destination, in parallel, and each owned vertex
+        // is filled by one thread; duplicates of an input edge are dropped
+        const std::vector<Edge>& edges = getEdges();
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        groupEdges(&Edge::from, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = begin_; v < end_; v++)
+        {
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = outEdges_[toLocal(v)];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                outHashset_[toLocal(v)][label].reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (outHashset_[toLocal(v)][edge.label].insert(edge.to).second)
+                {
+                    lists[edge.label].vertexList.push_back(edge.to);
+                    lists[edge.label].NEW_END++;
+                }
+            }
+        }
+
+        groupEdges(&Edge::to, getNodeSize(), offsets, order);
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = begin_; v < end_; v++)
+        {
+            // size the lists exactly, NEW_END counts the edges per label first
+            auto& lists = inEdges_[toLocal(v)];
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                lists[edges[order[k]].label].NEW_END++;
+            }
+            for (uint label = 0; label < getLabelSize(); label++)
+            {
+                if (lists[label].NEW_END == 0) continue;
+                lists[label].vertexList.reserve(lists[label].NEW_END);
+                inHashset_[toLocal(v)][label].reserve(lists[label].NEW_END);
+                lists[label].NEW_END = 0;
+            }
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                const Edge& edge = edges[order[k]];
+                if (inHashset_[toLocal(v)][edge.label].insert(edge.from).second)
+                {
+                    lists[edge.label].vertexList.push_back(edge.from);
+                    lists[edge.label].NEW_END++;
+                }
+            }
+        }
+
+        // every rank only keeps the edges of its own vertices
+        std::vector<Edge>().swap(getEdges());
+    }
+
+    void Graph3DPartition::clearContainers()
+    {
+        // containers are destroyed without recycling, then the arenas are freed chunk-wise
+        getArena().beginTeardown();
+        outEdges_.clear();
+        inEdges_.clear();
+        outHashset_.clear();
+        inHashset_.clear();
+        getArena().release();
+    }
+
+    void Graph3DPartition::checkAndAddOutEdge(Edge& edge, bool& terminate)
+    {
+        uint src = toLocal(edge.from);
+        if (outHashset_[src][edge.label].insert(edge.to).second) {
+            outEdges_[src][edge.label].vertexList.push_back(edge.to);
+            terminate = false;
+        }
+    }
+
+    void Graph3DPartition::checkAndAddInEdge(Edge& edge, bool& terminate)
+    {
+        uint dst = toLocal(edge.to);
+        if (inHashset_[dst][edge.label].insert(edge.from).second) {
+            inEdges_[dst][edge.label].vertexList.push_back(edge.from);
+            terminate = false;
+        }
+    }
+
+    void Graph3DPartition::addSelfEdge(Edge& edge)
+    {
+        uint v = toLocal(edge.from);
+        if (outHashset_[v][edge.label].insert(edge.to).second)
+        {
+            outEdges_[v][edge.label].vertexList.push_back(edge.to);
+            outEdges_[v][edge.label].NEW_END++;
+        }
+        if (inHashset_[v][edge.label].insert(edge.from).second)
+        {
+            inEdges_[v][edge.label].vertexList.push_back(edge.from);
+            inEdges_[v][edge.label].NEW_END++;
+        }
+    }
+
+    ull Graph3DPartition::countEdge()
+    {
+        return countEdgeHelper(outHashset_);
+    }
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cmath>
+#include "utils/graphs/GraphBdd.hpp"
+
+namespace gracfl {
+    GraphBdd::GraphBdd(std::string& graphfilepath, const Grammar& grammar, const std::string& order)
+        : Graph(graphfilepath, grammar)
+    {
+        initRelations(order);
+    }
+
+    GraphBdd::GraphBdd(std::vector<Edge>& edges, const Grammar& grammar, const std::string& order)
+        : Graph(edges, grammar)
+    {
+        initRelations(order);
+    }
+
+    GraphBdd::~GraphBdd()
+    {
+        delete manager_;
+    }
+
+    void GraphBdd::initRelations(const std::string& order)
+    {
+        interleaved_ = order != "sequential";
+        bits_ = 1;
+        while (bits_ < 32 && ((getNodeSize() - 1) >> bits_) != 0) bits_++;
+        const uint levels = 3 * bits_;
+        manager_ = new BddManager(levels);
+
+        std::vector<uint> yToZ(levels), xToZ(levels), zLevels;
+        for (uint level = 0; level < levels; level++)
+        {
+            yToZ[level] = xToZ[level] = level;
+        }
+        for (uint bit = 0; bit < bits_; bit++)
+        {
+            yToZ[levelOf(Y, bit)] = levelOf(Z, bit);
+            xToZ[levelOf(X, bit)] = levelOf(Z, bit);
+            zLevels.push_back(levelOf(Z, bit));
+            pairBits_.emplace_back(X, bit);
+            pairBits_.emplace_back(Y, bit);
+        }
+        std::sort(pairBits_.begin(), pairBits_.end(), [this](const auto& a, const auto& b) {
+            return levelOf(a.first, a.second) < levelOf(b.first, b.second);
+        });
+        yToZ_ = manager_->addRenaming(yToZ);
+        xToZ_ = manager_->addRenaming(xToZ);
+        zCube_ = manager_->cube(zLevels);
+
+        uint labelSize = getLabelSize();
+        std::vector<std::vector<ull>> keys(labelSize);
+        for (const Edge& edge : getEdges())
+        {
+            keys[edge.label].push_back(keyOf(edge.from, edge.to));
+        }
+        old_.assign(labelSize, BddManager::FALSE);
+        delta_.assign(labelSize, BddManager::FALSE);
+        for (uint label = 0; label < labelSize; label++)
+        {
+            std::sort(keys[label].begin(), keys[label].end());
+            keys[label].erase(std::unique(keys[label].begin(), keys[label].end()), keys[label].end());
+            delta_[label] = build(keys[label], 0, keys[label].size(), 0);
+        }
+        gcThreshold_ = std::max(manager_->capacity() / 2, 2 * manager_->liveNodes());
+    }
+
+    ull GraphBdd::keyOf(uint source, uint target) const
+    {
+        ull key = 0;
+        for (const auto& bit : pairBits_)
+        {
+            uint vertex = bit.first == X ? source : target;
+            key = (key << 1) | ((vertex >> (bits_ - 1 - bit.second)) & 1);
+        }
+        return key;
+    }
+
+    GraphBdd::Node GraphBdd::build(const std::vector<ull>& keys, size_t lo, size_t hi, uint depth)
+    {
+        if (lo == hi) return BddManager::FALSE;
+        if (depth == pairBits_.size()) return BddManager::TRUE;
+        const ull mask = 1ULL << (pairBits_.size() - 1 - depth);
+        size_t mid = std::partition_point(keys.begin() + lo, keys.begin() + hi, [mask](ull key) {
+            return (key & mask) == 0;
+        }) - keys.begin();
+        Node low = build(keys, lo, mid, depth + 1);
+        Node high = build(keys, mid, hi, depth + 1);
+        return manager_->mk(levelOf(pairBits_[depth].first, pairBits_[depth].second), low, high);
+    }
+
+    void GraphBdd::addSelfEdges(uint label)
+    {
+        std::vector<ull> keys(getNodeSize());
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            keys[v] = keyOf(v, v);
+        }
+        std::sort(keys.begin(), keys.end());
+        delta_[label] = manager_->disjoin(delta_[label], build(keys, 0, keys.size(), 0));
+    }
+
+    GraphBdd::Node GraphBdd::compose(Node left, Node right)
+    {
+        // left(x, z) ∧ right(z, y), with z quantified away during the conjunction
+        Node leftXZ = manager_->replace(left, yToZ_);
+        Node rightZY = manager_->replace(right, xToZ_);
+        return manager_->relprod(leftXZ, rightZY, zCube_);
+    }
+
+    void GraphBdd::merge(uint label, Node added)
+    {
+        old_[label] = manager_->disjoin(old_[label], delta_[label]);
+        delta_[label] = added;
+    }
+
+    ull GraphBdd::countRelation(Node relation)
+    {
+        // the middle bits are free in a relation, every edge is counted 2^bits_ times
+        return std::llround(std::ldexp(manager_->satCount(relation), -int(bits_)));
+    }
+
+    void GraphBdd::collectGarbage(const std::vector<Node>& roots)
+    {
+        if (manager_->liveNodes() < gcThreshold_) return;
+        std::vector<Node> live(roots);
+        live.insert(live.end(), old_.begin(), old_.end());
+        live.insert(live.end(), delta_.begin(), delta_.end());
+        live.push_back(zCube_);
+        manager_->collect(live);
+        gcThreshold_ = std::max(gcThreshold_, 2 * manager_->liveNodes());
+    }
+
+    ull GraphBdd::countEdge()
+    {
+        ull size = 0;
+        for (uint label = 0; label < getLabelSize(); label++)
+        {
+            size += countRelation(old_[label]) + countRelation(delta_[label]);
+        }
+        return size;
+    }
+
+    std::vector<uint> GraphBdd::expand(const std::vector<int8_t>& values, uint domain) const
+    {
+        std::vector<uint> result(1, 0);
+        for (uint bit = 0; bit < bits_; bit++)
+        {
+            int8_t value = values[levelOf(domain, bit)];
+            size_t size = result.size();
+            if (value < 0)
+            {
+                result.resize(size * 2);
+                for (size_t k = 0; k < size; k++)
+                {
+                    result[size + k] = (result[k] << 1) | 1;
+                    result[k] <<= 1;
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < size; k++)
+                {
+                    result[k] = (result[k] << 1) | uint(value);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> GraphBdd::toHashset()
+    {
+        uint nodeSize = getNodeSize();
+        uint labelSize = getLabelSize();
+        std::vector<std::vector<std::unordered_set<ull>>> result(nodeSize, std::vector<std::unordered_set<ull>>(labelSize));
+        for (uint label = 0; label < labelSize; label++)
+        {
+            for (Node relation : {old_[label], delta_[label]})
+            {
+                manager_->forEachPath(relation, [&](const std::vector<int8_t>& values) {
+                    std::vector<uint> targets = expand(values, Y);
+                    for (uint source : expand(values, X))
+                    {
+                        for (uint target : targets)
+                        {
+                            result[source][label].insert(target);
+                        }
+                    }
+                });
+            }
+        }
+        return result;
+    }
+}
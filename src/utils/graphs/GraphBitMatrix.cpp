@@ -0,0 +1,123 @@
+#include "utils/graphs/GraphBitMatrix.hpp"
+
+namespace gracfl {
+    GraphBitMatrix::GraphBitMatrix(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads)
+    {
+        initMatrices();
+    }
+
+    GraphBitMatrix::GraphBitMatrix(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads)
+    {
+        initMatrices();
+    }
+
+    void GraphBitMatrix::initMatrices()
+    {
+        uint nodeSize = getNodeSize();
+        uint labelSize = getLabelSize();
+        full_.assign(labelSize, BitMatrix());
+        delta_.assign(labelSize, BitMatrix());
+        for (uint label = 0; label < labelSize; label++)
+        {
+            full_[label].allocate(nodeSize);
+            delta_[label].allocate(nodeSize);
+        }
+        for (const Edge& edge : getEdges())
+        {
+            full_[edge.label].set(edge.from, edge.to);
+            delta_[edge.label].set(edge.from, edge.to);
+        }
+        for (uint label = 0; label < labelSize; label++)
+        {
+            updateActive(full_[label]);
+            updateActive(delta_[label]);
+        }
+    }
+
+    void GraphBitMatrix::addSelfEdges(uint label)
+    {
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            if (full_[label].test(v, v)) continue;
+            full_[label].set(v, v);
+            delta_[label].set(v, v);
+        }
+        updateActive(full_[label]);
+        updateActive(delta_[label]);
+    }
+
+    void GraphBitMatrix::updateActive(BitMatrix& matrix)
+    {
+        if (!matrix.allocated())
+        {
+            matrix.any = false;
+            return;
+        }
+        bool any = false;
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads()) reduction(||:any)
+        for (uint i = 0; i < matrix.rows; i++)
+        {
+            const uint64_t* row = matrix.row(i);
+            uint64_t bits = 0;
+            for (uint w = 0; w < matrix.words; w++)
+            {
+                bits |= row[w];
+            }
+            matrix.active[i] = bits != 0;
+            any = any || bits != 0;
+        }
+        matrix.any = any;
+    }
+
+    ull GraphBitMatrix::countEdge()
+    {
+        ull size = 0;
+        for (const BitMatrix& matrix : full_)
+        {
+            for (uint64_t word : matrix.bits)
+            {
+                size += __builtin_popcountll(word);
+            }
+        }
+        return size;
+    }
+
+    ull GraphBitMatrix::memoryBytes() const
+    {
+        ull bytes = 0;
+        for (const std::vector<BitMatrix>* matrices : {&full_, &delta_})
+        {
+            for (const BitMatrix& matrix : *matrices)
+            {
+                bytes += matrix.bits.size() * sizeof(uint64_t) + matrix.active.size();
+            }
+        }
+        return bytes;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> GraphBitMatrix::toHashset()
+    {
+        uint nodeSize = getNodeSize();
+        uint labelSize = getLabelSize();
+        std::vector<std::vector<std::unordered_set<ull>>> result(nodeSize, std::vector<std::unordered_set<ull>>(labelSize));
+        for (uint label = 0; label < labelSize; label++)
+        {
+            const BitMatrix& matrix = full_[label];
+            for (uint v = 0; v < nodeSize; v++)
+            {
+                if (!matrix.active[v]) continue;
+                const uint64_t* row = matrix.row(v);
+                for (uint w = 0; w < matrix.words; w++)
+                {
+                    for (uint64_t bits = row[w]; bits; bits &= bits - 1)
+                    {
+                        result[v][label].insert(w * 64 + __builtin_ctzll(bits));
+                    }
+                }
+            }
+        }
+        return result;
+    }
+}
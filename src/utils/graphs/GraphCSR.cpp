@@ -0,0 +1,243 @@
+#include <algorithm>
+#include "utils/graphs/GraphCSR.hpp"
+
+namespace gracfl {
+    GraphCSR::GraphCSR(std::string& graphfilepath, const Grammar& grammar, bool sharedSets, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads)
+        , sharedSets_(sharedSets)
+    {
+        initMatrices();
+    }
+
+    GraphCSR::GraphCSR(std::vector<Edge>& edges, const Grammar& grammar, bool sharedSets, uint numThreads)
+        : Graph(edges, grammar, numThreads)
+        , sharedSets_(sharedSets)
+    {
+        initMatrices();
+    }
+
+    void GraphCSR::initMatrices()
+    {
+        const std::vector<Edge>& edges = getEdges();
+        uint nodeSize = getNodeSize();
+        uint labelSize = getLabelSize();
+        old_.assign(labelSize, CSRMatrix());
+        delta_.assign(labelSize, CSRMatrix());
+        oldSets_.assign(labelSize, std::vector<uint>());
+
+        std::vector<bool> present(labelSize, false);
+        for (const Edge& edge : edges)
+        {
+            present[edge.label] = true;
+        }
+        for (uint label = 0; label < labelSize; label++)
+        {
+            if (present[label]) delta_[label].rowPtr.assign(nodeSize + 1, 0);
+        }
+
+        // the edges of a source are sorted by (label, target), so duplicates are adjacent and
+        // each row is filled in order
+        std::vector<ull> offsets;
+        std::vector<uint> order;
+        groupEdges(&Edge::from, nodeSize, offsets, order);
+        auto before = [&](uint a, uint b) {
+            return edges[a].label != edges[b].label ? edges[a].label < edges[b].label : edges[a].to < edges[b].to;
+        };
+        auto duplicate = [&](ull k) {
+            return edges[order[k]].label == edges[order[k - 1]].label && edges[order[k]].to == edges[order[k - 1]].to;
+        };
+        #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            std::sort(order.begin() + offsets[v], order.begin() + offsets[v + 1], before);
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                if (k == offsets[v] || !duplicate(k)) delta_[edges[order[k]].label].rowPtr[v + 1]++;
+            }
+        }
+        for (uint label = 0; label < labelSize; label++)
+        {
+            if (!present[label]) continue;
+            std::vector<ull>& rowPtr = delta_[label].rowPtr;
+            for (uint v = 0; v < nodeSize; v++)
+            {
+                rowPtr[v + 1] += rowPtr[v];
+            }
+            delta_[label].colIdx.resize(rowPtr[nodeSize]);
+        }
+        #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            for (ull k = offsets[v]; k < offsets[v + 1]; k++)
+            {
+                if (k != offsets[v] && duplicate(k)) continue;
+                const Edge& edge = edges[order[k]];
+                CSRMatrix& matrix = delta_[edge.label];
+                matrix.colIdx[matrix.rowPtr[v]++] = edge.to;
+            }
+        }
+        // the fill advanced every row offset to the start of the next row
+        for (uint label = 0; label < labelSize; label++)
+        {
+            if (!present[label]) continue;
+            std::vector<ull>& rowPtr = delta_[label].rowPtr;
+            for (uint v = nodeSize; v > 0; v--)
+            {
+                rowPtr[v] = rowPtr[v - 1];
+            }
+            rowPtr[0] = 0;
+        }
+    }
+
+    void GraphCSR::addSelfEdges(uint label)
+    {
+        uint nodeSize = getNodeSize();
+        const CSRMatrix& delta = delta_[label];
+        CSRMatrix result;
+        result.rowPtr.assign(nodeSize + 1, 0);
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            const uint* row = delta.rowSize(v) ? delta.row(v) : nullptr;
+            bool hasLoop = row && std::binary_search(row, row + delta.rowSize(v), v);
+            result.rowPtr[v + 1] = result.rowPtr[v] + delta.rowSize(v) + (hasLoop ? 0 : 1);
+        }
+        result.colIdx.resize(result.rowPtr[nodeSize]);
+        #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            uint* out = result.colIdx.data() + result.rowPtr[v];
+            const uint* row = delta.rowSize(v) ? delta.row(v) : nullptr;
+            const uint* end = row ? row + delta.rowSize(v) : nullptr;
+            const uint* mid = std::lower_bound(row, end, v);
+            out = std::copy(row, mid, out);
+            if (mid == end || *mid != v) *out++ = v;
+            std::copy(mid, end, out);
+        }
+        delta_[label] = std::move(result);
+    }
+
+    void GraphCSR::merge(uint label, CSRMatrix&& added)
+    {
+        uint nodeSize = getNodeSize();
+        CSRMatrix& old = old_[label];
+        CSRMatrix& delta = delta_[label];
+        if (sharedSets_)
+        {
+            mergeShared(label);
+        }
+        else if (old.empty())
+        {
+            old = std::move(delta);
+        }
+        else if (!delta.empty())
+        {
+            // the two are disjoint, so the offsets of the union are the sums of theirs
+            CSRMatrix result;
+            result.rowPtr.resize(nodeSize + 1);
+            #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+            for (uint v = 0; v <= nodeSize; v++)
+            {
+                result.rowPtr[v] = old.rowPtr[v] + delta.rowPtr[v];
+            }
+            result.colIdx.resize(result.rowPtr[nodeSize]);
+            #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+            for (uint v = 0; v < nodeSize; v++)
+            {
+                const uint* a = old.colIdx.data() + old.rowPtr[v];
+                const uint* b = delta.colIdx.data() + delta.rowPtr[v];
+                std::merge(a, a + old.rowSize(v), b, b + delta.rowSize(v), result.colIdx.data() + result.rowPtr[v]);
+            }
+            old = std::move(result);
+        }
+        delta = std::move(added);
+    }
+
+    void GraphCSR::mergeShared(uint label)
+    {
+        const CSRMatrix& delta = delta_[label];
+        if (delta.empty()) return;
+        uint nodeSize = getNodeSize();
+        std::vector<uint>& sets = oldSets_[label];
+        if (sets.empty()) sets.assign(nodeSize, SetPool::EMPTY);
+
+        // the rows that gain edges build their grown set, the sets they held stay as they are
+        std::vector<uint> grown;
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            if (delta.rowSize(v)) grown.push_back(v);
+        }
+        std::vector<std::vector<uint>> unions(grown.size());
+        std::vector<ull> hashes(grown.size());
+        #pragma omp parallel for schedule(dynamic, numa::VERTEX_CHUNK) num_threads(getNumThreads())
+        for (size_t k = 0; k < grown.size(); k++)
+        {
+            uint v = grown[k];
+            const std::vector<uint>& old = pool_.get(sets[v]);
+            unions[k].resize(old.size() + delta.rowSize(v));
+            std::merge(old.begin(), old.end(), delta.row(v), delta.row(v) + delta.rowSize(v), unions[k].begin());
+            hashes[k] = SetPool::hashOf(unions[k].data(), unions[k].size());
+        }
+        for (size_t k = 0; k < grown.size(); k++)
+        {
+            uint v = grown[k];
+            uint id = pool_.intern(std::move(unions[k]), hashes[k]);
+            pool_.release(sets[v]);
+            sets[v] = id;
+        }
+    }
+
+    ull GraphCSR::countEdge()
+    {
+        ull size = 0;
+        for (uint label = 0; label < getLabelSize(); label++)
+        {
+            size += delta_[label].nnz();
+            if (!sharedSets_)
+            {
+                size += old_[label].nnz();
+                continue;
+            }
+            for (uint v = 0; v < oldSets_[label].size(); v++)
+            {
+                size += pool_.get(oldSets_[label][v]).size();
+            }
+        }
+        return size;
+    }
+
+    ull GraphCSR::countOldRows()
+    {
+        ull rows = 0;
+        for (uint label = 0; label < getLabelSize(); label++)
+        {
+            for (uint v = 0; v < getNodeSize(); v++)
+            {
+                rows += oldRowSize(label, v) > 0;
+            }
+        }
+        return rows;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> GraphCSR::toHashset()
+    {
+        uint nodeSize = getNodeSize();
+        uint labelSize = getLabelSize();
+        std::vector<std::vector<std::unordered_set<ull>>> result(nodeSize, std::vector<std::unordered_set<ull>>(labelSize));
+        for (uint v = 0; v < nodeSize; v++)
+        {
+            for (uint label = 0; label < labelSize; label++)
+            {
+                if (oldRowSize(label, v))
+                {
+                    result[v][label].insert(oldRow(label, v), oldRow(label, v) + oldRowSize(label, v));
+                }
+                const CSRMatrix& delta = delta_[label];
+                if (delta.rowSize(v))
+                {
+                    result[v][label].insert(delta.row(v), delta.row(v) + delta.rowSize(v));
+                }
+            }
+        }
+        return result;
+    }
+}
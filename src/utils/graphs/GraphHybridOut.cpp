@@ -0,0 +1,85 @@
+#include "utils/graphs/GraphHybridOut.hpp"
+
+namespace gracfl {
+    GraphHybridOut::GraphHybridOut(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph3DOut(graphfilepath, grammar, numThreads)
+    {
+    }
+
+    GraphHybridOut::GraphHybridOut(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph3DOut(edges, grammar, numThreads)
+    {
+    }
+
+    GraphHybridOut::~GraphHybridOut()
+    {
+        // the arenas are freed in bulk by ~Graph3DOut
+        getArena().beginTeardown();
+        lbldEdges_.clear();
+    }
+
+    void GraphHybridOut::initView(std::vector<ull>& delta, std::vector<ull>& total)
+    {
+        uint labelSize = getLabelSize();
+        delta.assign(labelSize, 0);
+        total.assign(labelSize, 0);
+        ull* deltaCount = delta.data();
+        ull* totalCount = total.data();
+
+        initRows(lbldEdges_, getNodeSize(), TemporalVectorWithLbldVtx(&getArena()));
+        #pragma omp parallel for schedule(static, numa::VERTEX_CHUNK) num_threads(getNumThreads()) \
+            reduction(+:deltaCount[:labelSize], totalCount[:labelSize])
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            auto& view = lbldEdges_[v];
+            for (uint label = 0; label < labelSize; label++)
+            {
+                const TemporalVector& row = outEdges_[v][label];
+                for (uint k = 0; k < row.NEW_END; k++)
+                {
+                    view.vertexList.push_back(LbldVtx(row.vertexList[k], label));
+                }
+                deltaCount[label] += row.NEW_END - row.OLD_END;
+                totalCount[label] += row.NEW_END;
+            }
+            view.NEW_END = view.vertexList.size();
+        }
+    }
+
+    void GraphHybridOut::slidePointers(uint numThreads, std::vector<ull>& delta, std::vector<ull>& total)
+    {
+        uint labelSize = getLabelSize();
+        delta.assign(labelSize, 0);
+        total.assign(labelSize, 0);
+        ull* deltaCount = delta.data();
+        ull* totalCount = total.data();
+
+        #pragma omp parallel for schedule(static, 512) num_threads(numThreads) \
+            reduction(+:deltaCount[:labelSize], totalCount[:labelSize])
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            auto& view = lbldEdges_[v];
+            for (uint label = 0; label < labelSize; label++)
+            {
+                TemporalVector& row = outEdges_[v][label];
+                uint size = row.vertexList.size();
+                for (uint k = row.NEW_END; k < size; k++)
+                {
+                    view.vertexList.push_back(LbldVtx(row.vertexList[k], label));
+                }
+                row.OLD_END = row.NEW_END;
+                row.NEW_END = size;
+                deltaCount[label] += size - row.OLD_END;
+                totalCount[label] += size;
+            }
+            view.OLD_END = view.NEW_END;
+            view.NEW_END = view.vertexList.size();
+        }
+    }
+
+    void GraphHybridOut::placeContainers(uint numThreads)
+    {
+        Graph3DOut::placeContainers(numThreads);
+        numa::placeRows(lbldEdges_, numThreads);
+    }
+}
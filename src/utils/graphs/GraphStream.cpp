@@ -0,0 +1,199 @@
+#include <algorithm>
+#include "utils/graphs/GraphStream.hpp"
+
+namespace gracfl {
+    GraphStream::GraphStream(std::string& graphfilepath, const Grammar& grammar, uint numThreads)
+        : Graph(graphfilepath, grammar, numThreads)
+    {
+        initStreams();
+    }
+
+    GraphStream::GraphStream(std::vector<Edge>& edges, const Grammar& grammar, uint numThreads)
+        : Graph(edges, grammar, numThreads)
+    {
+        initStreams();
+    }
+
+    void GraphStream::initStreams()
+    {
+        uint labelSize = getLabelSize();
+        uint bits = 0;
+        while (bits < 32 && ((getNodeSize() - 1) >> bits) != 0) bits++;
+        partitionShift_ = bits > RADIX_BITS ? bits - RADIX_BITS : 0;
+
+        old_.assign(labelSize, EdgeArrays());
+        delta_.assign(labelSize, EdgeArrays());
+        for (const Edge& edge : getEdges())
+        {
+            delta_[edge.label].bySource.push_back(COMBINE(edge.from, edge.to));
+        }
+        for (EdgeArrays& arrays : delta_)
+        {
+            if (arrays.empty()) continue;
+            radixSort(arrays.bySource);
+            arrays.bySource.erase(std::unique(arrays.bySource.begin(), arrays.bySource.end()), arrays.bySource.end());
+            arrays.byTarget = transpose(arrays.bySource);
+        }
+    }
+
+    void GraphStream::addSelfEdges(uint label)
+    {
+        EdgeArrays& delta = delta_[label];
+        std::vector<ull> loops(getNodeSize());
+        for (uint v = 0; v < getNodeSize(); v++)
+        {
+            loops[v] = COMBINE(v, v);
+        }
+        std::vector<ull> result;
+        result.reserve(delta.size() + loops.size());
+        std::set_union(delta.bySource.begin(), delta.bySource.end(), loops.begin(), loops.end(), std::back_inserter(result));
+        delta.bySource = std::move(result);
+        delta.byTarget = transpose(delta.bySource);
+    }
+
+    void GraphStream::merge(uint label, std::vector<ull>&& added)
+    {
+        EdgeArrays& old = old_[label];
+        EdgeArrays& delta = delta_[label];
+        if (old.empty())
+        {
+            old = std::move(delta);
+        }
+        else if (!delta.empty())
+        {
+            mergeSorted(old.bySource, delta.bySource);
+            mergeSorted(old.byTarget, delta.byTarget);
+        }
+        delta.bySource = std::move(added);
+        delta.byTarget = delta.bySource.empty() ? std::vector<ull>() : transpose(delta.bySource);
+    }
+
+    std::pair<ull, ull> GraphStream::partitionRange(const std::vector<ull>& keys, uint p) const
+    {
+        // the bound of the last partition may not fit a key, it ends with the array
+        auto boundOf = [&](uint q) {
+            if (q == 0) return ull(0);
+            if (q == numPartitions()) return ull(keys.size());
+            ull first = ull(q) << partitionShift_ << 32;
+            return ull(std::lower_bound(keys.begin(), keys.end(), first) - keys.begin());
+        };
+        return {boundOf(p), boundOf(p + 1)};
+    }
+
+    std::vector<ull> GraphStream::partition(const std::vector<ull>& keys, std::vector<ull>& out, bool swap) const
+    {
+        const uint parts = numPartitions();
+        const uint chunks = getNumThreads();
+        const ull chunkSize = (keys.size() + chunks - 1) / chunks;
+        auto partOf = [&](ull key) { return partitionOf(swap ? uint(key) : uint(key >> 32)); };
+
+        // per chunk of keys, the size of every partition, then where the chunk writes into it
+        std::vector<ull> positions(static_cast<size_t>(chunks) * parts, 0);
+        #pragma omp parallel for schedule(static, 1) num_threads(getNumThreads())
+        for (uint c = 0; c < chunks; c++)
+        {
+            ull* count = positions.data() + static_cast<size_t>(c) * parts;
+            ull end = std::min<ull>(keys.size(), (c + 1) * chunkSize);
+            for (ull k = c * chunkSize; k < end; k++)
+            {
+                count[partOf(keys[k])]++;
+            }
+        }
+        std::vector<ull> offsets(parts + 1, 0);
+        ull position = 0;
+        for (uint p = 0; p < parts; p++)
+        {
+            offsets[p] = position;
+            for (uint c = 0; c < chunks; c++)
+            {
+                ull count = positions[static_cast<size_t>(c) * parts + p];
+                positions[static_cast<size_t>(c) * parts + p] = position;
+                position += count;
+            }
+        }
+        offsets[parts] = position;
+
+        out.resize(keys.size());
+        #pragma omp parallel for schedule(static, 1) num_threads(getNumThreads())
+        for (uint c = 0; c < chunks; c++)
+        {
+            ull* next = positions.data() + static_cast<size_t>(c) * parts;
+            ull end = std::min<ull>(keys.size(), (c + 1) * chunkSize);
+            for (ull k = c * chunkSize; k < end; k++)
+            {
+                ull key = keys[k];
+                out[next[partOf(key)]++] = swap ? COMBINE(uint(key), (key >> 32)) : key;
+            }
+        }
+        return offsets;
+    }
+
+    void GraphStream::radixSort(std::vector<ull>& keys) const
+    {
+        std::vector<ull> sorted;
+        std::vector<ull> offsets = partition(keys, sorted, false);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(getNumThreads())
+        for (uint p = 0; p < numPartitions(); p++)
+        {
+            std::sort(sorted.begin() + offsets[p], sorted.begin() + offsets[p + 1]);
+        }
+        keys = std::move(sorted);
+    }
+
+    std::vector<ull> GraphStream::transpose(const std::vector<ull>& keys) const
+    {
+        std::vector<ull> swapped;
+        std::vector<ull> offsets = partition(keys, swapped, true);
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(getNumThreads())
+        for (uint p = 0; p < numPartitions(); p++)
+        {
+            std::sort(swapped.begin() + offsets[p], swapped.begin() + offsets[p + 1]);
+        }
+        return swapped;
+    }
+
+    void GraphStream::mergeSorted(std::vector<ull>& into, const std::vector<ull>& add) const
+    {
+        // keys of a partition precede those of later partitions in both, so every partition
+        // lands at the sum of its offsets in the two inputs
+        std::vector<ull> result(into.size() + add.size());
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(getNumThreads())
+        for (uint p = 0; p < numPartitions(); p++)
+        {
+            std::pair<ull, ull> a = partitionRange(into, p);
+            std::pair<ull, ull> b = partitionRange(add, p);
+            std::merge(into.begin() + a.first, into.begin() + a.second,
+                       add.begin() + b.first, add.begin() + b.second,
+                       result.begin() + a.first + b.first);
+        }
+        into = std::move(result);
+    }
+
+    ull GraphStream::countEdge()
+    {
+        ull size = 0;
+        for (uint label = 0; label < getLabelSize(); label++)
+        {
+            size += old_[label].size() + delta_[label].size();
+        }
+        return size;
+    }
+
+    std::vector<std::vector<std::unordered_set<ull>>> GraphStream::toHashset()
+    {
+        uint nodeSize = getNodeSize();
+        uint labelSize = getLabelSize();
+        std::vector<std::vector<std::unordered_set<ull>>> result(nodeSize, std::vector<std::unordered_set<ull>>(labelSize));
+        for (uint label = 0; label < labelSize; label++)
+        {
+            for (const EdgeArrays* arrays : {&old_[label], &delta_[label]})
+            {
+                for (ull key : arrays->bySource)
+                {
+                    result[key >> 32][label].insert(uint(key));
+                }
+            }
+        }
+        return result;
+    }
+}
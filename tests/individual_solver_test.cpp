@@ -3,6 +3,9 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <filesystem>
+#include <sstream>
+#include <set>
 #include <unordered_set>
 
 // Include all solver headers
@@ -18,8 +21,19 @@
 #include "solvers/SolverBWTopoParallel.hpp"
 #include "solvers/SolverFWGramParallel.hpp"
 #include "solvers/SolverFWTopoParallel.hpp"
+#include "solvers/SolverBIGramDistributed.hpp"
+#include "solvers/SolverDyck.hpp"
+#include "solvers/SolverSpGEMM.hpp"
+#include "solvers/SolverBitMatrix.hpp"
+#include "solvers/SolverStream.hpp"
+#include "solvers/SolverBdd.hpp"
+#include "solvers/SolverFWHybrid.hpp"
+#include "solvers/SolverSelector.hpp"
+#include "solvers/Solver.hpp"
 #include "utils/Grammar.hpp"
 #include "utils/Edges.hpp"
+#include "utils/Contraction.hpp"
+#include "utils/Reordering.hpp"
 
 namespace gracfl {
 
@@ -40,11 +54,10 @@ std::vector<Edge> loadEdgesFromFile(const std::string& graphfilepath, const Gram
         infile >> newEdge.to;
         infile >> label;
         
-        if (grammar.getSymbolToIDMap().find(label) == grammar.getSymbolToIDMap().end()) {
+        if (!grammar.parseLabel(label, newEdge.label, newEdge.index)) {
             continue;
         }
         
-        newEdge.label = grammar.getSymbolToIDMap().at(label);
         edges.push_back(newEdge);
     }
     infile.close();
@@ -162,6 +175,618 @@ bool testParallelSolver(const std::string& solverName,
     }
 }
 
+/**
+ * @brief Test the asynchronous mode of a solver against its synchronous mode
+ *
+ * @param args Constructor arguments between the grammar and the asynchronous flag.
+ */
+template<typename SolverType, typename... Args>
+bool testAsyncSolver(const std::string& solverName,
+                     const std::string& graphfilepath,
+                     const std::string& grammarfilepath,
+                     Args... args) {
+    std::cout << "Testing " << solverName << " (asynchronous)..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        std::vector<Edge> edges1 = loadEdgesFromFile(graphfilepath, grammar);
+        std::vector<Edge> edges2 = edges1;
+
+        SolverType solver1(edges1, grammar, args..., false);
+        solver1.runCFL();
+        auto graph1 = solver1.getGraph();
+        auto count1 = solver1.getEdgeCount();
+
+        SolverType solver2(edges2, grammar, args..., true);
+        solver2.runCFL();
+        auto graph2 = solver2.getGraph();
+        auto count2 = solver2.getEdgeCount();
+
+        // Compare results
+        if (count1 != count2) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << ")" << std::endl;
+            return false;
+        }
+
+        if (!compareGraphs(graph1, graph2)) {
+            std::cout << " FAILED: Graph structures differ" << std::endl;
+            return false;
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Test the stratified evaluation of SolverBIGram against the global fixpoint, for all labels
+ *        and for one output label per stratum
+ */
+bool testStratifiedSolver(const std::string& graphfilepath,
+                          const std::string& grammarfilepath) {
+    std::cout << "Testing SolverBIGram (stratified)..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+        std::vector<Edge> edges1 = edges;
+        std::vector<Edge> edges2 = edges;
+
+        SolverBIGram solver1(edges1, grammar);
+        solver1.runCFL();
+        auto graph1 = solver1.getGraph();
+        auto count1 = solver1.getEdgeCount();
+
+        SolverBIGram solver2(edges2, grammar, false, true);
+        solver2.runCFL();
+        auto graph2 = solver2.getGraph();
+        auto count2 = solver2.getEdgeCount();
+
+        // Compare results
+        if (count1 != count2) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << ")" << std::endl;
+            return false;
+        }
+
+        if (!compareGraphs(graph1, graph2)) {
+            std::cout << " FAILED: Graph structures differ" << std::endl;
+            return false;
+        }
+
+        // only the requested label is kept
+        for (const auto& stratum : grammar.getStrata()) {
+            uint label = stratum.front();
+            std::vector<Edge> edges3 = edges;
+            SolverBIGram solver3(edges3, grammar, false, true, {label});
+            solver3.runCFL();
+            auto graph3 = solver3.getGraph();
+            ull count = 0, count3 = solver3.getEdgeCount();
+            for (size_t v = 0; v < graph1.size(); v++) {
+                count += graph1[v][label].size();
+                if (graph1[v][label] != graph3[v][label]) {
+                    std::cout << " FAILED: Graph structures differ for output label "
+                              << grammar.getIDToSymbolMap().at(label) << std::endl;
+                    return false;
+                }
+            }
+            if (count != count3) {
+                std::cout << " FAILED: Edge counts differ for output label " << grammar.getIDToSymbolMap().at(label)
+                          << " (" << count << " vs " << count3 << ")" << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ", strata: " << grammar.getStrata().size() << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Test a solver against a reference solver on the same graph and grammar
+ *
+ * The solver under test is built from the graph file, the reference from the loaded edges.
+ *
+ * @param description Printed name and settings of the solver under test.
+ * @param args Constructor arguments of the solver under test after the grammar.
+ */
+template<typename SolverType, typename ReferenceType = SolverBIGram, typename... Args>
+bool testAgainstReference(const std::string& description,
+                          const std::string& graphfilepath,
+                          const std::string& grammarfilepath,
+                          Args... args) {
+    std::cout << "Testing " << description << "..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+
+        std::string graphpath = graphfilepath;
+        SolverType solver(graphpath, grammar, args...);
+        solver.runCFL();
+        auto graph1 = solver.getGraph();
+        auto count1 = solver.getEdgeCount();
+
+        ReferenceType reference(edges, grammar);
+        reference.runCFL();
+        auto graph2 = reference.getGraph();
+        auto count2 = reference.getEdgeCount();
+
+        // Compare results
+        if (count1 != count2) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << ")" << std::endl;
+            return false;
+        }
+
+        if (!compareGraphs(graph1, graph2)) {
+            std::cout << " FAILED: Graph structures differ" << std::endl;
+            return false;
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Test the SpGEMM solver, serial and with threads, with and without shared sets, against SolverBIGram
+ */
+bool testSpGEMMSolver(const std::string& graphfilepath,
+                      const std::string& grammarfilepath,
+                      uint numThreads = 2) {
+    return testAgainstReference<SolverSpGEMM>("SolverSpGEMM (vs. SolverBIGram)", graphfilepath, grammarfilepath)
+        && testAgainstReference<SolverSpGEMM>("SolverSpGEMM (threads=" + std::to_string(numThreads) + ", vs. SolverBIGram)",
+                                              graphfilepath, grammarfilepath, numThreads)
+        && testAgainstReference<SolverSpGEMM>("SolverSpGEMM (threads=" + std::to_string(numThreads) + ", shared sets, vs. SolverBIGram)",
+                                              graphfilepath, grammarfilepath, numThreads, true);
+}
+
+/**
+ * @brief Test the bit-matrix solver, both kernels, serial and with threads, against SolverBIGram
+ */
+bool testBitMatrixSolver(const std::string& graphfilepath,
+                         const std::string& grammarfilepath,
+                         uint numThreads = 2) {
+    return testAgainstReference<SolverBitMatrix>("SolverBitMatrix (four-russians, vs. SolverBIGram)", graphfilepath, grammarfilepath)
+        && testAgainstReference<SolverBitMatrix>("SolverBitMatrix (four-russians, threads=" + std::to_string(numThreads) + ", vs. SolverBIGram)",
+                                                 graphfilepath, grammarfilepath, numThreads)
+        && testAgainstReference<SolverBitMatrix>("SolverBitMatrix (naive, threads=" + std::to_string(numThreads) + ", vs. SolverBIGram)",
+                                                 graphfilepath, grammarfilepath, numThreads, false);
+}
+
+/**
+ * @brief Test the edge-centric streaming solver, serial and with threads, against SolverBIGram
+ */
+bool testStreamSolver(const std::string& graphfilepath,
+                      const std::string& grammarfilepath,
+                      uint numThreads = 2) {
+    return testAgainstReference<SolverStream>("SolverStream (vs. SolverBIGram)", graphfilepath, grammarfilepath)
+        && testAgainstReference<SolverStream>("SolverStream (threads=" + std::to_string(numThreads) + ", vs. SolverBIGram)",
+                                              graphfilepath, grammarfilepath, numThreads);
+}
+
+/**
+ * @brief Test the BDD solver, with both variable orders, against SolverBIGram
+ */
+bool testBddSolver(const std::string& graphfilepath,
+                   const std::string& grammarfilepath) {
+    return testAgainstReference<SolverBdd>("SolverBdd (interleaved, vs. SolverBIGram)", graphfilepath, grammarfilepath)
+        && testAgainstReference<SolverBdd>("SolverBdd (sequential, vs. SolverBIGram)", graphfilepath, grammarfilepath,
+                                           std::string("sequential"));
+}
+
+/**
+ * @brief Test the Dyck solver against the generic bidirectional grammar-driven solver
+ */
+bool testDyckSolver(const std::string& graphfilepath,
+                    const std::string& grammarfilepath) {
+    std::cout << "Testing SolverDyck (vs. SolverBIGram)..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        if (!grammar.isDyck()) {
+            std::cout << " FAILED: Grammar is not Dyck-shaped" << std::endl;
+            return false;
+        }
+        std::vector<Edge> edges1 = loadEdgesFromFile(graphfilepath, grammar);
+        std::vector<Edge> edges2 = edges1;
+
+        std::string graphpath = graphfilepath;
+        SolverDyck solver1(graphpath, grammar);
+        solver1.runCFL();
+        auto graph1 = solver1.getGraph();
+        auto count1 = solver1.getEdgeCount();
+
+        SolverDyck solver2(edges1, grammar);
+        solver2.runCFL();
+        auto graph2 = solver2.getGraph();
+        auto count2 = solver2.getEdgeCount();
+
+        SolverBIGram reference(edges2, grammar);
+        reference.runCFL();
+        auto graph3 = reference.getGraph();
+        auto count3 = reference.getEdgeCount();
+
+        // Compare results
+        if (count1 != count2 || count1 != count3) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << " vs " << count3 << ")" << std::endl;
+            return false;
+        }
+
+        if (!compareGraphs(graph1, graph2) || !compareGraphs(graph1, graph3)) {
+            std::cout << " FAILED: Graph structures differ" << std::endl;
+            return false;
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Test the Dyck solver on an indexed grammar against SolverBIGram on the grammar expanded per index
+ */
+bool testIndexedDyckSolver(const std::string& graphfilepath,
+                           const std::string& grammarfilepath) {
+    std::cout << "Testing SolverDyck with indexed labels (vs. SolverBIGram, expanded)..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        if (!grammar.isDyck() || !grammar.hasIndexedLabels()) {
+            std::cout << " FAILED: Grammar is not Dyck-shaped with indexed labels" << std::endl;
+            return false;
+        }
+        std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+
+        // one copy of every indexed rule per index of the graph, the family op_i becomes op_<n>
+        std::set<uint> indices;
+        for (const Edge& edge : edges) {
+            if (grammar.isIndexed(edge.label)) indices.insert(edge.index);
+        }
+        std::filesystem::path expandedPath = std::filesystem::temp_directory_path() / "gracfl_expanded_grammar.txt";
+        {
+            std::ifstream in(grammarfilepath);
+            std::ofstream out(expandedPath);
+            std::string line, symbol;
+            const auto& ids = grammar.getSymbolToIDMap();
+            auto isFamily = [&](const std::string& s) {
+                auto it = ids.find(s);
+                return it != ids.end() && grammar.isIndexed(it->second);
+            };
+            while (std::getline(in, line)) {
+                std::vector<std::string> symbols;
+                std::istringstream ss(line);
+                bool indexed = false;
+                while (ss >> symbol) {
+                    symbols.push_back(symbol);
+                    indexed = indexed || isFamily(symbol);
+                }
+                if (!symbols.empty() && symbols[0] == "%indexed") continue;
+                for (uint index : indexed ? indices : std::set<uint>{0}) {
+                    for (size_t i = 0; i < symbols.size(); i++) {
+                        std::string s = symbols[i];
+                        if (isFamily(s)) {
+                            s = s.substr(0, s.size() - 1) + std::to_string(index);
+                        }
+                        out << (i ? " " : "") << s;
+                    }
+                    out << "\n";
+                }
+            }
+        }
+        Grammar expanded(expandedPath.string());
+        std::vector<Edge> expandedEdges = loadEdgesFromFile(graphfilepath, expanded);
+        std::filesystem::remove(expandedPath);
+
+        std::string graphpath = graphfilepath;
+        SolverDyck solver1(graphpath, grammar);
+        solver1.runCFL();
+        auto graph1 = solver1.getGraph();
+        auto count1 = solver1.getEdgeCount();
+
+        SolverDyck solver2(edges, grammar);
+        solver2.runCFL();
+        auto graph2 = solver2.getGraph();
+        auto count2 = solver2.getEdgeCount();
+
+        SolverBIGram reference(expandedEdges, expanded);
+        reference.runCFL();
+        auto graph3 = reference.getGraph();
+        auto count3 = reference.getEdgeCount();
+
+        // Compare results, S is the only label without an index
+        if (count1 != count2 || count1 != count3) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << " vs " << count3 << ")" << std::endl;
+            return false;
+        }
+
+        uint S = grammar.dyckStart_;
+        uint expandedS = expanded.getSymbolToIDMap().at(grammar.getIDToSymbolMap().at(S));
+        bool same = compareGraphs(graph1, graph2) && graph1.size() == graph3.size();
+        for (size_t v = 0; same && v < graph1.size(); v++) {
+            same = graph1[v][S] == graph3[v][expandedS];
+        }
+        if (!same) {
+            std::cout << " FAILED: Graph structures differ" << std::endl;
+            return false;
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Test a graph contraction: solve the contracted graph, expand, compare with the input solved as is
+ */
+template<typename ContractionType>
+bool testContraction(const std::string& contractionName,
+                     const std::string& graphfilepath,
+                     const std::string& grammarfilepath) {
+    std::cout << "Testing " << contractionName << " (SolverBIGram)..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+
+        SolverBIGram solver1(edges, grammar);
+        solver1.runCFL();
+        auto graph1 = solver1.getGraph();
+        auto count1 = solver1.getEdgeCount();
+
+        ContractionType contraction(edges, grammar);
+        contraction.printStats();
+        SolverBIGram solver2(contraction.getEdges(), grammar);
+        solver2.runCFL();
+        auto graph2 = contraction.expand(solver2.getGraph());
+        auto count2 = contraction.expandEdgeCount(solver2.getGraph());
+
+        // Compare results
+        if (count1 != count2) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << ")" << std::endl;
+            return false;
+        }
+
+        if (!compareGraphs(graph1, graph2)) {
+            std::cout << " FAILED: Graph structures differ" << std::endl;
+            return false;
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+/**
+ * @brief Test the label-major sweep of the fw/bw gram-driven solvers, serial and with 2 threads, against the vertex-major sweep
+ */
+bool testLabelMajorSweep(const std::string& graphfilepath,
+                         const std::string& grammarfilepath) {
+    // every label-major solver next to the vertex-major solver of the same direction
+    uint distance = prefetch::DEFAULT_DISTANCE;
+    return testAgainstReference<SolverFWGram, SolverFWGram>("SolverFWGram (label-major, vs. vertex-major)",
+                                                            graphfilepath, grammarfilepath, distance, false, true)
+        && testAgainstReference<SolverBWGram, SolverBWGram>("SolverBWGram (label-major, vs. vertex-major)",
+                                                            graphfilepath, grammarfilepath, distance, true)
+        && testAgainstReference<SolverFWGramParallel, SolverFWGram>("SolverFWGramParallel (label-major, threads=2, vs. vertex-major)",
+                                                                    graphfilepath, grammarfilepath, 2u, false, distance, false, true)
+        && testAgainstReference<SolverBWGramParallel, SolverBWGram>("SolverBWGramParallel (label-major, threads=2, vs. vertex-major)",
+                                                                    graphfilepath, grammarfilepath, 2u, false, distance, true);
+}
+
+/**
+ * @brief Test online cycle collapsing in SolverFWGram, serial and with 2 threads, against SolverBIGram
+ */
+bool testCycleCollapsing(const std::string& graphfilepath,
+                         const std::string& grammarfilepath) {
+    uint distance = prefetch::DEFAULT_DISTANCE;
+    return testAgainstReference<SolverFWGram>("SolverFWGram (cycle collapsing, vs. SolverBIGram)",
+                                              graphfilepath, grammarfilepath, distance, true)
+        && testAgainstReference<SolverFWGramParallel>("SolverFWGramParallel (cycle collapsing, threads=2, vs. SolverBIGram)",
+                                                      graphfilepath, grammarfilepath, 2u, false, distance, true);
+}
+
+/**
+ * @brief Test the hybrid fw solver, serial and with 2 threads, against SolverBIGram
+ */
+bool testHybridSolver(const std::string& graphfilepath,
+                      const std::string& grammarfilepath) {
+    return testAgainstReference<SolverFWHybrid>("SolverFWHybrid (vs. SolverBIGram)", graphfilepath, grammarfilepath)
+        && testAgainstReference<SolverFWHybrid>("SolverFWHybrid (threads=2, vs. SolverBIGram)", graphfilepath, grammarfilepath, 2u);
+}
+
+/**
+ * @brief Test automatic solver selection, from the cost model and from calibration probes, against SolverBIGram
+ */
+bool testAutoSelection(const std::string& graphfilepath,
+                       const std::string& grammarfilepath) {
+    Grammar grammar(grammarfilepath);
+    std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+    SolverBIGram reference(edges, grammar);
+    reference.runCFL();
+    auto graph2 = reference.getGraph();
+    auto count2 = reference.getEdgeCount();
+
+    for (bool calibration : {false, true}) {
+        std::string description = calibration ? "auto settings (calibration)" : "auto settings (cost model)";
+        std::cout << "Testing " << description << "..." << std::flush;
+
+        try {
+            Config config;
+            config.graphFilepath = graphfilepath;
+            config.grammarFilepath = grammarfilepath;
+            config.executionMode = "auto";
+            config.traversalDirection = "auto";
+            config.processingStrategy = "auto";
+            config.numThreads = 2;
+            config.calibration = calibration;
+
+            // bw is never an automatic candidate
+            SolverSelector selector(edges, grammar, config.numThreads);
+            for (const SolverChoice& choice : selector.rank(config)) {
+                if (choice.traversalDirection == "bw") {
+                    std::cout << " FAILED: bw ranked as a candidate" << std::endl;
+                    return false;
+                }
+            }
+
+            std::streambuf* out = std::cout.rdbuf(nullptr);
+            Solver solver(config);
+            solver.solve();
+            auto graph1 = solver.getGraph();
+            std::cout.rdbuf(out);
+            ull count1 = 0;
+            for (const auto& row : graph1) {
+                for (const auto& set : row) {
+                    count1 += set.size();
+                }
+            }
+            std::cout << " " << config.executionMode << " " << config.traversalDirection << " "
+                      << config.processingStrategy << std::flush;
+
+            // Compare results
+            if (count1 != count2) {
+                std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << ")" << std::endl;
+                return false;
+            }
+
+            if (!compareGraphs(graph1, graph2)) {
+                std::cout << " FAILED: Graph structures differ" << std::endl;
+                return false;
+            }
+
+            std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+
+        } catch (const std::exception& e) {
+            std::cout << " FAILED: " << e.what() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Test every vertex order against the run on the input ids (SolverBIGram)
+ */
+bool testReordering(const std::string& graphfilepath,
+                    const std::string& grammarfilepath) {
+    std::cout << "Testing VertexReordering (SolverBIGram)..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+
+        SolverBIGram solver1(edges, grammar);
+        solver1.runCFL();
+        auto graph1 = solver1.getGraph();
+        auto count1 = solver1.getEdgeCount();
+
+        for (const std::string order : {"degree", "rcm", "community"}) {
+            VertexReordering reordering(edges, grammar, order);
+            reordering.printStats();
+            SolverBIGram solver2(reordering.getEdges(), grammar);
+            solver2.runCFL();
+            auto graph2 = reordering.restore(solver2.getGraph());
+            auto count2 = solver2.getEdgeCount();
+
+            // Compare results
+            if (count1 != count2) {
+                std::cout << " FAILED: Edge counts differ for " << order << " (" << count1 << " vs " << count2 << ")" << std::endl;
+                return false;
+            }
+
+            if (!compareGraphs(graph1, graph2)) {
+                std::cout << " FAILED: Graph structures differ for " << order << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+#ifdef GRACFL_USE_MPI
+/**
+ * @brief Test the distributed solver against SolverBIGram: the closure gathered on rank 0, and the
+ *        owned rows of every rank
+ * @param roundBytes Bytes per exchange round and gather message, 0 for the default.
+ */
+bool testDistributedSolver(const std::string& description,
+                           const std::string& graphfilepath,
+                           const std::string& grammarfilepath,
+                           size_t roundBytes = 0) {
+    std::cout << "Testing " << description << "..." << std::flush;
+
+    try {
+        Grammar grammar(grammarfilepath);
+        std::vector<Edge> edges = loadEdgesFromFile(graphfilepath, grammar);
+
+        std::string graphpath = graphfilepath;
+        SolverBIGramDistributed solver(graphpath, grammar);
+        if (roundBytes != 0) solver.setRoundBytes(roundBytes);
+        solver.runCFL();
+        auto graph1 = solver.getGraph();
+        auto local = solver.getLocalGraph();
+        auto count1 = solver.getEdgeCount();
+
+        SolverBIGram reference(edges, grammar);
+        reference.runCFL();
+        auto graph2 = reference.getGraph();
+        auto count2 = reference.getEdgeCount();
+
+        if (count1 != count2) {
+            std::cout << " FAILED: Edge counts differ (" << count1 << " vs " << count2 << ")" << std::endl;
+            return false;
+        }
+        if (solver.getRank() == 0 ? !compareGraphs(graph1, graph2) : !graph1.empty()) {
+            std::cout << " FAILED: Gathered graph differs on rank " << solver.getRank() << std::endl;
+            return false;
+        }
+        std::vector<std::vector<std::unordered_set<ull>>> owned(graph2.begin() + solver.getBegin(),
+                                                                graph2.begin() + solver.getBegin() + local.size());
+        if (!compareGraphs(local, owned)) {
+            std::cout << " FAILED: Local graph differs on rank " << solver.getRank() << std::endl;
+            return false;
+        }
+
+        std::cout << " PASSED (edges: " << count1 << ")" << std::endl;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cout << " FAILED: " << e.what() << std::endl;
+        return false;
+    }
+}
+#endif
+
 } // namespace gracfl
 
 /**
@@ -173,6 +798,21 @@ int main(int argc, char* argv[]) {
         std::cerr << "Available solvers:" << std::endl;
         std::cerr << "  Basic: BIGram, BITopo, BWGram, BWTopo, FWGram, FWTopo" << std::endl;
         std::cerr << "  Parallel: BIGramParallel, BITopoParallel, BWGramParallel, BWTopoParallel, FWGramParallel, FWTopoParallel" << std::endl;
+        std::cerr << "  Asynchronous (vs. synchronous): BIGramAsync, BIGramParallelAsync" << std::endl;
+        std::cerr << "  Stratified evaluation (vs. global fixpoint, BIGram): Stratified" << std::endl;
+        std::cerr << "  Masked sparse matrix products, with shared sets (vs. BIGram): SpGEMM" << std::endl;
+        std::cerr << "  Bit matrices, Four-Russians and naive kernels (vs. BIGram): BitMatrix" << std::endl;
+        std::cerr << "  Edge-centric streaming joins (vs. BIGram): Stream" << std::endl;
+        std::cerr << "  Binary decision diagrams, both variable orders (vs. BIGram): Bdd" << std::endl;
+        std::cerr << "  Dyck grammars (vs. BIGram): Dyck" << std::endl;
+        std::cerr << "  Dyck grammars with indexed labels (vs. BIGram, expanded): DyckIndexed" << std::endl;
+        std::cerr << "  Graph contractions (vs. uncontracted BIGram): SCC, Merge" << std::endl;
+        std::cerr << "  Online cycle collapsing, FWGram serial and parallel (vs. BIGram): Cycles" << std::endl;
+        std::cerr << "  Label-major sweep, FWGram and BWGram serial and parallel (vs. vertex-major): LabelMajor" << std::endl;
+        std::cerr << "  Per-iteration choice of gram- or topo-driven fw sweeps, serial and parallel (vs. BIGram): Hybrid" << std::endl;
+        std::cerr << "  Vertex orders (vs. input ids, BIGram): Reorder" << std::endl;
+        std::cerr << "  Automatic selection, cost model and calibration (vs. BIGram): Auto" << std::endl;
+        std::cerr << "  Distributed (vs. BIGram, run under mpirun): BIGramDistributed" << std::endl;
         return 1;
     }
     
@@ -209,14 +849,84 @@ int main(int argc, char* argv[]) {
     } else if (solverName == "BITopoParallel") {
         result = gracfl::testParallelSolver<gracfl::SolverBITopoParallel>("SolverBITopoParallel", graphfilepath, grammarfilepath);
     } else if (solverName == "BWGramParallel") {
-        result = gracfl::testParallelSolver<gracfl::SolverBWGramParallel>("SolverBWGramParallel", graphfilepath, grammarfilepath);
+        // a team of one thread appends its edges right away instead of staging them
+        result = gracfl::testParallelSolver<gracfl::SolverBWGramParallel>("SolverBWGramParallel", graphfilepath, grammarfilepath)
+              && gracfl::testAgainstReference<gracfl::SolverBWGramParallel, gracfl::SolverBWGram>("SolverBWGramParallel (threads=1, vs. SolverBWGram)",
+                                                                                graphfilepath, grammarfilepath, 1u);
     } else if (solverName == "BWTopoParallel") {
-        result = gracfl::testParallelSolver<gracfl::SolverBWTopoParallel>("SolverBWTopoParallel", graphfilepath, grammarfilepath);
+        // a team of one thread appends its edges right away instead of staging them
+        result = gracfl::testParallelSolver<gracfl::SolverBWTopoParallel>("SolverBWTopoParallel", graphfilepath, grammarfilepath)
+              && gracfl::testAgainstReference<gracfl::SolverBWTopoParallel, gracfl::SolverBWTopo>("SolverBWTopoParallel (threads=1, vs. SolverBWTopo)",
+                                                                                graphfilepath, grammarfilepath, 1u);
     } else if (solverName == "FWGramParallel") {
-        result = gracfl::testParallelSolver<gracfl::SolverFWGramParallel>("SolverFWGramParallel", graphfilepath, grammarfilepath);
+        // a team of one thread appends its edges right away instead of staging them
+        result = gracfl::testParallelSolver<gracfl::SolverFWGramParallel>("SolverFWGramParallel", graphfilepath, grammarfilepath)
+              && gracfl::testAgainstReference<gracfl::SolverFWGramParallel>("SolverFWGramParallel (threads=1, vs. SolverBIGram)",
+                                                                                graphfilepath, grammarfilepath, 1u);
     } else if (solverName == "FWTopoParallel") {
-        result = gracfl::testParallelSolver<gracfl::SolverFWTopoParallel>("SolverFWTopoParallel", graphfilepath, grammarfilepath);
-    } else {
+        // a team of one thread appends its edges right away instead of staging them
+        result = gracfl::testParallelSolver<gracfl::SolverFWTopoParallel>("SolverFWTopoParallel", graphfilepath, grammarfilepath)
+              && gracfl::testAgainstReference<gracfl::SolverFWTopoParallel>("SolverFWTopoParallel (threads=1, vs. SolverBIGram)",
+                                                                                graphfilepath, grammarfilepath, 1u);
+    }
+    // Test asynchronous modes
+    else if (solverName == "BIGramAsync") {
+        result = gracfl::testAsyncSolver<gracfl::SolverBIGram>("SolverBIGram", graphfilepath, grammarfilepath);
+    } else if (solverName == "BIGramParallelAsync") {
+        result = gracfl::testAsyncSolver<gracfl::SolverBIGramParallel>("SolverBIGramParallel", graphfilepath, grammarfilepath, 2u, false);
+    }
+    // Test the stratified evaluation
+    else if (solverName == "Stratified") {
+        result = gracfl::testStratifiedSolver(graphfilepath, grammarfilepath);
+    }
+    // Test the SpGEMM solver
+    else if (solverName == "SpGEMM") {
+        result = gracfl::testSpGEMMSolver(graphfilepath, grammarfilepath);
+    }
+    // Test the bit-matrix solver
+    else if (solverName == "BitMatrix") {
+        result = gracfl::testBitMatrixSolver(graphfilepath, grammarfilepath);
+    }
+    // Test the edge-centric streaming solver
+    else if (solverName == "Stream") {
+        result = gracfl::testStreamSolver(graphfilepath, grammarfilepath);
+    }
+    // Test the BDD solver
+    else if (solverName == "Bdd") {
+        result = gracfl::testBddSolver(graphfilepath, grammarfilepath);
+    }
+    // Test the Dyck solver
+    else if (solverName == "Dyck") {
+        result = gracfl::testDyckSolver(graphfilepath, grammarfilepath);
+    } else if (solverName == "DyckIndexed") {
+        result = gracfl::testIndexedDyckSolver(graphfilepath, grammarfilepath);
+    }
+    // Test graph contractions
+    else if (solverName == "SCC") {
+        result = gracfl::testContraction<gracfl::SCCContraction>("SCCContraction", graphfilepath, grammarfilepath);
+    } else if (solverName == "Merge") {
+        result = gracfl::testContraction<gracfl::EquivalenceMerging>("EquivalenceMerging", graphfilepath, grammarfilepath);
+    } else if (solverName == "Cycles") {
+        result = gracfl::testCycleCollapsing(graphfilepath, grammarfilepath);
+    } else if (solverName == "LabelMajor") {
+        result = gracfl::testLabelMajorSweep(graphfilepath, grammarfilepath);
+    } else if (solverName == "Hybrid") {
+        result = gracfl::testHybridSolver(graphfilepath, grammarfilepath);
+    } else if (solverName == "Auto") {
+        result = gracfl::testAutoSelection(graphfilepath, grammarfilepath);
+    } else if (solverName == "Reorder") {
+        result = gracfl::testReordering(graphfilepath, grammarfilepath);
+    }
+#ifdef GRACFL_USE_MPI
+    // Test distributed solvers
+    else if (solverName == "BIGramDistributed") {
+        // small rounds split every exchange and the gather into many messages
+        result = gracfl::testDistributedSolver("SolverBIGramDistributed (vs. SolverBIGram)", graphfilepath, grammarfilepath)
+              && gracfl::testDistributedSolver("SolverBIGramDistributed (64-byte rounds, vs. SolverBIGram)",
+                                               graphfilepath, grammarfilepath, 64);
+    }
+#endif
+    else {
         std::cerr << "Unknown solver: " << solverName << std::endl;
         return 1;
     }
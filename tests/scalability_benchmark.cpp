@@ -0,0 +1,66 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include "solvers/SolverFWGramParallel.hpp"
+#include "solvers/SolverBWGramParallel.hpp"
+#include "solvers/SolverFWTopoParallel.hpp"
+#include "solvers/SolverBWTopoParallel.hpp"
+#include "utils/Grammar.hpp"
+#include "utils/Edges.hpp"
+#include "utils/graphs/Graph.hpp"
+
+namespace gracfl {
+
+/**
+ * @brief Best time of runCFL() over a few runs of a parallel solver, with its output muted
+ */
+template<typename SolverType>
+double timeSolver(std::vector<Edge>& edges, Grammar& grammar, uint numThreads, uint runs) {
+    double best = -1;
+    for (uint r = 0; r < runs; r++) {
+        SolverType solver(edges, grammar, numThreads);
+        std::streambuf* out = std::cout.rdbuf(nullptr);
+        auto start = std::chrono::steady_clock::now();
+        solver.runCFL();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout.rdbuf(out);
+        if (best < 0 || elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+} // namespace gracfl
+
+/**
+ * @brief Times the owner-computes parallel solvers for thread counts 1, 2, 4, ... up to a maximum
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <graph_file_path> <grammar_file_path> [max_threads = 64] [runs = 3]" << std::endl;
+        return 1;
+    }
+
+    std::string graphfilepath = argv[1];
+    gracfl::Grammar grammar(argv[2]);
+    uint maxThreads = argc > 3 ? std::atoi(argv[3]) : 64;
+    uint runs = argc > 4 ? std::atoi(argv[4]) : 3;
+
+    gracfl::Graph input(graphfilepath, grammar);
+    std::vector<gracfl::Edge> edges = input.getEdges();
+    std::cout << "Graph: " << graphfilepath << " (" << edges.size() << " edges), best of " << runs << " runs, seconds" << std::endl;
+    std::cout << "threads\tfw-gram\tbw-gram\tfw-topo\tbw-topo" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (uint t = 1; t <= maxThreads; t *= 2) {
+        std::cout << t
+                  << "\t" << gracfl::timeSolver<gracfl::SolverFWGramParallel>(edges, grammar, t, runs)
+                  << "\t" << gracfl::timeSolver<gracfl::SolverBWGramParallel>(edges, grammar, t, runs)
+                  << "\t" << gracfl::timeSolver<gracfl::SolverFWTopoParallel>(edges, grammar, t, runs)
+                  << "\t" << gracfl::timeSolver<gracfl::SolverBWTopoParallel>(edges, grammar, t, runs)
+                  << std::endl;
+    }
+    return 0;
+}
@@ -30,11 +30,10 @@ std::vector<Edge> loadEdgesFromFile(const std::string& graphfilepath, const Gram
         infile >> newEdge.to;
         infile >> label;
         
-        if (grammar.getSymbolToIDMap().find(label) == grammar.getSymbolToIDMap().end()) {
+        if (!grammar.parseLabel(label, newEdge.label, newEdge.index)) {
             continue;
         }
         
-        newEdge.label = grammar.getSymbolToIDMap().at(label);
         edges.push_back(newEdge);
     }
     infile.close();